@@ -38,9 +38,20 @@
 #include <opm/material/common/Exceptions.hpp>
 #include <opm/material/common/Unused.hpp>
 
+#include <opm/simulators/utils/ParallelRestart.hpp>
+
 #include <dune/grid/common/mcmgmapper.hh>
+#include <dune/common/parallel/mpihelper.hh>
 
+#include <cassert>
+#include <map>
 #include <stdexcept>
+#include <string>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
 
 namespace Opm {
 
@@ -294,6 +305,11 @@ public:
     CollectDataToIORank(const Vanguard& vanguard)
         : toIORankComm_()
     {
+#if HAVE_MPI
+        if (isParallel())
+            MPI_Comm_dup(Dune::MPIHelper::getCommunicator(), &outputComm_);
+#endif
+
         // index maps only have to be build when reordering is needed
         if (!needsReordering && !isParallel())
             return;
@@ -383,6 +399,7 @@ public:
 
             // insert send and recv linkage to communicator
             toIORankComm_.insertRequest(send, recv);
+            recvRanks_.assign(recv.begin(), recv.end());
 
             // need an index map for each rank
             indexMaps_.clear();
@@ -400,254 +417,32 @@ public:
         }
     }
 
-    class PackUnPackCellData : public P2PCommunicatorType::DataHandleInterface
+    ~CollectDataToIORank()
     {
-        const Opm::data::Solution& localCellData_;
-        Opm::data::Solution& globalCellData_;
-
-        const IndexMapType& localIndexMap_;
-        const IndexMapStorageType& indexMaps_;
-
-    public:
-        PackUnPackCellData(const Opm::data::Solution& localCellData,
-                           Opm::data::Solution& globalCellData,
-                           const IndexMapType& localIndexMap,
-                           const IndexMapStorageType& indexMaps,
-                           size_t globalSize,
-                           bool isIORank)
-            : localCellData_(localCellData)
-            , globalCellData_(globalCellData)
-            , localIndexMap_(localIndexMap)
-            , indexMaps_(indexMaps)
-        {
-            if (isIORank) {
-                // add missing data to global cell data
-                for (const auto& pair : localCellData_) {
-                    const std::string& key = pair.first;
-                    std::size_t containerSize = globalSize;
-                    auto OPM_OPTIM_UNUSED ret = globalCellData_.insert(key, pair.second.dim,
-                                                                       std::vector<double>(containerSize),
-                                                                       pair.second.target);
-                    assert(ret.second);
-                }
-
-                MessageBufferType buffer;
-                pack(0, buffer);
-
-                // the last index map is the local one
-                doUnpack(indexMaps.back(), buffer);
-            }
-        }
-
-        // pack all data associated with link
-        void pack(int link, MessageBufferType& buffer)
-        {
-            // we should only get one link
-            if (link != 0)
-                throw std::logic_error("link in method pack is not 0 as expected");
-
-            // write all cell data registered in local state
-            for (const auto& pair : localCellData_) {
-                const auto& data = pair.second.data;
-
-                // write all data from local data to buffer
-                write(buffer, localIndexMap_, data);
-            }
-        }
-
-        void doUnpack(const IndexMapType& indexMap, MessageBufferType& buffer)
-        {
-            // we loop over the data as
-            // its order governs the order the data got received.
-            for (auto& pair : localCellData_) {
-                const std::string& key = pair.first;
-                auto& data = globalCellData_.data(key);
-
-                //write all data from local cell data to buffer
-                read(buffer, indexMap, data);
-            }
-        }
-
-        // unpack all data associated with link
-        void unpack(int link, MessageBufferType& buffer)
-        { doUnpack(indexMaps_[link], buffer); }
-
-    protected:
-        template <class Vector>
-        void write(MessageBufferType& buffer,
-                   const IndexMapType& localIndexMap,
-                   const Vector& vector,
-                   unsigned int offset = 0,
-                   unsigned int stride = 1) const
-        {
-            unsigned int size = localIndexMap.size();
-            buffer.write(size);
-            assert(vector.size() >= stride * size);
-            for (unsigned int i=0; i<size; ++i)
-            {
-                unsigned int index = localIndexMap[i] * stride + offset;
-                assert(index < vector.size());
-                buffer.write(vector[index]);
-            }
-        }
-
-        template <class Vector>
-        void read(MessageBufferType& buffer,
-                  const IndexMapType& indexMap,
-                  Vector& vector,
-                  unsigned int offset = 0,
-                  unsigned int stride = 1) const
-        {
-            unsigned int size = 0;
-            buffer.read(size);
-            assert(size == indexMap.size());
-            for (unsigned int i=0; i<size; ++i) {
-                unsigned int index = indexMap[i] * stride + offset;
-                assert(index < vector.size());
-                buffer.read(vector[index]);
-            }
-        }
-    };
-
-    class PackUnPackWellData : public P2PCommunicatorType::DataHandleInterface
-    {
-        const Opm::data::Wells& localWellData_;
-        Opm::data::Wells& globalWellData_;
-
-    public:
-        PackUnPackWellData(const Opm::data::Wells& localWellData,
-                           Opm::data::Wells& globalWellData,
-                           bool isIORank)
-            : localWellData_(localWellData)
-            , globalWellData_(globalWellData)
-        {
-            if (isIORank) {
-                MessageBufferType buffer;
-                pack(0, buffer);
-
-                // pass a dummy_link to satisfy virtual class
-                int dummyLink = -1;
-                unpack(dummyLink, buffer);
-            }
-        }
-
-        // pack all data associated with link
-        void pack(int link, MessageBufferType& buffer)
-        {
-            // we should only get one link
-            if (link != 0)
-                throw std::logic_error("link in method pack is not 0 as expected");
-
-            localWellData_.write(buffer);
-        }
-
-        // unpack all data associated with link
-        void unpack(int /*link*/, MessageBufferType& buffer)
-        { globalWellData_.read(buffer); }
-
-    };
-
-    class PackUnPackGroupData : public P2PCommunicatorType::DataHandleInterface
-    {
-        const Opm::data::GroupValues& localGroupData_;
-        Opm::data::GroupValues&       globalGroupData_;
-
-    public:
-        PackUnPackGroupData(const Opm::data::GroupValues& localGroupData,
-                            Opm::data::GroupValues&       globalGroupData,
-                            const bool                    isIORank)
-            : localGroupData_ (localGroupData)
-            , globalGroupData_(globalGroupData)
-        {
-            if (! isIORank) { return; }
-
-            MessageBufferType buffer;
-            this->pack(0, buffer);
-
-            // pass a dummy_link to satisfy virtual class
-            const int dummyLink = -1;
-            this->unpack(dummyLink, buffer);
-        }
-
-        // pack all data associated with link
-        void pack(int link, MessageBufferType& buffer)
-        {
-            // we should only get one link
-            if (link != 0) {
-                throw std::logic_error {
-                    "link in method pack is not 0 as expected"
-                };
-            }
-
-            // write all group data
-           this->localGroupData_.write(buffer);
-        }
-
-        // unpack all data associated with link
-        void unpack(int /*link*/, MessageBufferType& buffer)
-        { this->globalGroupData_.read(buffer); }
-    };
-
-
-    class PackUnPackBlockData : public P2PCommunicatorType::DataHandleInterface
-    {
-        const std::map<std::pair<std::string, int>, double>& localBlockData_;
-        std::map<std::pair<std::string, int>, double>& globalBlockValues_;
-
-    public:
-        PackUnPackBlockData(const std::map<std::pair<std::string, int>, double>& localBlockData,
-                            std::map<std::pair<std::string, int>, double>& globalBlockValues,
-                            bool isIORank)
-            : localBlockData_(localBlockData)
-            , globalBlockValues_(globalBlockValues)
-        {
-            if (isIORank) {
-                MessageBufferType buffer;
-                pack(0, buffer);
-
-                // pass a dummyLink to satisfy virtual class
-                int dummyLink = -1;
-                unpack(dummyLink, buffer);
-            }
-        }
-
-        // pack all data associated with link
-        void pack(int link, MessageBufferType& buffer)
-        {
-            // we should only get one link
-            if (link != 0)
-                throw std::logic_error("link in method pack is not 0 as expected");
-
-            // write all block data
-            unsigned int size = localBlockData_.size();
-            buffer.write(size);
-            for (const auto& map : localBlockData_) {
-                buffer.write(map.first.first);
-                buffer.write(map.first.second);
-                buffer.write(map.second);
-            }
-        }
-
-        // unpack all data associated with link
-        void unpack(int /*link*/, MessageBufferType& buffer)
-        {
-            // read all block data
-            unsigned int size = 0;
-            buffer.read(size);
-            for (size_t i = 0; i < size; ++i) {
-                std::string name;
-                int idx;
-                double data;
-                buffer.read(name);
-                buffer.read(idx);
-                buffer.read(data);
-                globalBlockValues_[std::make_pair(name, idx)] = data;
-            }
-        }
+#if HAVE_MPI
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (finalized)
+            return;
 
-    };
+        waitForPendingSend_();
+        if (outputComm_ != MPI_COMM_NULL)
+            MPI_Comm_free(&outputComm_);
+#endif
+    }
 
-    // gather solution to rank 0 for EclipseWriter
+    CollectDataToIORank(const CollectDataToIORank&) = delete;
+    CollectDataToIORank& operator=(const CollectDataToIORank&) = delete;
+
+    /*!
+     * \brief Gather the solution to the I/O rank for the EclipseWriter.
+     *
+     * All data of a rank is packed into a single message and the cell data is
+     * written to it as one contiguous block of values. The ranks which are not
+     * the I/O rank only post a non-blocking send and return immediately, the
+     * completion of this send is checked before the next call to collect().
+     * The I/O rank waits for the data of all ranks before it returns.
+     */
     void collect(const Opm::data::Solution& localCellData,
                  const std::map<std::pair<std::string, int>, double>& localBlockData,
                  const Opm::data::Wells& localWellData,
@@ -662,50 +457,54 @@ public:
         if(!needsReordering && !isParallel())
             return;
 
-
-        // this also linearises the local buffers on ioRank
-        PackUnPackCellData packUnpackCellData {
-            localCellData,
-            this->globalCellData_,
-            this->localIndexMap_,
-            this->indexMaps_,
-            this->numCells(),
-            this->isIORank()
-        };
+        if (isIORank()) {
+            // linearise the local buffers on ioRank, the last index map is the local one
+            for (const auto& pair : localCellData) {
+                auto OPM_OPTIM_UNUSED ret = globalCellData_.insert(pair.first, pair.second.dim,
+                                                                   std::vector<double>(numCells()),
+                                                                   pair.second.target);
+                assert(ret.second);
+
+                const auto& localData = pair.second.data;
+                auto& globalData = globalCellData_.data(pair.first);
+                const IndexMapType& indexMap = indexMaps_.back();
+                for (std::size_t i = 0; i < localIndexMap_.size(); ++i)
+                    globalData[indexMap[i]] = localData[localIndexMap_[i]];
+            }
+        }
 
         if (! isParallel()) {
             // no need to collect anything.
             return;
         }
 
-        PackUnPackWellData packUnpackWellData {
-            localWellData,
-            this->globalWellData_,
-            this->isIORank()
-        };
-
-        PackUnPackGroupData packUnpackGroupData {
-            localGroupData,
-            this->globalGroupData_,
-            this->isIORank()
-        };
-
-        PackUnPackBlockData packUnpackBlockData {
-            localBlockData,
-            this->globalBlockData_,
-            this->isIORank()
-        };
-
-        toIORankComm_.exchange(packUnpackCellData);
-        toIORankComm_.exchange(packUnpackWellData);
-        toIORankComm_.exchange(packUnpackGroupData);
-        toIORankComm_.exchange(packUnpackBlockData);
-
-
+#if HAVE_MPI
+        if (isIORank()) {
+            globalWellData_.insert(localWellData.begin(), localWellData.end());
+            globalGroupData_.insert(localGroupData.begin(), localGroupData.end());
+            globalBlockData_ = localBlockData;
+
+            // receive in the order of the ranks to keep the result deterministic
+            for (std::size_t link = 0; link < recvRanks_.size(); ++link) {
+                MPI_Status status;
+                MPI_Probe(recvRanks_[link], collectTag_, outputComm_, &status);
+                int messageSize = 0;
+                MPI_Get_count(&status, MPI_PACKED, &messageSize);
+                messageBuffer_.resize(messageSize);
+                MPI_Recv(messageBuffer_.data(), messageSize, MPI_PACKED, recvRanks_[link],
+                         collectTag_, outputComm_, MPI_STATUS_IGNORE);
+
+                unpackMessage_(localCellData, indexMaps_[link]);
+            }
+        }
+        else {
+            // the buffer of the previous send is about to be overwritten
+            waitForPendingSend_();
 
-#ifndef NDEBUG
-        // mkae sure every process is on the same page
-        toIORankComm_.barrier();
+            packMessage_(localCellData, localBlockData, localWellData, localGroupData);
+            MPI_Isend(messageBuffer_.data(), static_cast<int>(messageBuffer_.size()), MPI_PACKED, ioRank,
+                      collectTag_, outputComm_, &sendRequest_);
+        }
 #endif
     }
 
@@ -759,11 +558,90 @@ public:
     }
 
 protected:
+#if HAVE_MPI
+    void waitForPendingSend_()
+    {
+        if (sendRequest_ != MPI_REQUEST_NULL)
+            MPI_Wait(&sendRequest_, MPI_STATUS_IGNORE);
+    }
+
+    void packMessage_(const Opm::data::Solution& localCellData,
+                      const std::map<std::pair<std::string, int>, double>& localBlockData,
+                      const Opm::data::Wells& localWellData,
+                      const Opm::data::GroupValues& localGroupData)
+    {
+        // all cell fields end up in one contiguous block, ordered by field
+        const std::size_t numLocalCells = localIndexMap_.size();
+        cellValues_.resize(localCellData.size() * numLocalCells);
+        auto valueIt = cellValues_.begin();
+        for (const auto& pair : localCellData) {
+            const auto& data = pair.second.data;
+            for (std::size_t i = 0; i < numLocalCells; ++i, ++valueIt) {
+                assert(static_cast<std::size_t>(localIndexMap_[i]) < data.size());
+                *valueIt = data[localIndexMap_[i]];
+            }
+        }
+
+        const std::size_t size = Opm::Mpi::packSize(cellValues_, outputComm_)
+            + Opm::Mpi::packSize(localWellData, outputComm_)
+            + Opm::Mpi::packSize(localGroupData, outputComm_)
+            + Opm::Mpi::packSize(localBlockData, outputComm_);
+        messageBuffer_.resize(size);
+
+        int position = 0;
+        Opm::Mpi::pack(cellValues_, messageBuffer_, position, outputComm_);
+        Opm::Mpi::pack(localWellData, messageBuffer_, position, outputComm_);
+        Opm::Mpi::pack(localGroupData, messageBuffer_, position, outputComm_);
+        Opm::Mpi::pack(localBlockData, messageBuffer_, position, outputComm_);
+        messageBuffer_.resize(position);
+    }
+
+    void unpackMessage_(const Opm::data::Solution& localCellData,
+                        const IndexMapType& indexMap)
+    {
+        int position = 0;
+        Opm::Mpi::unpack(cellValues_, messageBuffer_, position, outputComm_);
+        if (cellValues_.size() != localCellData.size() * indexMap.size())
+            throw std::logic_error("size of the received cell data does not match the index map");
+
+        // the fields are ordered the same on all ranks
+        auto valueIt = cellValues_.cbegin();
+        for (const auto& pair : localCellData) {
+            auto& data = globalCellData_.data(pair.first);
+            for (std::size_t i = 0; i < indexMap.size(); ++i, ++valueIt) {
+                assert(static_cast<std::size_t>(indexMap[i]) < data.size());
+                data[indexMap[i]] = *valueIt;
+            }
+        }
+
+        Opm::data::Wells wellData;
+        Opm::data::GroupValues groupData;
+        std::map<std::pair<std::string, int>, double> blockData;
+        Opm::Mpi::unpack(wellData, messageBuffer_, position, outputComm_);
+        Opm::Mpi::unpack(groupData, messageBuffer_, position, outputComm_);
+        Opm::Mpi::unpack(blockData, messageBuffer_, position, outputComm_);
+
+        globalWellData_.insert(wellData.begin(), wellData.end());
+        globalGroupData_.insert(groupData.begin(), groupData.end());
+        for (const auto& block : blockData)
+            globalBlockData_[block.first] = block.second;
+    }
+
+    // the output data is sent on a communicator of its own, such that the pending
+    // sends can not interfere with any other communication
+    static constexpr int collectTag_ = 0;
+    MPI_Comm outputComm_ = MPI_COMM_NULL;
+    MPI_Request sendRequest_ = MPI_REQUEST_NULL;
+    std::vector<char> messageBuffer_;
+    std::vector<double> cellValues_;
+#endif
+
     P2PCommunicatorType toIORankComm_;
     IndexMapType globalCartesianIndex_;
     IndexMapType localIndexMap_;
     IndexMapStorageType indexMaps_;
     std::vector<int> globalRanks_;
+    std::vector<int> recvRanks_;
     Opm::data::Solution globalCellData_;
     std::map<std::pair<std::string, int>, double> globalBlockData_;
     Opm::data::Wells globalWellData_;
@@ -95,6 +95,10 @@ struct SchedRestart {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct EclStartupCacheDir {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct EclOutputInterval {
     using type = UndefinedProperty;
 };
@@ -136,6 +140,10 @@ struct SchedRestart<TypeTag, TTag::EclBaseVanguard> {
     static constexpr bool value = false;
 };
 template<class TypeTag>
+struct EclStartupCacheDir<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
 struct EdgeWeightsMethod<TypeTag, TTag::EclBaseVanguard> {
     static constexpr int value = 1;
 };
@@ -188,6 +196,8 @@ public:
                              "Use strict mode for parsing - all errors are collected before the applicaton exists.");
         EWOMS_REGISTER_PARAM(TypeTag, bool, SchedRestart,
                              "When restarting: should we try to initialize wells and groups from historical SCHEDULE section.");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, EclStartupCacheDir,
+                             "Directory of the startup snapshots which allow to skip parsing an unchanged deck. Empty to disable them.");
         EWOMS_REGISTER_PARAM(TypeTag, int, EdgeWeightsMethod,
                              "Choose edge-weighing strategy: 0=uniform, 1=trans, 2=log(trans).");
         EWOMS_REGISTER_PARAM(TypeTag, bool, OwnerCellsFirst,
@@ -273,8 +283,8 @@ public:
     /*!
      * \brief Returns the wall time required to set up the simulator before it was born.
      */
-    static Scalar externalSetupTime()
-    { return externalSetupTime_; }
+    Scalar externalSetupTime() const
+    { return setupTime_; }
 
     /*!
      * \brief Set the Opm::ParseContext object which ought to be used for parsing the deck and creating the Opm::EclipseState object.
@@ -315,6 +325,7 @@ public:
      */
     EclBaseVanguard(Simulator& simulator)
         : ParentType(simulator)
+        , setupTime_(externalSetupTime_)
     {
         int myRank = 0;
 #if HAVE_MPI
@@ -393,7 +404,8 @@ public:
         readDeck(myRank, fileName, deck_, eclState_, eclSchedule_,
                  eclSummaryConfig_, std::move(errorGuard), python,
                  std::move(parseContext_), /* initFromRestart = */ false,
-                 /* checkDeck = */ enableExperiments);
+                 /* checkDeck = */ enableExperiments,
+                 EWOMS_GET_PARAM(TypeTag, std::string, EclStartupCacheDir));
 
         this->summaryState_ = std::make_unique<Opm::SummaryState>( std::chrono::system_clock::from_time_t(this->eclSchedule_->getStartTime() ));
         this->udqState_.reset( new Opm::UDQState( this->eclSchedule_->getUDQConfig(0).params().undefinedValue()) );
@@ -650,6 +662,7 @@ private:
     { return *static_cast<const Implementation*>(this); }
 
     std::string caseName_;
+    Scalar setupTime_;
 
     static Scalar externalSetupTime_;
 
@@ -22,7 +22,15 @@
 #define ECL_MPI_SERIALIZER_HH
 
 #include <opm/simulators/utils/ParallelRestart.hpp>
+
+#include <algorithm>
 #include <variant>
+#include <vector>
+
+#if HAVE_MPI
+#include <dune/common/parallel/mpitraits.hh>
+#include <mpi.h>
+#endif
 
 namespace Opm {
 
@@ -35,8 +43,11 @@ class EclMpiSerializer {
 public:
     //! \brief Constructor.
     //! \param comm The global communicator to broadcast using
-    explicit EclMpiSerializer(Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm) :
-        m_comm(comm)
+    //! \param compress True to run-length encode large int and double arrays
+    explicit EclMpiSerializer(Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm,
+                              bool compress = false) :
+        m_comm(comm),
+        m_compress(compress)
     {}
 
     //! \brief (De-)serialization for simple types.
@@ -51,12 +62,12 @@ public:
             pair(data);
         } else if constexpr (is_variant<T>::value) {
             variant(data);
+        } else if constexpr (is_array_vector<T>::value) {
+            arrayVector(const_cast<T&>(data));
         } else {
-          if (m_op == Operation::PACKSIZE)
-              m_packSize += Mpi::packSize(data, m_comm);
-          else if (m_op == Operation::PACK)
-              Mpi::pack(data, m_buffer, m_position, m_comm);
-          else if (m_op == Operation::UNPACK)
+          if (m_op == Operation::PACK)
+              packItem(data);
+          else
               Mpi::unpack(const_cast<T&>(data), m_buffer, m_position, m_comm);
         }
     }
@@ -68,6 +79,12 @@ public:
     template<class T, bool complexType = true>
     void vector(std::vector<T>& data)
     {
+        // arrays of plain numbers are handled as a whole
+        if constexpr (!complexType && is_array_vector<std::vector<T>>::value) {
+            arrayVector(data);
+            return;
+        }
+
         auto handle = [&](auto& d)
         {
             for (auto& it : d) {
@@ -82,13 +99,10 @@ public:
             }
         };
 
-        if (m_op == Operation::PACKSIZE) {
-            m_packSize += Mpi::packSize(data.size(), m_comm);
+        if (m_op == Operation::PACK) {
+            packItem(data.size());
             handle(data);
-        } else if (m_op == Operation::PACK) {
-            Mpi::pack(data.size(), m_buffer, m_position, m_comm);
-            handle(data);
-        } else if (m_op == Operation::UNPACK) {
+        } else {
             size_t size;
             Mpi::unpack(size, m_buffer, m_position, m_comm);
             data.resize(size);
@@ -119,13 +133,10 @@ public:
         };
 
         std::variant<T0,T1,T2,T3>& data = const_cast<std::variant<T0,T1,T2,T3>&>(_data);
-        if (m_op == Operation::PACKSIZE) {
-            m_packSize += Mpi::packSize(data.index(), m_comm);
-            std::visit( [&] (auto& arg) { handle(arg); }, data);
-        } else if (m_op == Operation::PACK) {
-            Mpi::pack(data.index(), m_buffer, m_position, m_comm);
+        if (m_op == Operation::PACK) {
+            packItem(data.index());
             std::visit([&](auto& arg) { handle(arg); }, data);
-        } else if (m_op == Operation::UNPACK) {
+        } else {
             size_t index;
             Mpi::unpack(index, m_buffer, m_position, m_comm);
 
@@ -161,21 +172,10 @@ public:
     template<class T0, class T1>
     void variant(const std::variant<T0,T1>& data)
     {
-        auto pack_size = [&](auto& d) {
-                             m_packSize += Mpi::packSize(d, m_comm);
-                         };
-
-        auto pack = [&](auto& d) {
-                          Mpi::pack(d, m_buffer, m_position, m_comm);
-                      };
-
-        if (m_op == Operation::PACKSIZE) {
-            m_packSize += Mpi::packSize(data.index(), m_comm);
-            std::visit( [&] (auto& arg) { pack_size(arg); }, data);
-        } else if (m_op == Operation::PACK) {
-            Mpi::pack(data.index(), m_buffer, m_position, m_comm);
-            std::visit([&](auto& arg) { pack(arg); }, data);
-        } else if (m_op == Operation::UNPACK) {
+        if (m_op == Operation::PACK) {
+            packItem(data.index());
+            std::visit([&](auto& arg) { packItem(arg); }, data);
+        } else {
             size_t index;
             std::variant<T0,T1>& mutable_data = const_cast<std::variant<T0,T1>&>(data);
             Mpi::unpack(index, m_buffer, m_position, m_comm);
@@ -218,19 +218,13 @@ public:
                 (*this)(d);
         };
 
-        if (m_op == Operation::PACKSIZE) {
-            m_packSize += Mpi::packSize(data.size(), m_comm);
+        if (m_op == Operation::PACK) {
+            packItem(data.size());
             for (auto& it : data) {
-                m_packSize += Mpi::packSize(it.first, m_comm);
+                packItem(it.first);
                 handle(it.second);
             }
-        } else if (m_op == Operation::PACK) {
-            Mpi::pack(data.size(), m_buffer, m_position, m_comm);
-            for (auto& it : data) {
-                Mpi::pack(it.first, m_buffer, m_position, m_comm);
-                handle(it.second);
-            }
-        } else if (m_op == Operation::UNPACK) {
+        } else {
             size_t size;
             Mpi::unpack(size, m_buffer, m_position, m_comm);
             for (size_t i = 0; i < size; ++i) {
@@ -246,16 +240,15 @@ public:
     //! \brief Call this to serialize data.
     //! \tparam T Type of class to serialize
     //! \param data Class to serialize
+    //! \details The buffer grows while the data is packed, so the data is only
+    //!          traversed once.
     template<class T>
     void pack(T& data)
     {
-        m_op = Operation::PACKSIZE;
-        m_packSize = 0;
-        data.serializeOp(*this);
-        m_position = 0;
-        m_buffer.resize(m_packSize);
         m_op = Operation::PACK;
+        m_position = 0;
         data.serializeOp(*this);
+        m_packSize = m_position;
     }
 
     //! \brief Call this to de-serialize data.
@@ -270,25 +263,54 @@ public:
     }
 
     //! \brief Serialize and broadcast on root process, de-serialize on others.
-    //! \tparam T Type of class to broadcast
-    //! \param data Class to broadcast
-    template<class T>
-    void broadcast(T& data)
+    //! \details Several objects are broadcast in a pipeline: the root process
+    //!          packs the next object while the previous one is still being
+    //!          transferred and unpacked by the other processes. Every object is
+    //!          sent as its size followed by chunks of at most maxChunkSize bytes.
+    //! \tparam T Types of classes to broadcast
+    //! \param data Classes to broadcast
+    template<class... T>
+    void broadcast(T&... data)
     {
         if (m_comm.size() == 1)
             return;
 
+#if HAVE_MPI
+        std::vector<MPI_Request> requests;
         if (m_comm.rank() == 0) {
-            pack(data);
-            m_packSize = m_position;
-            m_comm.broadcast(&m_packSize, 1, 0);
-            m_comm.broadcast(m_buffer.data(), m_position, 0);
+            // the buffers have to stay alive until all transfers are complete
+            std::vector<std::vector<char>> buffers;
+            std::vector<std::size_t> sizes(sizeof...(T));
+            std::size_t idx = 0;
+            auto send = [&](auto& d)
+            {
+                pack(d);
+                sizes[idx] = m_packSize;
+                m_buffer.resize(m_packSize);
+                buffers.push_back(std::move(m_buffer));
+                m_buffer.clear();
+                postBroadcast(sizes[idx], buffers.back(), requests);
+                ++idx;
+            };
+            (send(data), ...);
+            MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
         } else {
-            m_comm.broadcast(&m_packSize, 1, 0);
-            m_buffer.resize(m_packSize);
-            m_comm.broadcast(m_buffer.data(), m_packSize, 0);
-            unpack(data);
+            auto receive = [&](auto& d)
+            {
+                std::size_t size = 0;
+                MPI_Request request;
+                MPI_Ibcast(&size, 1, Dune::MPITraits<std::size_t>::getType(), 0, m_comm, &request);
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+                m_buffer.resize(size);
+                requests.clear();
+                postChunks(m_buffer, requests);
+                MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+                unpack(d);
+            };
+            (receive(data), ...);
         }
+#endif
     }
 
     //! \brief Returns current position in buffer.
@@ -297,6 +319,20 @@ public:
         return m_position;
     }
 
+    //! \brief Returns the buffer holding the serialized data.
+    //! \details After pack() the data is stored in the first position() bytes,
+    //!          unpack() reads the data from the start of the buffer.
+    std::vector<char>& buffer()
+    {
+        return m_buffer;
+    }
+
+    //! \brief Returns true if large int and double arrays are run-length encoded.
+    bool compress() const
+    {
+        return m_compress;
+    }
+
     //! \brief Returns true if we are currently doing a serialization operation.
     bool isSerializing() const
     {
@@ -306,11 +342,16 @@ public:
 protected:
     //! \brief Enumeration of operations.
     enum class Operation {
-        PACKSIZE, //!< Calculating serialization buffer size
         PACK,     //!< Performing serialization
         UNPACK    //!< Performing de-serialization
     };
 
+    //! \brief Largest number of bytes sent by a single broadcast.
+    static constexpr std::size_t maxChunkSize = std::size_t(1) << 26;
+
+    //! \brief Arrays with fewer elements are never run-length encoded.
+    static constexpr std::size_t minEncodedSize = 256;
+
     //! \brief Predicate for detecting pairs.
     template<class T>
     struct is_pair {
@@ -333,6 +374,17 @@ protected:
         constexpr static bool value = true;
     };
 
+    //! \brief Predicate for vectors of plain numbers which are packed as a whole.
+    template<class T>
+    struct is_array_vector {
+        constexpr static bool value = false;
+    };
+
+    template<class T1>
+    struct is_array_vector<std::vector<T1>> {
+        constexpr static bool value = std::is_same<T1,int>::value || std::is_same<T1,double>::value;
+    };
+
     //! \brief Predicate for detecting variants.
     template<class T>
     struct is_variant {
@@ -404,10 +456,95 @@ protected:
             data->serializeOp(*this);
     }
 
+    //! \brief Pack an item, growing the buffer if needed.
+    template<class T>
+    void packItem(const T& data)
+    {
+        const std::size_t required = m_position + Mpi::packSize(data, m_comm);
+        if (required > m_buffer.size())
+            m_buffer.resize(std::max(required, 2 * m_buffer.size()));
+
+        Mpi::pack(data, m_buffer, m_position, m_comm);
+    }
+
+    //! \brief Handler for vectors of plain numbers.
+    //! \details If compression is enabled, large arrays consisting of long runs of
+    //!          equal values are stored as the values and lengths of the runs.
+    template<class T>
+    void arrayVector(std::vector<T>& data)
+    {
+        if (m_op == Operation::PACK) {
+            std::size_t numRuns = 0;
+            if (m_compress && data.size() >= minEncodedSize) {
+                numRuns = 1;
+                for (std::size_t i = 1; i < data.size(); ++i)
+                    numRuns += data[i] != data[i - 1];
+            }
+
+            // a run costs the value and its length
+            const bool encode = numRuns > 0 && 2 * numRuns * sizeof(std::size_t) < data.size() * sizeof(T);
+            packItem(encode);
+            if (!encode) {
+                packItem(data);
+                return;
+            }
+
+            std::vector<T> values;
+            std::vector<std::size_t> lengths;
+            values.reserve(numRuns);
+            lengths.reserve(numRuns);
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                if (i == 0 || data[i] != data[i - 1]) {
+                    values.push_back(data[i]);
+                    lengths.push_back(0);
+                }
+                ++lengths.back();
+            }
+            packItem(values);
+            packItem(lengths);
+        } else {
+            bool encoded;
+            Mpi::unpack(encoded, m_buffer, m_position, m_comm);
+            if (!encoded) {
+                Mpi::unpack(data, m_buffer, m_position, m_comm);
+                return;
+            }
+
+            std::vector<T> values;
+            std::vector<std::size_t> lengths;
+            Mpi::unpack(values, m_buffer, m_position, m_comm);
+            Mpi::unpack(lengths, m_buffer, m_position, m_comm);
+            data.clear();
+            for (std::size_t i = 0; i < values.size(); ++i)
+                data.insert(data.end(), lengths[i], values[i]);
+        }
+    }
+
+#if HAVE_MPI
+    //! \brief Post the non-blocking broadcasts of a buffer in chunks.
+    void postChunks(std::vector<char>& buffer, std::vector<MPI_Request>& requests)
+    {
+        for (std::size_t offset = 0; offset < buffer.size(); offset += maxChunkSize) {
+            const std::size_t chunk = std::min(maxChunkSize, buffer.size() - offset);
+            requests.emplace_back();
+            MPI_Ibcast(buffer.data() + offset, static_cast<int>(chunk), MPI_CHAR, 0, m_comm, &requests.back());
+        }
+    }
+
+    //! \brief Post the non-blocking broadcasts of the size and the contents of a buffer.
+    void postBroadcast(std::size_t& size, std::vector<char>& buffer, std::vector<MPI_Request>& requests)
+    {
+        requests.emplace_back();
+        MPI_Ibcast(&size, 1, Dune::MPITraits<std::size_t>::getType(), 0, m_comm, &requests.back());
+        postChunks(buffer, requests);
+    }
+#endif
+
     Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> m_comm; //!< Communicator to broadcast using
+    bool m_compress = false; //!< True to run-length encode large arrays
 
-    Operation m_op = Operation::PACKSIZE; //!< Current operation
-    size_t m_packSize = 0; //!< Required buffer size after PACKSIZE has been done
+    Operation m_op = Operation::PACK; //!< Current operation
+    size_t m_packSize = 0; //!< Size of the packed data after pack() has been done
     int m_position = 0; //!< Current position in buffer
     std::vector<char> m_buffer; //!< Buffer for serialized data
 };
@@ -42,6 +42,7 @@
 
 #include <dune/common/fvector.hh>
 
+#include <mutex>
 #include <type_traits>
 
 namespace Opm::Properties {
@@ -83,6 +84,7 @@ class EclOutputBlackOilModule
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
     using MaterialLaw = GetPropType<TypeTag, Properties::MaterialLaw>;
     using MaterialLawParams = GetPropType<TypeTag, Properties::MaterialLawParams>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
@@ -189,7 +191,7 @@ public:
         createLocalFipnum_();
 
         // Summary output is for all steps
-        const Opm::SummaryConfig summaryConfig = simulator_.vanguard().summaryConfig();
+        const Opm::SummaryConfig& summaryConfig = simulator_.vanguard().summaryConfig();
 
         // Initialize block output
         for (const auto& node: summaryConfig) {
@@ -223,22 +225,27 @@ public:
             return;
 
         // Summary output is for all steps
-        const Opm::SummaryConfig summaryConfig = simulator_.vanguard().summaryConfig();
+        const Opm::SummaryConfig& summaryConfig = simulator_.vanguard().summaryConfig();
 
-        // Only output RESTART_AUXILIARY asked for by the user.
+        // Only output RESTART_AUXILIARY asked for by the user.  The requested
+        // keywords only change between report steps, so they are cached.
         const Opm::RestartConfig& restartConfig = simulator_.vanguard().schedule().restart();
-        std::map<std::string, int> rstKeywords = restartConfig.getRestartKeywords(reportStepNum);
-        for (auto& [keyword, should_write] : rstKeywords) {
-            if (this->isOutputCreationDirective_(keyword)) {
-                // 'BASIC', 'FREQ' and similar.  Don't attempt to create
-                // cell-based output for these keywords and don't warn about
-                // not being able to create such cell-based result vectors.
-                should_write = 0;
-            }
-            else {
-                should_write = restartConfig.getKeyword(keyword, reportStepNum);
+        if (static_cast<int>(reportStepNum) != rstKeywordsReportStep_) {
+            rstKeywordsCache_ = restartConfig.getRestartKeywords(reportStepNum);
+            for (auto& [keyword, should_write] : rstKeywordsCache_) {
+                if (this->isOutputCreationDirective_(keyword)) {
+                    // 'BASIC', 'FREQ' and similar.  Don't attempt to create
+                    // cell-based output for these keywords and don't warn about
+                    // not being able to create such cell-based result vectors.
+                    should_write = 0;
+                }
+                else {
+                    should_write = restartConfig.getKeyword(keyword, reportStepNum);
+                }
             }
+            rstKeywordsReportStep_ = reportStepNum;
         }
+        std::map<std::string, int> rstKeywords = rstKeywordsCache_;
 
         outputFipRestart_ = false;
         computeFip_ = false;
@@ -250,17 +257,17 @@ public:
                     rstKeywords["FIP"] = 0;
                     outputFipRestart_ = true;
                 }
-                fip_[i].resize(bufferSize, 0.0);
+                allocBuffer_(fip_[i], bufferSize);
                 computeFip_ = true;
             }
             else
                 fip_[i].clear();
         }
         if (!substep || summaryConfig.hasKeyword("FPR") || summaryConfig.hasKeyword("FPRP") || summaryConfig.hasKeyword("RPR")) {
-            fip_[FipDataType::PoreVolume].resize(bufferSize, 0.0);
-            hydrocarbonPoreVolume_.resize(bufferSize, 0.0);
-            pressureTimesPoreVolume_.resize(bufferSize, 0.0);
-            pressureTimesHydrocarbonVolume_.resize(bufferSize, 0.0);
+            allocBuffer_(fip_[FipDataType::PoreVolume], bufferSize);
+            allocBuffer_(hydrocarbonPoreVolume_, bufferSize);
+            allocBuffer_(pressureTimesPoreVolume_, bufferSize);
+            allocBuffer_(pressureTimesHydrocarbonVolume_, bufferSize);
         }
         else {
             hydrocarbonPoreVolume_.clear();
@@ -297,7 +304,7 @@ public:
         }
 
         // always allocate memory for temperature
-        temperature_.resize(bufferSize, 0.0);
+        allocBuffer_(temperature_, bufferSize);
 
         // field data should be allocated
         // 1) when we want to restart
@@ -311,10 +318,10 @@ public:
             if (!FluidSystem::phaseIsActive(phaseIdx))
                 continue;
 
-            saturation_[phaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(saturation_[phaseIdx], bufferSize);
         }
         // and oil pressure
-        oilPressure_.resize(bufferSize, 0.0);
+        allocBuffer_(oilPressure_, bufferSize);
         rstKeywords["PRES"] = 0;
         rstKeywords["PRESSURE"] = 0;
 
@@ -326,58 +333,58 @@ public:
             rstKeywords["SWAT"] = 0;
 
         if (FluidSystem::enableDissolvedGas()) {
-            rs_.resize(bufferSize, 0.0);
+            allocBuffer_(rs_, bufferSize);
             rstKeywords["RS"] = 0;
         }
         if (FluidSystem::enableVaporizedOil()) {
-            rv_.resize(bufferSize, 0.0);
+            allocBuffer_(rv_, bufferSize);
             rstKeywords["RV"] = 0;
         }
 
         if (getPropValue<TypeTag, Properties::EnableSolvent>())
-            sSol_.resize(bufferSize, 0.0);
+            allocBuffer_(sSol_, bufferSize);
         if (getPropValue<TypeTag, Properties::EnablePolymer>())
-            cPolymer_.resize(bufferSize, 0.0);
+            allocBuffer_(cPolymer_, bufferSize);
         if (getPropValue<TypeTag, Properties::EnableFoam>())
-            cFoam_.resize(bufferSize, 0.0);
+            allocBuffer_(cFoam_, bufferSize);
         if (getPropValue<TypeTag, Properties::EnableBrine>())
-            cSalt_.resize(bufferSize, 0.0);
+            allocBuffer_(cSalt_, bufferSize);
 
         if (simulator_.problem().vapparsActive())
-            soMax_.resize(bufferSize, 0.0);
+            allocBuffer_(soMax_, bufferSize);
 
         if (simulator_.problem().materialLawManager()->enableHysteresis()) {
-            pcSwMdcOw_.resize(bufferSize, 0.0);
-            krnSwMdcOw_.resize(bufferSize, 0.0);
-            pcSwMdcGo_.resize(bufferSize, 0.0);
-            krnSwMdcGo_.resize(bufferSize, 0.0);
+            allocBuffer_(pcSwMdcOw_, bufferSize);
+            allocBuffer_(krnSwMdcOw_, bufferSize);
+            allocBuffer_(pcSwMdcGo_, bufferSize);
+            allocBuffer_(krnSwMdcGo_, bufferSize);
         }
 
         if (simulator_.vanguard().eclState().fieldProps().has_double("SWATINIT")) {
-            ppcw_.resize(bufferSize, 0.0);
+            allocBuffer_(ppcw_, bufferSize);
             rstKeywords["PPCW"] = 0;
         }
 
         if (FluidSystem::enableDissolvedGas() && rstKeywords["RSSAT"] > 0) {
             rstKeywords["RSSAT"] = 0;
-            gasDissolutionFactor_.resize(bufferSize, 0.0);
+            allocBuffer_(gasDissolutionFactor_, bufferSize);
         }
         if (FluidSystem::enableVaporizedOil() && rstKeywords["RVSAT"] > 0) {
             rstKeywords["RVSAT"] = 0;
-            oilVaporizationFactor_.resize(bufferSize, 0.0);
+            allocBuffer_(oilVaporizationFactor_, bufferSize);
         }
 
         if (FluidSystem::phaseIsActive(waterPhaseIdx) && rstKeywords["BW"] > 0) {
             rstKeywords["BW"] = 0;
-            invB_[waterPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(invB_[waterPhaseIdx], bufferSize);
         }
         if (FluidSystem::phaseIsActive(oilPhaseIdx) && rstKeywords["BO"] > 0) {
             rstKeywords["BO"] = 0;
-            invB_[oilPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(invB_[oilPhaseIdx], bufferSize);
         }
         if (FluidSystem::phaseIsActive(gasPhaseIdx) && rstKeywords["BG"] > 0) {
             rstKeywords["BG"] = 0;
-            invB_[gasPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(invB_[gasPhaseIdx], bufferSize);
         }
 
         if (rstKeywords["DEN"] > 0) {
@@ -385,7 +392,7 @@ public:
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
                 if (!FluidSystem::phaseIsActive(phaseIdx))
                     continue;
-                density_[phaseIdx].resize(bufferSize, 0.0);
+                allocBuffer_(density_[phaseIdx], bufferSize);
             }
         }
         const bool hasVWAT = (rstKeywords["VISC"] > 0) || (rstKeywords["VWAT"] > 0);
@@ -395,34 +402,34 @@ public:
 
         if (FluidSystem::phaseIsActive(waterPhaseIdx) && hasVWAT) {
             rstKeywords["VWAT"] = 0;
-            viscosity_[waterPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(viscosity_[waterPhaseIdx], bufferSize);
         }
         if (FluidSystem::phaseIsActive(oilPhaseIdx) && hasVOIL > 0) {
             rstKeywords["VOIL"] = 0;
-            viscosity_[oilPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(viscosity_[oilPhaseIdx], bufferSize);
         }
         if (FluidSystem::phaseIsActive(gasPhaseIdx) && hasVGAS > 0) {
             rstKeywords["VGAS"] = 0;
-            viscosity_[gasPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(viscosity_[gasPhaseIdx], bufferSize);
         }
 
         if (FluidSystem::phaseIsActive(waterPhaseIdx) && rstKeywords["KRW"] > 0) {
             rstKeywords["KRW"] = 0;
-            relativePermeability_[waterPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(relativePermeability_[waterPhaseIdx], bufferSize);
         }
         if (FluidSystem::phaseIsActive(oilPhaseIdx) && rstKeywords["KRO"] > 0) {
             rstKeywords["KRO"] = 0;
-            relativePermeability_[oilPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(relativePermeability_[oilPhaseIdx], bufferSize);
         }
         if (FluidSystem::phaseIsActive(gasPhaseIdx) && rstKeywords["KRG"] > 0) {
             rstKeywords["KRG"] = 0;
-            relativePermeability_[gasPhaseIdx].resize(bufferSize, 0.0);
+            allocBuffer_(relativePermeability_[gasPhaseIdx], bufferSize);
         }
 
         if (rstKeywords["PBPD"] > 0)  {
             rstKeywords["PBPD"] = 0;
-            bubblePointPressure_.resize(bufferSize, 0.0);
-            dewPointPressure_.resize(bufferSize, 0.0);
+            allocBuffer_(bubblePointPressure_, bufferSize);
+            allocBuffer_(dewPointPressure_, bufferSize);
         }
 
         // tracers
@@ -431,18 +438,18 @@ public:
             tracerConcentrations_.resize(numTracers);
             for (int tracerIdx = 0; tracerIdx < numTracers; ++tracerIdx)
             {
-                tracerConcentrations_[tracerIdx].resize(bufferSize, 0.0);
+                allocBuffer_(tracerConcentrations_[tracerIdx], bufferSize);
             }
         }
 
         // ROCKC
         if (rstKeywords["ROCKC"] > 0) {
             rstKeywords["ROCKC"] = 0;
-            rockCompPorvMultiplier_.resize(bufferSize, 0.0);
-            rockCompTransMultiplier_.resize(bufferSize, 0.0);
-            swMax_.resize(bufferSize, 0.0);
-            minimumOilPressure_.resize(bufferSize, 0.0);
-            overburdenPressure_.resize(bufferSize, 0.0);
+            allocBuffer_(rockCompPorvMultiplier_, bufferSize);
+            allocBuffer_(rockCompTransMultiplier_, bufferSize);
+            allocBuffer_(swMax_, bufferSize);
+            allocBuffer_(minimumOilPressure_, bufferSize);
+            allocBuffer_(overburdenPressure_, bufferSize);
         }
 
         //Warn for any unhandled keyword
@@ -462,9 +469,9 @@ public:
 
         // Not supported in flow legacy
         if (false)
-            saturatedOilFormationVolumeFactor_.resize(bufferSize, 0.0);
+            allocBuffer_(saturatedOilFormationVolumeFactor_, bufferSize);
         if (false)
-            oilSaturationPressure_.resize(bufferSize, 0.0);
+            allocBuffer_(oilSaturationPressure_, bufferSize);
 
     }
 
@@ -477,308 +484,42 @@ public:
         if (!std::is_same<Discretization, Opm::EcfvDiscretization<TypeTag> >::value)
             return;
 
-        const auto& problem = elemCtx.simulator().problem();
         for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
-            const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
-            const auto& fs = intQuants.fluidState();
-
-            typedef typename std::remove_const<typename std::remove_reference<decltype(fs)>::type>::type FluidState;
-            unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-            unsigned pvtRegionIdx = elemCtx.primaryVars(dofIdx, /*timeIdx=*/0).pvtRegionIndex();
-
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (saturation_[phaseIdx].size() == 0)
-                    continue;
-
-                saturation_[phaseIdx][globalDofIdx] = Opm::getValue(fs.saturation(phaseIdx));
-                Opm::Valgrind::CheckDefined(saturation_[phaseIdx][globalDofIdx]);
-            }
-
-            if (oilPressure_.size() > 0) {
-                if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
-                    oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(oilPhaseIdx));
-                }else{
-                    // put pressure in oil pressure for output
-                    if (FluidSystem::phaseIsActive(waterPhaseIdx)) {
-                        oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(waterPhaseIdx));
-                    } else {
-                        oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(gasPhaseIdx));
-                    }
-                }
-                Opm::Valgrind::CheckDefined(oilPressure_[globalDofIdx]);
-            }
-
-            if (enableEnergy) {
-                temperature_[globalDofIdx] = Opm::getValue(fs.temperature(oilPhaseIdx));
-                Opm::Valgrind::CheckDefined(temperature_[globalDofIdx]);
-            }
-            if (gasDissolutionFactor_.size() > 0) {
-                Scalar SoMax = elemCtx.problem().maxOilSaturation(globalDofIdx);
-                gasDissolutionFactor_[globalDofIdx] =
-                    FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx, SoMax);
-                Opm::Valgrind::CheckDefined(gasDissolutionFactor_[globalDofIdx]);
-
-            }
-            if (oilVaporizationFactor_.size() > 0) {
-                Scalar SoMax = elemCtx.problem().maxOilSaturation(globalDofIdx);
-                oilVaporizationFactor_[globalDofIdx] =
-                    FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx, SoMax);
-                Opm::Valgrind::CheckDefined(oilVaporizationFactor_[globalDofIdx]);
-
-            }
-            if (gasFormationVolumeFactor_.size() > 0) {
-                gasFormationVolumeFactor_[globalDofIdx] =
-                    1.0/FluidSystem::template inverseFormationVolumeFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx);
-                Opm::Valgrind::CheckDefined(gasFormationVolumeFactor_[globalDofIdx]);
-
-            }
-            if (saturatedOilFormationVolumeFactor_.size() > 0) {
-                saturatedOilFormationVolumeFactor_[globalDofIdx] =
-                    1.0/FluidSystem::template saturatedInverseFormationVolumeFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
-                Opm::Valgrind::CheckDefined(saturatedOilFormationVolumeFactor_[globalDofIdx]);
-
-            }
-            if (oilSaturationPressure_.size() > 0) {
-                oilSaturationPressure_[globalDofIdx] =
-                    FluidSystem::template saturationPressure<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
-                Opm::Valgrind::CheckDefined(oilSaturationPressure_[globalDofIdx]);
-
-            }
-
-            if (rs_.size()) {
-                rs_[globalDofIdx] = Opm::getValue(fs.Rs());
-                Opm::Valgrind::CheckDefined(rs_[globalDofIdx]);
-            }
-
-            if (rv_.size()) {
-                rv_[globalDofIdx] = Opm::getValue(fs.Rv());
-                Opm::Valgrind::CheckDefined(rv_[globalDofIdx]);
-            }
-
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (invB_[phaseIdx].size() == 0)
-                    continue;
-
-                invB_[phaseIdx][globalDofIdx] = Opm::getValue(fs.invB(phaseIdx));
-                Opm::Valgrind::CheckDefined(invB_[phaseIdx][globalDofIdx]);
-            }
-
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (density_[phaseIdx].size() == 0)
-                    continue;
-
-                density_[phaseIdx][globalDofIdx] = Opm::getValue(fs.density(phaseIdx));
-                Opm::Valgrind::CheckDefined(density_[phaseIdx][globalDofIdx]);
-            }
-
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (viscosity_[phaseIdx].size() == 0)
-                    continue;
-
-                viscosity_[phaseIdx][globalDofIdx] = Opm::getValue(fs.viscosity(phaseIdx));
-                Opm::Valgrind::CheckDefined(viscosity_[phaseIdx][globalDofIdx]);
-            }
-
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (relativePermeability_[phaseIdx].size() == 0)
-                    continue;
-
-                relativePermeability_[phaseIdx][globalDofIdx] = Opm::getValue(intQuants.relativePermeability(phaseIdx));
-                Opm::Valgrind::CheckDefined(relativePermeability_[phaseIdx][globalDofIdx]);
-            }
-
-            if (sSol_.size() > 0) {
-                sSol_[globalDofIdx] = intQuants.solventSaturation().value();
-            }
-
-            if (cPolymer_.size() > 0) {
-                cPolymer_[globalDofIdx] = intQuants.polymerConcentration().value();
-            }
-
-            if (cFoam_.size() > 0) {
-                cFoam_[globalDofIdx] = intQuants.foamConcentration().value();
-            }
-
-            if (cSalt_.size() > 0) {
-                cSalt_[globalDofIdx] = fs.saltConcentration().value();
-            }
-
-            if (bubblePointPressure_.size() > 0) {
-                try {
-                    bubblePointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::bubblePointPressure(fs, intQuants.pvtRegionIndex()));
-                }
-                catch (const Opm::NumericalIssue&) {
-                    const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-                    failedCellsPb_.push_back(cartesianIdx);
-                }
-            }
-            if (dewPointPressure_.size() > 0) {
-                try {
-                    dewPointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::dewPointPressure(fs, intQuants.pvtRegionIndex()));
-                }
-                catch (const Opm::NumericalIssue&) {
-                    const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-                    failedCellsPd_.push_back(cartesianIdx);
-                }
-            }
-
-            if (soMax_.size() > 0)
-                soMax_[globalDofIdx] =
-                    std::max(Opm::getValue(fs.saturation(oilPhaseIdx)),
-                             problem.maxOilSaturation(globalDofIdx));
-
-            if (swMax_.size() > 0)
-                swMax_[globalDofIdx] =
-                    std::max(Opm::getValue(fs.saturation(waterPhaseIdx)),
-                             problem.maxWaterSaturation(globalDofIdx));
-
-            if (minimumOilPressure_.size() > 0)
-                minimumOilPressure_[globalDofIdx] =
-                    std::min(Opm::getValue(fs.pressure(oilPhaseIdx)),
-                             problem.minOilPressure(globalDofIdx));
-
-            if (overburdenPressure_.size() > 0)
-                overburdenPressure_[globalDofIdx] = problem.overburdenPressure(globalDofIdx);
-
-            if (rockCompPorvMultiplier_.size() > 0)
-                rockCompPorvMultiplier_[globalDofIdx] = problem.template rockCompPoroMultiplier<Scalar>(intQuants, globalDofIdx);
-
-            if (rockCompTransMultiplier_.size() > 0)
-                rockCompTransMultiplier_[globalDofIdx] = problem.template rockCompTransMultiplier<Scalar>(intQuants, globalDofIdx);
-
-            const auto& matLawManager = problem.materialLawManager();
-            if (matLawManager->enableHysteresis()) {
-                if (pcSwMdcOw_.size() > 0 && krnSwMdcOw_.size() > 0) {
-                    matLawManager->oilWaterHysteresisParams(
-                                pcSwMdcOw_[globalDofIdx],
-                                krnSwMdcOw_[globalDofIdx],
-                                globalDofIdx);
-                }
-                if (pcSwMdcGo_.size() > 0 && krnSwMdcGo_.size() > 0) {
-                    matLawManager->gasOilHysteresisParams(
-                                pcSwMdcGo_[globalDofIdx],
-                                krnSwMdcGo_[globalDofIdx],
-                                globalDofIdx);
-                }
-            }
-
-
-            if (ppcw_.size() > 0) {
-                ppcw_[globalDofIdx] = matLawManager->oilWaterScaledEpsInfoDrainage(globalDofIdx).maxPcow;
-                //printf("ppcw_[%d] = %lg\n", globalDofIdx, ppcw_[globalDofIdx]);
-            }
-            // hack to make the intial output of rs and rv Ecl compatible.
-            // For cells with swat == 1 Ecl outputs; rs = rsSat and rv=rvSat, in all but the initial step
-            // where it outputs rs and rv values calculated by the initialization. To be compatible we overwrite
-            // rs and rv with the values computed in the initially.
-            // Volume factors, densities and viscosities need to be recalculated with the updated rs and rv values.
-            // This can be removed when ebos has 100% controll over output
-            if (elemCtx.simulator().episodeIndex() < 0 && FluidSystem::phaseIsActive(oilPhaseIdx) && FluidSystem::phaseIsActive(gasPhaseIdx)) {
-
-                const auto& fsInitial = problem.initialFluidState(globalDofIdx);
-
-                // use initial rs and rv values
-                if (rv_.size() > 0)
-                    rv_[globalDofIdx] = fsInitial.Rv();
-
-                if (rs_.size() > 0)
-                    rs_[globalDofIdx] = fsInitial.Rs();
-
-                // re-compute the volume factors, viscosities and densities if asked for
-                if (density_[oilPhaseIdx].size() > 0)
-                    density_[oilPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
-                                                                               oilPhaseIdx,
-                                                                               intQuants.pvtRegionIndex());
-                if (density_[gasPhaseIdx].size() > 0)
-                    density_[gasPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
-                                                                               gasPhaseIdx,
-                                                                               intQuants.pvtRegionIndex());
-
-                if (invB_[oilPhaseIdx].size() > 0)
-                    invB_[oilPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
-                                                                                                 oilPhaseIdx,
-                                                                                                 intQuants.pvtRegionIndex());
-                if (invB_[gasPhaseIdx].size() > 0)
-                    invB_[gasPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
-                                                                                                 gasPhaseIdx,
-                                                                                                 intQuants.pvtRegionIndex());
-                if (viscosity_[oilPhaseIdx].size() > 0)
-                    viscosity_[oilPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
-                                                                                   oilPhaseIdx,
-                                                                                   intQuants.pvtRegionIndex());
-                if (viscosity_[gasPhaseIdx].size() > 0)
-                    viscosity_[gasPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
-                                                                                   gasPhaseIdx,
-                                                                                   intQuants.pvtRegionIndex());
-            }
+            processDof_(elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0),
+                        elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0));
+        }
+    }
 
-            // Add fluid in Place values
-            updateFluidInPlace_(elemCtx, dofIdx);
-
-            // Adding block data
-            const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-            for (auto& val: blockData_) {
-                const auto& key = val.first;
-                int cartesianIdxBlock = key.second - 1;
-                if (cartesianIdx == cartesianIdxBlock) {
-                    if (key.first == "BWSAT")
-                        val.second = Opm::getValue(fs.saturation(waterPhaseIdx));
-                    else if (key.first == "BGSAT")
-                        val.second = Opm::getValue(fs.saturation(gasPhaseIdx));
-                    else if (key.first == "BOSAT")
-                        val.second = 1. - Opm::getValue(fs.saturation(gasPhaseIdx)) - Opm::getValue(fs.saturation(waterPhaseIdx));
-                    else if (key.first == "BPR")
-                        val.second = Opm::getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BWKR" || key.first == "BKRW")
-                        val.second = Opm::getValue(intQuants.relativePermeability(waterPhaseIdx));
-                    else if (key.first == "BGKR" || key.first == "BKRG")
-                        val.second = Opm::getValue(intQuants.relativePermeability(gasPhaseIdx));
-                    else if (key.first == "BOKR" || key.first == "BKRO")
-                        val.second = Opm::getValue(intQuants.relativePermeability(oilPhaseIdx));
-                    else if (key.first == "BWPC")
-                        val.second = Opm::getValue(fs.pressure(oilPhaseIdx)) - Opm::getValue(fs.pressure(waterPhaseIdx));
-                    else if (key.first == "BGPC")
-                        val.second = Opm::getValue(fs.pressure(gasPhaseIdx)) - Opm::getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BVWAT" || key.first == "BWVIS")
-                        val.second = Opm::getValue(fs.viscosity(waterPhaseIdx));
-                    else if (key.first == "BVGAS" || key.first == "BGVIS")
-                        val.second = Opm::getValue(fs.viscosity(gasPhaseIdx));
-                    else if (key.first == "BVOIL" || key.first == "BOVIS")
-                        val.second = Opm::getValue(fs.viscosity(oilPhaseIdx));
-                    else {
-                        std::string logstring = "Keyword '";
-                        logstring.append(key.first);
-                        logstring.append("' is unhandled for output to file.");
-                        Opm::OpmLog::warning("Unhandled output keyword", logstring);
-                    }
-                }
-            }
+    /*!
+     * \brief Modify the internal buffers using the intensive quantities which have
+     *        been cached by the last linearization.
+     *
+     * This avoids the traversal of the grid and the update of the intensive quantities
+     * which processElement() requires.
+     *
+     * \return false if the intensive quantities of some degree of freedom are not
+     *         cached, in this case nothing is done and processElement() must be used.
+     */
+    bool processCachedIntensiveQuantities()
+    {
+        if (!std::is_same<Discretization, Opm::EcfvDiscretization<TypeTag> >::value)
+            return true;
 
-            // Adding Well RFT data
-            if (oilConnectionPressures_.count(cartesianIdx) > 0) {
-                oilConnectionPressures_[cartesianIdx] = Opm::getValue(fs.pressure(oilPhaseIdx));
-            }
-            if (waterConnectionSaturations_.count(cartesianIdx) > 0) {
-                waterConnectionSaturations_[cartesianIdx] = Opm::getValue(fs.saturation(waterPhaseIdx));
-            }
-            if (gasConnectionSaturations_.count(cartesianIdx) > 0) {
-                gasConnectionSaturations_[cartesianIdx] = Opm::getValue(fs.saturation(gasPhaseIdx));
-            }
+        const auto& model = simulator_.model();
+        const unsigned numDof = model.numGridDof();
+        for (unsigned globalDofIdx = 0; globalDofIdx < numDof; ++globalDofIdx) {
+            if (!model.cachedIntensiveQuantities(globalDofIdx, /*timeIdx=*/0))
+                return false;
+        }
 
-            // tracers
-            const auto& tracerModel = simulator_.problem().tracerModel();
-            if (tracerConcentrations_.size()>0) {
-                for (int tracerIdx = 0; tracerIdx < tracerModel.numTracers(); tracerIdx++){
-                    if (tracerConcentrations_[tracerIdx].size() == 0)
-                        continue;
+        for (unsigned globalDofIdx = 0; globalDofIdx < numDof; ++globalDofIdx)
+            processDof_(*model.cachedIntensiveQuantities(globalDofIdx, /*timeIdx=*/0), globalDofIdx);
 
-                    tracerConcentrations_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
-                }
-            }
-        }
+        return true;
     }
 
 
+
     void outputErrorLog()
     {
         const size_t maxNumCellsFaillog = 20;
@@ -1044,6 +785,28 @@ public:
         }
     }
 
+    /*!
+     * \brief Hand the storage of a solution which is not needed anymore back
+     *        to the module, so that the buffers for the next report step do
+     *        not need to be allocated again.
+     *
+     * This method may be called from the output thread.
+     */
+    void recycleBuffers(Opm::data::Solution& sol)
+    {
+        if constexpr (std::is_same<Scalar, double>::value) {
+            std::lock_guard<std::mutex> lock(bufferPoolMutex_);
+            for (auto& entry : sol) {
+                if (bufferPool_.size() >= maxPooledBuffers_)
+                    break;
+
+                auto& data = entry.second.data;
+                if (data.capacity() > 0)
+                    bufferPool_.push_back(std::move(data));
+            }
+        }
+    }
+
     // write Fluid In Place to output log
     void outputFipLog(std::map<std::string, double>& miscSummaryData,  std::map<std::string, std::vector<double>>& regionData, const bool substep)
     {
@@ -1085,7 +848,7 @@ public:
         // the original Fip values are stored on the first step
         // TODO: Store initial Fip in the init file and restore them
         // and use them here.
-        const Opm::SummaryConfig summaryConfig = simulator_.vanguard().summaryConfig();
+        const Opm::SummaryConfig& summaryConfig = simulator_.vanguard().summaryConfig();
         if (isIORank_()) {
             // Field summary output
             for (int i = 0; i<FipDataType::numFipValues; i++) {
@@ -1686,12 +1449,308 @@ private:
         return comm.rank() == 0;
     }
 
-    void updateFluidInPlace_(const ElementContext& elemCtx, unsigned dofIdx)
+    void processDof_(const IntensiveQuantities& intQuants, unsigned globalDofIdx)
     {
+        const auto& problem = simulator_.problem();
+        const auto& fs = intQuants.fluidState();
+
+        typedef typename std::remove_const<typename std::remove_reference<decltype(fs)>::type>::type FluidState;
+        unsigned pvtRegionIdx = intQuants.pvtRegionIndex();
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (saturation_[phaseIdx].size() == 0)
+                continue;
+
+            saturation_[phaseIdx][globalDofIdx] = Opm::getValue(fs.saturation(phaseIdx));
+            Opm::Valgrind::CheckDefined(saturation_[phaseIdx][globalDofIdx]);
+        }
+
+        if (oilPressure_.size() > 0) {
+            if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
+                oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(oilPhaseIdx));
+            }else{
+                // put pressure in oil pressure for output
+                if (FluidSystem::phaseIsActive(waterPhaseIdx)) {
+                    oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(waterPhaseIdx));
+                } else {
+                    oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(gasPhaseIdx));
+                }
+            }
+            Opm::Valgrind::CheckDefined(oilPressure_[globalDofIdx]);
+        }
+
+        if (enableEnergy) {
+            temperature_[globalDofIdx] = Opm::getValue(fs.temperature(oilPhaseIdx));
+            Opm::Valgrind::CheckDefined(temperature_[globalDofIdx]);
+        }
+        if (gasDissolutionFactor_.size() > 0) {
+            Scalar SoMax = problem.maxOilSaturation(globalDofIdx);
+            gasDissolutionFactor_[globalDofIdx] =
+                FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx, SoMax);
+            Opm::Valgrind::CheckDefined(gasDissolutionFactor_[globalDofIdx]);
+
+        }
+        if (oilVaporizationFactor_.size() > 0) {
+            Scalar SoMax = problem.maxOilSaturation(globalDofIdx);
+            oilVaporizationFactor_[globalDofIdx] =
+                FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx, SoMax);
+            Opm::Valgrind::CheckDefined(oilVaporizationFactor_[globalDofIdx]);
+
+        }
+        if (gasFormationVolumeFactor_.size() > 0) {
+            gasFormationVolumeFactor_[globalDofIdx] =
+                1.0/FluidSystem::template inverseFormationVolumeFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx);
+            Opm::Valgrind::CheckDefined(gasFormationVolumeFactor_[globalDofIdx]);
+
+        }
+        if (saturatedOilFormationVolumeFactor_.size() > 0) {
+            saturatedOilFormationVolumeFactor_[globalDofIdx] =
+                1.0/FluidSystem::template saturatedInverseFormationVolumeFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
+            Opm::Valgrind::CheckDefined(saturatedOilFormationVolumeFactor_[globalDofIdx]);
+
+        }
+        if (oilSaturationPressure_.size() > 0) {
+            oilSaturationPressure_[globalDofIdx] =
+                FluidSystem::template saturationPressure<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
+            Opm::Valgrind::CheckDefined(oilSaturationPressure_[globalDofIdx]);
+
+        }
+
+        if (rs_.size()) {
+            rs_[globalDofIdx] = Opm::getValue(fs.Rs());
+            Opm::Valgrind::CheckDefined(rs_[globalDofIdx]);
+        }
+
+        if (rv_.size()) {
+            rv_[globalDofIdx] = Opm::getValue(fs.Rv());
+            Opm::Valgrind::CheckDefined(rv_[globalDofIdx]);
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (invB_[phaseIdx].size() == 0)
+                continue;
+
+            invB_[phaseIdx][globalDofIdx] = Opm::getValue(fs.invB(phaseIdx));
+            Opm::Valgrind::CheckDefined(invB_[phaseIdx][globalDofIdx]);
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (density_[phaseIdx].size() == 0)
+                continue;
+
+            density_[phaseIdx][globalDofIdx] = Opm::getValue(fs.density(phaseIdx));
+            Opm::Valgrind::CheckDefined(density_[phaseIdx][globalDofIdx]);
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (viscosity_[phaseIdx].size() == 0)
+                continue;
+
+            viscosity_[phaseIdx][globalDofIdx] = Opm::getValue(fs.viscosity(phaseIdx));
+            Opm::Valgrind::CheckDefined(viscosity_[phaseIdx][globalDofIdx]);
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (relativePermeability_[phaseIdx].size() == 0)
+                continue;
+
+            relativePermeability_[phaseIdx][globalDofIdx] = Opm::getValue(intQuants.relativePermeability(phaseIdx));
+            Opm::Valgrind::CheckDefined(relativePermeability_[phaseIdx][globalDofIdx]);
+        }
+
+        if (sSol_.size() > 0) {
+            sSol_[globalDofIdx] = intQuants.solventSaturation().value();
+        }
+
+        if (cPolymer_.size() > 0) {
+            cPolymer_[globalDofIdx] = intQuants.polymerConcentration().value();
+        }
+
+        if (cFoam_.size() > 0) {
+            cFoam_[globalDofIdx] = intQuants.foamConcentration().value();
+        }
+
+        if (cSalt_.size() > 0) {
+            cSalt_[globalDofIdx] = fs.saltConcentration().value();
+        }
+
+        if (bubblePointPressure_.size() > 0) {
+            try {
+                bubblePointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::bubblePointPressure(fs, intQuants.pvtRegionIndex()));
+            }
+            catch (const Opm::NumericalIssue&) {
+                const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+                failedCellsPb_.push_back(cartesianIdx);
+            }
+        }
+        if (dewPointPressure_.size() > 0) {
+            try {
+                dewPointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::dewPointPressure(fs, intQuants.pvtRegionIndex()));
+            }
+            catch (const Opm::NumericalIssue&) {
+                const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+                failedCellsPd_.push_back(cartesianIdx);
+            }
+        }
+
+        if (soMax_.size() > 0)
+            soMax_[globalDofIdx] =
+                std::max(Opm::getValue(fs.saturation(oilPhaseIdx)),
+                         problem.maxOilSaturation(globalDofIdx));
+
+        if (swMax_.size() > 0)
+            swMax_[globalDofIdx] =
+                std::max(Opm::getValue(fs.saturation(waterPhaseIdx)),
+                         problem.maxWaterSaturation(globalDofIdx));
+
+        if (minimumOilPressure_.size() > 0)
+            minimumOilPressure_[globalDofIdx] =
+                std::min(Opm::getValue(fs.pressure(oilPhaseIdx)),
+                         problem.minOilPressure(globalDofIdx));
 
-        const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
+        if (overburdenPressure_.size() > 0)
+            overburdenPressure_[globalDofIdx] = problem.overburdenPressure(globalDofIdx);
+
+        if (rockCompPorvMultiplier_.size() > 0)
+            rockCompPorvMultiplier_[globalDofIdx] = problem.template rockCompPoroMultiplier<Scalar>(intQuants, globalDofIdx);
+
+        if (rockCompTransMultiplier_.size() > 0)
+            rockCompTransMultiplier_[globalDofIdx] = problem.template rockCompTransMultiplier<Scalar>(intQuants, globalDofIdx);
+
+        const auto& matLawManager = problem.materialLawManager();
+        if (matLawManager->enableHysteresis()) {
+            if (pcSwMdcOw_.size() > 0 && krnSwMdcOw_.size() > 0) {
+                matLawManager->oilWaterHysteresisParams(
+                            pcSwMdcOw_[globalDofIdx],
+                            krnSwMdcOw_[globalDofIdx],
+                            globalDofIdx);
+            }
+            if (pcSwMdcGo_.size() > 0 && krnSwMdcGo_.size() > 0) {
+                matLawManager->gasOilHysteresisParams(
+                            pcSwMdcGo_[globalDofIdx],
+                            krnSwMdcGo_[globalDofIdx],
+                            globalDofIdx);
+            }
+        }
+
+
+        if (ppcw_.size() > 0) {
+            ppcw_[globalDofIdx] = matLawManager->oilWaterScaledEpsInfoDrainage(globalDofIdx).maxPcow;
+            //printf("ppcw_[%d] = %lg\n", globalDofIdx, ppcw_[globalDofIdx]);
+        }
+        // hack to make the intial output of rs and rv Ecl compatible.
+        // For cells with swat == 1 Ecl outputs; rs = rsSat and rv=rvSat, in all but the initial step
+        // where it outputs rs and rv values calculated by the initialization. To be compatible we overwrite
+        // rs and rv with the values computed in the initially.
+        // Volume factors, densities and viscosities need to be recalculated with the updated rs and rv values.
+        // This can be removed when ebos has 100% controll over output
+        if (simulator_.episodeIndex() < 0 && FluidSystem::phaseIsActive(oilPhaseIdx) && FluidSystem::phaseIsActive(gasPhaseIdx)) {
+
+            const auto& fsInitial = problem.initialFluidState(globalDofIdx);
+
+            // use initial rs and rv values
+            if (rv_.size() > 0)
+                rv_[globalDofIdx] = fsInitial.Rv();
+
+            if (rs_.size() > 0)
+                rs_[globalDofIdx] = fsInitial.Rs();
+
+            // re-compute the volume factors, viscosities and densities if asked for
+            if (density_[oilPhaseIdx].size() > 0)
+                density_[oilPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+                                                                           oilPhaseIdx,
+                                                                           intQuants.pvtRegionIndex());
+            if (density_[gasPhaseIdx].size() > 0)
+                density_[gasPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+                                                                           gasPhaseIdx,
+                                                                           intQuants.pvtRegionIndex());
+
+            if (invB_[oilPhaseIdx].size() > 0)
+                invB_[oilPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
+                                                                                             oilPhaseIdx,
+                                                                                             intQuants.pvtRegionIndex());
+            if (invB_[gasPhaseIdx].size() > 0)
+                invB_[gasPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
+                                                                                             gasPhaseIdx,
+                                                                                             intQuants.pvtRegionIndex());
+            if (viscosity_[oilPhaseIdx].size() > 0)
+                viscosity_[oilPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
+                                                                               oilPhaseIdx,
+                                                                               intQuants.pvtRegionIndex());
+            if (viscosity_[gasPhaseIdx].size() > 0)
+                viscosity_[gasPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
+                                                                               gasPhaseIdx,
+                                                                               intQuants.pvtRegionIndex());
+        }
+
+        // Add fluid in Place values
+        updateFluidInPlace_(intQuants, globalDofIdx);
+
+        // Adding block data
+        const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+        for (auto& val: blockData_) {
+            const auto& key = val.first;
+            int cartesianIdxBlock = key.second - 1;
+            if (cartesianIdx == cartesianIdxBlock) {
+                if (key.first == "BWSAT")
+                    val.second = Opm::getValue(fs.saturation(waterPhaseIdx));
+                else if (key.first == "BGSAT")
+                    val.second = Opm::getValue(fs.saturation(gasPhaseIdx));
+                else if (key.first == "BOSAT")
+                    val.second = 1. - Opm::getValue(fs.saturation(gasPhaseIdx)) - Opm::getValue(fs.saturation(waterPhaseIdx));
+                else if (key.first == "BPR")
+                    val.second = Opm::getValue(fs.pressure(oilPhaseIdx));
+                else if (key.first == "BWKR" || key.first == "BKRW")
+                    val.second = Opm::getValue(intQuants.relativePermeability(waterPhaseIdx));
+                else if (key.first == "BGKR" || key.first == "BKRG")
+                    val.second = Opm::getValue(intQuants.relativePermeability(gasPhaseIdx));
+                else if (key.first == "BOKR" || key.first == "BKRO")
+                    val.second = Opm::getValue(intQuants.relativePermeability(oilPhaseIdx));
+                else if (key.first == "BWPC")
+                    val.second = Opm::getValue(fs.pressure(oilPhaseIdx)) - Opm::getValue(fs.pressure(waterPhaseIdx));
+                else if (key.first == "BGPC")
+                    val.second = Opm::getValue(fs.pressure(gasPhaseIdx)) - Opm::getValue(fs.pressure(oilPhaseIdx));
+                else if (key.first == "BVWAT" || key.first == "BWVIS")
+                    val.second = Opm::getValue(fs.viscosity(waterPhaseIdx));
+                else if (key.first == "BVGAS" || key.first == "BGVIS")
+                    val.second = Opm::getValue(fs.viscosity(gasPhaseIdx));
+                else if (key.first == "BVOIL" || key.first == "BOVIS")
+                    val.second = Opm::getValue(fs.viscosity(oilPhaseIdx));
+                else {
+                    std::string logstring = "Keyword '";
+                    logstring.append(key.first);
+                    logstring.append("' is unhandled for output to file.");
+                    Opm::OpmLog::warning("Unhandled output keyword", logstring);
+                }
+            }
+        }
+
+        // Adding Well RFT data
+        if (oilConnectionPressures_.count(cartesianIdx) > 0) {
+            oilConnectionPressures_[cartesianIdx] = Opm::getValue(fs.pressure(oilPhaseIdx));
+        }
+        if (waterConnectionSaturations_.count(cartesianIdx) > 0) {
+            waterConnectionSaturations_[cartesianIdx] = Opm::getValue(fs.saturation(waterPhaseIdx));
+        }
+        if (gasConnectionSaturations_.count(cartesianIdx) > 0) {
+            gasConnectionSaturations_[cartesianIdx] = Opm::getValue(fs.saturation(gasPhaseIdx));
+        }
+
+        // tracers
+        const auto& tracerModel = simulator_.problem().tracerModel();
+        if (tracerConcentrations_.size()>0) {
+            for (int tracerIdx = 0; tracerIdx < tracerModel.numTracers(); tracerIdx++){
+                if (tracerConcentrations_[tracerIdx].size() == 0)
+                    continue;
+
+                tracerConcentrations_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
+            }
+        }
+    }
+
+    void updateFluidInPlace_(const IntensiveQuantities& intQuants, unsigned globalDofIdx)
+    {
         const auto& fs = intQuants.fluidState();
-        unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
 
         // Fluid in Place calculations
 
@@ -1703,7 +1762,7 @@ private:
         // returned by the intensive quantities can be outside of the physical
         // range [0, 1] in pathetic cases.
         const double pv =
-            elemCtx.simulator().model().dofTotalVolume(globalDofIdx)
+            simulator_.model().dofTotalVolume(globalDofIdx)
             * intQuants.porosity().value();
 
         if (pressureTimesHydrocarbonVolume_.size() > 0 && pressureTimesPoreVolume_.size() > 0) {
@@ -2131,8 +2190,43 @@ private:
             || (keyword == "SAVE")  || (keyword == "SFREQ"); // Not really supported
     }
 
+    // Size a buffer for the current step. Buffers which have been moved to
+    // the output writer take their storage from the recycled ones if possible.
+    void allocBuffer_(ScalarBuffer& buffer, unsigned bufferSize)
+    {
+        if constexpr (std::is_same<Scalar, double>::value) {
+            if (buffer.capacity() < bufferSize) {
+                std::lock_guard<std::mutex> lock(bufferPoolMutex_);
+                // use the smallest recycled buffer which is large enough
+                auto best = bufferPool_.end();
+                for (auto it = bufferPool_.begin(); it != bufferPool_.end(); ++it) {
+                    if (it->capacity() >= bufferSize
+                        && (best == bufferPool_.end() || it->capacity() < best->capacity()))
+                        best = it;
+                }
+                if (best != bufferPool_.end()) {
+                    buffer.swap(*best);
+                    bufferPool_.erase(best);
+                    // the recycled storage contains the values of another field
+                    buffer.assign(bufferSize, 0.0);
+                    return;
+                }
+            }
+        }
+        buffer.resize(bufferSize, 0.0);
+    }
+
     const Simulator& simulator_;
 
+    // restart keywords requested for rstKeywordsReportStep_
+    std::map<std::string, int> rstKeywordsCache_;
+    int rstKeywordsReportStep_ = -1;
+
+    // storage of buffers which have been written, see recycleBuffers()
+    static constexpr std::size_t maxPooledBuffers_ = 64;
+    std::vector<std::vector<double>> bufferPool_;
+    std::mutex bufferPoolMutex_;
+
     bool outputFipRestart_;
     bool computeFip_;
     bool forceDisableFipOutput_;
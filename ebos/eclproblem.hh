@@ -64,9 +64,9 @@
 #include "ecltracermodel.hh"
 #include "vtkecltracermodule.hh"
 
-#include <opm/models/utils/pffgridvector.hh>
 #include <opm/models/blackoil/blackoilmodel.hh>
 #include <opm/models/discretization/ecfv/ecfvdiscretization.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
 
 #include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
 #include <opm/material/thermal/EclThermalLawManager.hpp>
@@ -447,6 +447,18 @@ struct EclOutputDoublePrecision<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+// By default, recompute the intensive quantities for the ECL cell output
+template<class TypeTag>
+struct EclOutputFromIntensiveQuantityCache<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = false;
+};
+
+// By default, the restart cell data is gathered on the I/O rank
+template<class TypeTag>
+struct EclOutputPartitionedRestart<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = false;
+};
+
 // The default location for the ECL output files
 template<class TypeTag>
 struct OutputDir<TypeTag, TTag::EclBaseProblem> {
@@ -797,7 +809,6 @@ public:
         , thresholdPressures_(simulator)
         , wellModel_(simulator)
         , aquiferModel_(simulator)
-        , pffDofData_(simulator.gridView(), this->elementMapper())
         , tracerModel_(simulator)
     {
         this->model().addOutputModule(new VtkEclTracerModule<TypeTag>(simulator));
@@ -898,8 +909,6 @@ public:
         else
             readInitialCondition_();
 
-        updatePffDofData_();
-
         if (getPropValue<TypeTag, Properties::EnablePolymer>()) {
             const auto& vanguard = this->simulator().vanguard();
             const auto& gridView = vanguard.gridView();
@@ -934,9 +943,6 @@ public:
         }
     }
 
-    void prefetch(const Element& elem) const
-    { pffDofData_.prefetch(elem); }
-
     /*!
      * \brief This method restores the complete state of the problem and its sub-objects
      *        from disk.
@@ -1004,7 +1010,6 @@ public:
             transmissibilities_.update(true);
             referencePorosity_[1] = referencePorosity_[0];
             updateReferencePorosity_();
-            updatePffDofData_();
         }
 
         if (enableExperiments && this->gridView().comm().rank() == 0 && episodeIdx >= 0) {
@@ -1037,12 +1042,7 @@ public:
             tuningEvent = true;
         }
 
-        const bool invalidateFromHyst = updateHysteresis_();
-        const bool invalidateFromMaxOilSat = updateMaxOilSaturation_();
-        const bool doInvalidate = invalidateFromHyst || invalidateFromMaxOilSat;
-
-        if (getPropValue<TypeTag, Properties::EnablePolymer>())
-            updateMaxPolymerAdsorption_();
+        const bool doInvalidate = updateEpisodeHistory_();
 
         // set up the wells for the next episode.
         wellModel_.beginEpisode();
@@ -1099,9 +1099,7 @@ public:
 
         // update maximum water saturation and minimum pressure
         // used when ROCKCOMP is activated
-        const bool invalidateFromMaxWaterSat = updateMaxWaterSaturation_();
-        const bool invalidateFromMinPressure = updateMinPressure_();
-        invalidateIntensiveQuantities = invalidateFromMaxWaterSat || invalidateFromMinPressure;
+        invalidateIntensiveQuantities = updateRockCompHistory_();
 
         if (invalidateIntensiveQuantities)
             this->model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
@@ -1334,7 +1332,13 @@ public:
                             unsigned toDofLocalIdx) const
     {
         assert(fromDofLocalIdx == 0);
-        return pffDofData_.get(context.element(), toDofLocalIdx).transmissibility;
+        unsigned elemIdx = context.globalSpaceIndex(/*dofIdx=*/0, /*timeIdx=*/0);
+
+        // the face table of the transmissibility object uses the same ordering of the
+        // neighbors as the stencil, so we can directly use the offset of the neighbor
+        assert(transmissibilities_.faceNeighbor(elemIdx, toDofLocalIdx - 1)
+               == context.globalSpaceIndex(toDofLocalIdx, /*timeIdx=*/0));
+        return transmissibilities_.faceTransmissibility(elemIdx, toDofLocalIdx - 1);
     }
 
     /*!
@@ -1357,8 +1361,9 @@ public:
                                        unsigned timeIdx) const
     {
         const auto& face = context.stencil(timeIdx).interiorFace(faceIdx);
+        unsigned elemIdx = context.globalSpaceIndex(/*dofIdx=*/0, timeIdx);
         unsigned toDofLocalIdx = face.exteriorIndex();
-        return *pffDofData_.get(context.element(), toDofLocalIdx).thermalHalfTrans;
+        return transmissibilities_.faceThermalHalfTrans(elemIdx, toDofLocalIdx - 1);
     }
 
     /*!
@@ -1978,6 +1983,12 @@ public:
     const Opm::EclipseIO& eclIO() const
     { return eclWriter_->eclIO(); }
 
+    /*!
+     * \brief Return the timings of the ECL output since the last call.
+     */
+    Opm::PhaseTimings takeOutputTimings()
+    { return eclWriter_ ? eclWriter_->takeOutputTimings() : Opm::PhaseTimings{}; }
+
     bool vapparsActive() const
     {
         const auto& simulator = this->simulator();
@@ -2285,93 +2296,121 @@ private:
         }
     }
 
-    bool updateMaxOilSaturation_()
+    // update the history dependent quantities which are updated at the beginning of an
+    // episode, i.e., the hysteresis parameters, the maximum oil saturation for VAPPARS
+    // and the maximum polymer adsorption. returns true if the intensive quantities need
+    // to be recalculated afterwards.
+    bool updateEpisodeHistory_()
     {
-        const auto& simulator = this->simulator();
-
-        // we use VAPPARS
-        if (vapparsActive()) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        const bool hysteresisActive = materialLawManager_->enableHysteresis();
+        const bool maxOilSatActive = vapparsActive();
+        const bool maxPolymerAdsActive = enablePolymer;
 
-                unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = iq.fluidState();
-
-                Scalar So = Opm::decay<Scalar>(fs.saturation(oilPhaseIdx));
-
-                maxOilSaturation_[compressedDofIdx] = std::max(maxOilSaturation_[compressedDofIdx], So);
-            }
+        if (!hysteresisActive && !maxOilSatActive && !maxPolymerAdsActive)
+            return false;
 
-            // we need to invalidate the intensive quantities cache here because the
-            // derivatives of Rs and Rv will most likely have changed
-            return true;
-        }
+        // we need to update the data for _all_ elements (i.e., not just the interior
+        // ones) to avoid desynchronization of the processes in the parallel case!
+        updateFromIntensiveQuantities_([&](unsigned compressedDofIdx,
+                                           const IntensiveQuantities& iq)
+        {
+            if (hysteresisActive)
+                updateHysteresis_(compressedDofIdx, iq);
+            if (maxOilSatActive)
+                updateMaxOilSaturation_(compressedDofIdx, iq);
+            if (maxPolymerAdsActive)
+                updateMaxPolymerAdsorption_(compressedDofIdx, iq);
+        });
 
-        return false;
+        // we need to invalidate the intensive quantities cache if the hysteresis
+        // parameters changed or if VAPPARS is used because the derivatives of Rs and Rv
+        // will most likely have changed
+        return hysteresisActive || maxOilSatActive;
     }
 
-    bool updateMaxWaterSaturation_()
+    // update the history dependent quantities which are required by ROCKCOMP at the
+    // beginning of a time step. returns true if the intensive quantities need to be
+    // recalculated afterwards.
+    bool updateRockCompHistory_()
     {
         // water compaction is activated in ROCKCOMP
-        if (maxWaterSaturation_.size()== 0)
-            return false;
-
-        maxWaterSaturation_[/*timeIdx=*/1] = maxWaterSaturation_[/*timeIdx=*/0];
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
+        const bool maxWaterSatActive = !maxWaterSaturation_.empty();
+        // IRREVERS option is used in ROCKCOMP
+        const bool minPressureActive = !minOilPressure_.empty();
 
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        if (!maxWaterSatActive && !minPressureActive)
+            return false;
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+        if (maxWaterSatActive)
+            maxWaterSaturation_[/*timeIdx=*/1] = maxWaterSaturation_[/*timeIdx=*/0];
 
-            Scalar Sw = Opm::decay<Scalar>(fs.saturation(waterPhaseIdx));
-            maxWaterSaturation_[compressedDofIdx] = std::max(maxWaterSaturation_[compressedDofIdx], Sw);
-        }
+        updateFromIntensiveQuantities_([&](unsigned compressedDofIdx,
+                                           const IntensiveQuantities& iq)
+        {
+            if (maxWaterSatActive)
+                updateMaxWaterSaturation_(compressedDofIdx, iq);
+            if (minPressureActive)
+                updateMinPressure_(compressedDofIdx, iq);
+        });
 
         return true;
     }
 
-    bool updateMinPressure_()
+    // call a functor with the intensive quantities of all elements of the grid view.
+    //
+    // if possible, the cached intensive quantities of the model are used, else they get
+    // recomputed using an element context. the elements are processed by all threads
+    // concurrently, so the functor may only modify data associated with the element it
+    // is called for.
+    template <class Functor>
+    void updateFromIntensiveQuantities_(const Functor& functor) const
     {
-        // IRREVERS option is used in ROCKCOMP
-        if (minOilPressure_.empty())
-            return false;
-
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
+        const auto& simulator = this->simulator();
+        const auto& model = simulator.model();
+        Opm::ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator.vanguard().gridView());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator);
+            auto elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                const Element& elem = *elemIt;
+                unsigned compressedDofIdx = model.dofMapper().index(elem);
+
+                const IntensiveQuantities* iq =
+                    model.cachedIntensiveQuantities(compressedDofIdx, /*timeIdx=*/0);
+                if (!iq) {
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    iq = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                }
 
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                functor(compressedDofIdx, *iq);
+            }
+        }
+    }
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+    void updateMaxOilSaturation_(unsigned compressedDofIdx, const IntensiveQuantities& iq)
+    {
+        const auto& fs = iq.fluidState();
+        Scalar So = Opm::decay<Scalar>(fs.saturation(oilPhaseIdx));
+        maxOilSaturation_[compressedDofIdx] = std::max(maxOilSaturation_[compressedDofIdx], So);
+    }
 
-            minOilPressure_[compressedDofIdx] =
-                std::min(minOilPressure_[compressedDofIdx],
-                         Opm::getValue(fs.pressure(oilPhaseIdx)));
-        }
+    void updateMaxWaterSaturation_(unsigned compressedDofIdx, const IntensiveQuantities& iq)
+    {
+        const auto& fs = iq.fluidState();
+        Scalar Sw = Opm::decay<Scalar>(fs.saturation(waterPhaseIdx));
+        maxWaterSaturation_[compressedDofIdx] = std::max(maxWaterSaturation_[compressedDofIdx], Sw);
+    }
 
-        return true;
+    void updateMinPressure_(unsigned compressedDofIdx, const IntensiveQuantities& iq)
+    {
+        const auto& fs = iq.fluidState();
+        minOilPressure_[compressedDofIdx] =
+            std::min(minOilPressure_[compressedDofIdx],
+                     Opm::getValue(fs.pressure(oilPhaseIdx)));
     }
 
     void readRockParameters_()
@@ -2943,51 +2982,15 @@ private:
         }
     }
 
-    // update the hysteresis parameters of the material laws for the whole grid
-    bool updateHysteresis_()
-    {
-        if (!materialLawManager_->enableHysteresis())
-            return false;
-
-        // we need to update the hysteresis data for _all_ elements (i.e., not just the
-        // interior ones) to avoid desynchronization of the processes in the parallel case!
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+    // update the hysteresis parameters of the material laws of an element
+    void updateHysteresis_(unsigned compressedDofIdx, const IntensiveQuantities& iq)
+    { materialLawManager_->updateHysteresis(iq.fluidState(), compressedDofIdx); }
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            materialLawManager_->updateHysteresis(intQuants.fluidState(), compressedDofIdx);
-        }
-        return true;
-    }
-
-    void updateMaxPolymerAdsorption_()
+    void updateMaxPolymerAdsorption_(unsigned compressedDofIdx, const IntensiveQuantities& iq)
     {
-        // we need to update the max polymer adsoption data for all elements
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-
-            maxPolymerAdsorption_[compressedDofIdx] = std::max(maxPolymerAdsorption_[compressedDofIdx] , Opm::scalarValue(intQuants.polymerAdsorption()));
-        }
+        maxPolymerAdsorption_[compressedDofIdx] =
+            std::max(maxPolymerAdsorption_[compressedDofIdx],
+                     Opm::scalarValue(iq.polymerAdsorption()));
     }
 
     template<class T>
@@ -3029,36 +3032,6 @@ private:
         updateNum("PLMIXNUM", plmixnum_);
     }
 
-    struct PffDofData_
-    {
-        Opm::ConditionalStorage<enableEnergy, Scalar> thermalHalfTrans;
-        Scalar transmissibility;
-    };
-
-    // update the prefetch friendly data object
-    void updatePffDofData_()
-    {
-        const auto& distFn =
-            [this](PffDofData_& dofData,
-                   const Stencil& stencil,
-                   unsigned localDofIdx)
-            -> void
-        {
-            const auto& elementMapper = this->model().elementMapper();
-
-            unsigned globalElemIdx = elementMapper.index(stencil.entity(localDofIdx));
-            if (localDofIdx != 0) {
-                unsigned globalCenterElemIdx = elementMapper.index(stencil.entity(/*dofIdx=*/0));
-                dofData.transmissibility = transmissibilities_.transmissibility(globalCenterElemIdx, globalElemIdx);
-
-                if (enableEnergy)
-                    *dofData.thermalHalfTrans = transmissibilities_.thermalHalfTrans(globalCenterElemIdx, globalElemIdx);
-            }
-        };
-
-        pffDofData_.update(distFn);
-    }
-
     void readBoundaryConditions_()
     {
         nonTrivialBoundaryConditions_ = false;
@@ -3294,7 +3267,6 @@ private:
     bool enableEclOutput_;
     std::unique_ptr<EclWriterType> eclWriter_;
 
-    PffGridVector<GridView, Stencil, PffDofData_, DofMapper> pffDofData_;
     TracerModel tracerModel_;
 
     bool nonTrivialBoundaryConditions_;
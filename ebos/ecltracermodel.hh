@@ -38,6 +38,12 @@
 
 #include <dune/common/version.hh>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <exception>
+#include <memory>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -73,8 +79,6 @@ class EclTracerModel
     using RateVector = GetPropType<TypeTag, Properties::RateVector>;
     using Indices = GetPropType<TypeTag, Properties::Indices>;
 
-    typedef Opm::DenseAd::Evaluation<Scalar,1> TracerEvaluation;
-
     enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
     enum { numPhases = FluidSystem::numPhases };
     enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
@@ -86,6 +90,35 @@ class EclTracerModel
 
     typedef Dune::BCRSMatrix<Dune::FieldMatrix<Scalar, 1, 1>> TracerMatrix;
     typedef Dune::BlockVector<Dune::FieldVector<Scalar,1>> TracerVector;
+    typedef Dune::SeqILU< TracerMatrix, TracerVector, TracerVector  > TracerPreconditioner;
+
+    // The linearized transport equation of a tracer only depends on the flow field of
+    // the phase the tracer is associated with, not on the tracer itself. All tracers of
+    // a phase thus share a batch which holds the operator and its ILU0 factorization
+    // for the current time step, as well as the coefficients required to evaluate the
+    // residual of each of them.
+    struct TracerBatch
+    {
+        int phaseIdx;
+        std::vector<int> tracerIdx;
+
+        TracerMatrix matrix;
+        std::unique_ptr<TracerPreconditioner> preconditioner;
+
+        // storage term: phase volume of each cell at the end of the time step
+        // multiplied by the volume of the cell and divided by the time step size
+        std::vector<Scalar> storageCoeff;
+
+        // advective fluxes: the flux over face i contributes
+        // faceCoeff[i]*c[faceUpstream[i]] to the residual of cell faceCell[i]
+        std::vector<unsigned> faceCell;
+        std::vector<unsigned> faceUpstream;
+        std::vector<Scalar> faceCoeff;
+
+        // well connections which produce the phase of the batch
+        std::vector<unsigned> producerCell;
+        std::vector<Scalar> producerRate;
+    };
 
 public:
     EclTracerModel(Simulator& simulator)
@@ -173,11 +206,14 @@ public:
         // initial tracer concentration
         tracerConcentrationInitial_ = tracerConcentration_;
 
-        // residual of tracers
-        tracerResidual_.resize(numGridDof);
+        // the part of the residual of each tracer which does not depend on its current
+        // concentration
+        tracerRhs_.resize(numTracers);
+        for (auto& rhs : tracerRhs_)
+            rhs.resize(numGridDof);
 
         // allocate matrix for storing the Jacobian of the tracer residual
-        tracerMatrix_ = new TracerMatrix(numGridDof, numGridDof, TracerMatrix::random);
+        TracerMatrix tracerMatrix(numGridDof, numGridDof, TracerMatrix::random);
 
         // find the sparsity pattern of the tracer matrix
         typedef std::set<unsigned> NeighborSet;
@@ -202,8 +238,8 @@ public:
 
         // allocate space for the rows of the matrix
         for (unsigned dofIdx = 0; dofIdx < numGridDof; ++ dofIdx)
-            tracerMatrix_->setrowsize(dofIdx, neighbors[dofIdx].size());
-        tracerMatrix_->endrowsizes();
+            tracerMatrix.setrowsize(dofIdx, neighbors[dofIdx].size());
+        tracerMatrix.endrowsizes();
 
         // fill the rows with indices. each degree of freedom talks to
         // all of its neighbors. (it also talks to itself since
@@ -212,9 +248,27 @@ public:
             typename NeighborSet::iterator nIt = neighbors[dofIdx].begin();
             typename NeighborSet::iterator nEndIt = neighbors[dofIdx].end();
             for (; nIt != nEndIt; ++nIt)
-                tracerMatrix_->addindex(dofIdx, *nIt);
+                tracerMatrix.addindex(dofIdx, *nIt);
+        }
+        tracerMatrix.endindices();
+
+        // group the tracers by phase. each batch gets its own copy of the matrix.
+        batchIdx_.resize(numTracers);
+        for (unsigned tracerIdx = 0; tracerIdx < numTracers; ++tracerIdx) {
+            unsigned batchIdx = 0;
+            for (; batchIdx < batches_.size(); ++batchIdx)
+                if (batches_[batchIdx].phaseIdx == tracerPhaseIdx_[tracerIdx])
+                    break;
+
+            if (batchIdx == batches_.size()) {
+                batches_.emplace_back();
+                batches_.back().phaseIdx = tracerPhaseIdx_[tracerIdx];
+                batches_.back().matrix = tracerMatrix;
+            }
+
+            batches_[batchIdx].tracerIdx.push_back(tracerIdx);
+            batchIdx_[tracerIdx] = batchIdx;
         }
-        tracerMatrix_->endindices();
 
         const int sizeCartGrid = simulator_.vanguard().cartesianSize();
         cartToGlobal_.resize(sizeCartGrid);
@@ -283,19 +337,41 @@ public:
         if (numTracers()==0)
             return;
 
-        for (int tracerIdx = 0; tracerIdx < numTracers(); ++ tracerIdx){
-
-            TracerVector dx(tracerResidual_.size());
-            // Newton step (currently the system is linear, converge in one iteration)
-            for (int iter = 0; iter < 5; ++ iter){
-                linearize_(tracerIdx);
-                linearSolve_(*tracerMatrix_, dx, tracerResidual_);
-                tracerConcentration_[tracerIdx] -= dx;
-
-                if (dx.two_norm()<1e-2)
-                    break;
+        // the operators only depend on the flow field, so they are assembled and
+        // factorized once per time step and phase.
+        linearize_();
+#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
+        // the limits are static, hence they are set before the tracers are solved
+        // concurrently
+        Dune::FMatrixPrecision<Scalar>::set_singular_limit(1.e-30);
+        Dune::FMatrixPrecision<Scalar>::set_absolute_limit(1.e-30);
+#endif
+        for (auto& batch : batches_)
+            batch.preconditioner.reset(new TracerPreconditioner(batch.matrix, 0, 1)); // results in ILU0
+
+        // the tracers are independent of each other and are thus solved concurrently
+        std::exception_ptr exceptionPtr;
+        const int n = numTracers();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int tracerIdx = 0; tracerIdx < n; ++ tracerIdx) {
+            try {
+                solveTracer_(tracerIdx);
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                {
+                    if (!exceptionPtr)
+                        exceptionPtr = std::current_exception();
+                }
             }
         }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
     }
 
     /*!
@@ -317,74 +393,57 @@ public:
     { /* not implemented */ }
 
 protected:
-    // evaluate storage term for all tracers in a single cell
-    template <class LhsEval>
-    void computeStorage_(LhsEval& tracerStorage,
-                         const ElementContext& elemCtx,
-                         unsigned scvIdx,
-                         unsigned timeIdx,
-                         const int tracerIdx)
+    // evaluate the volume of a phase per unit of bulk volume which carries the tracer,
+    // i.e., the factor between the concentration and the storage term
+    template <class IntensiveQuantities>
+    static Scalar phaseVolume_(const IntensiveQuantities& intQuants, int phaseIdx)
     {
-        int globalDofIdx = elemCtx.globalSpaceIndex(scvIdx, timeIdx);
-
-        const auto& intQuants = elemCtx.intensiveQuantities(scvIdx, timeIdx);
         const auto& fs = intQuants.fluidState();
         Scalar phaseVolume =
-            Opm::decay<Scalar>(fs.saturation(tracerPhaseIdx_[tracerIdx]))
-            *Opm::decay<Scalar>(fs.invB(tracerPhaseIdx_[tracerIdx]))
+            Opm::decay<Scalar>(fs.saturation(phaseIdx))
+            *Opm::decay<Scalar>(fs.invB(phaseIdx))
             *Opm::decay<Scalar>(intQuants.porosity());
 
         // avoid singular matrix if no water is present.
-        phaseVolume = Opm::max(phaseVolume, 1e-10);
-
-        if (std::is_same<LhsEval, Scalar>::value)
-            tracerStorage = phaseVolume * tracerConcentrationInitial_[tracerIdx][globalDofIdx];
-        else
-            tracerStorage =
-                    phaseVolume
-                    * Opm::variable<LhsEval>(tracerConcentration_[tracerIdx][globalDofIdx][0], 0);
+        return Opm::max(phaseVolume, 1e-10);
     }
 
-    // evaluate the tracerflux over one face
-    void computeFlux_(TracerEvaluation & tracerFlux,
-                      const ElementContext& elemCtx,
-                      unsigned scvfIdx,
-                      unsigned timeIdx,
-                      const int tracerIdx)
-
+    // evaluate storage term of a tracer at the beginning of the time step in a single
+    // cell
+    void computeStorage_(Scalar& tracerStorage,
+                         const ElementContext& elemCtx,
+                         unsigned scvIdx,
+                         unsigned timeIdx,
+                         const int tracerIdx)
     {
-        const auto& stencil = elemCtx.stencil(timeIdx);
-        const auto& scvf = stencil.interiorFace(scvfIdx);
-
-        const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, timeIdx);
-        unsigned inIdx = extQuants.interiorIndex();
-
-        const int tracerPhaseIdx = tracerPhaseIdx_[tracerIdx];
-
-        unsigned upIdx = extQuants.upstreamIndex(tracerPhaseIdx);
-        int globalUpIdx = elemCtx.globalSpaceIndex(upIdx, timeIdx);
-
-        const auto& intQuants = elemCtx.intensiveQuantities(upIdx, timeIdx);
-        const auto& fs = intQuants.fluidState();
-
-        Scalar A = scvf.area();
-        Scalar v = Opm::decay<Scalar>(extQuants.volumeFlux(tracerPhaseIdx));
-        Scalar b = Opm::decay<Scalar>(fs.invB(tracerPhaseIdx_[tracerIdx]));
-        Scalar c = tracerConcentration_[tracerIdx][globalUpIdx];
+        int globalDofIdx = elemCtx.globalSpaceIndex(scvIdx, timeIdx);
 
-        if (inIdx == upIdx)
-            tracerFlux = A*v*b*Opm::variable<TracerEvaluation>(c, 0);
-        else
-            tracerFlux = A*v*b*c;
+        const auto& intQuants = elemCtx.intensiveQuantities(scvIdx, timeIdx);
+        tracerStorage =
+            phaseVolume_(intQuants, tracerPhaseIdx_[tracerIdx])
+            * tracerConcentrationInitial_[tracerIdx][globalDofIdx];
+    }
 
+    void solveTracer_(int tracerIdx)
+    {
+        const auto& batch = batches_[batchIdx_[tracerIdx]];
+        auto& concentration = tracerConcentration_[tracerIdx];
+
+        TracerVector residual(concentration.size());
+        TracerVector dx(concentration.size());
+        // Newton step (currently the system is linear, converge in one iteration)
+        for (int iter = 0; iter < 5; ++ iter){
+            computeResidual_(residual, batch, tracerIdx);
+            linearSolve_(batch, dx, residual);
+            concentration -= dx;
+
+            if (dx.two_norm()<1e-2)
+                break;
+        }
     }
 
-    bool linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b)
+    bool linearSolve_(const TracerBatch& batch, TracerVector& x, TracerVector& b) const
     {
-#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
-        Dune::FMatrixPrecision<Scalar>::set_singular_limit(1.e-30);
-        Dune::FMatrixPrecision<Scalar>::set_absolute_limit(1.e-30);
-#endif
         x = 0.0;
         Scalar tolerance = 1e-2;
         int maxIter = 100;
@@ -393,14 +452,14 @@ protected:
         typedef Dune::BiCGSTABSolver<TracerVector> TracerSolver;
         typedef Dune::MatrixAdapter<TracerMatrix, TracerVector , TracerVector > TracerOperator;
         typedef Dune::SeqScalarProduct< TracerVector > TracerScalarProduct ;
-        typedef Dune::SeqILU< TracerMatrix, TracerVector, TracerVector  > TracerPreconditioner;
 
-        TracerOperator tracerOperator(M);
+        // the operator and the factorized preconditioner are shared by all tracers of
+        // the batch. applying them does not modify them.
+        TracerOperator tracerOperator(batch.matrix);
         TracerScalarProduct tracerScalarProduct;
-        TracerPreconditioner tracerPreconditioner(M, 0, 1); // results in ILU0
 
         TracerSolver solver (tracerOperator, tracerScalarProduct,
-                             tracerPreconditioner, tolerance, maxIter,
+                             *batch.preconditioner, tolerance, maxIter,
                              verbosity);
 
         Dune::InverseOperatorResult result;
@@ -410,13 +469,42 @@ protected:
         return result.converged;
     }
 
-    void linearize_(int tracerIdx)
+    // evaluate the residual of a tracer for its current concentration
+    void computeResidual_(TracerVector& residual, const TracerBatch& batch, int tracerIdx) const
     {
-        (*tracerMatrix_) = 0.0;
-        tracerResidual_ = 0.0;
+        const auto& concentration = tracerConcentration_[tracerIdx];
+        const auto& rhs = tracerRhs_[tracerIdx];
+
+        const size_t numGridDof = concentration.size();
+        for (size_t I = 0; I < numGridDof; ++I)
+            residual[I][0] = batch.storageCoeff[I]*concentration[I][0] - rhs[I][0];
+
+        const size_t numFaces = batch.faceCell.size();
+        for (size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+            residual[batch.faceCell[faceIdx]][0] +=
+                batch.faceCoeff[faceIdx]*concentration[batch.faceUpstream[faceIdx]][0];
+
+        const size_t numProducers = batch.producerCell.size();
+        for (size_t connIdx = 0; connIdx < numProducers; ++connIdx) {
+            const unsigned I = batch.producerCell[connIdx];
+            residual[I][0] -= batch.producerRate[connIdx]*concentration[I][0];
+        }
+    }
+
+    // assemble the operators of all batches and the parts of the residuals which do
+    // not depend on the current tracer concentrations
+    void linearize_()
+    {
+        for (auto& batch : batches_) {
+            batch.matrix = 0.0;
+            batch.storageCoeff.resize(simulator_.model().numGridDof());
+            batch.faceCell.clear();
+            batch.faceUpstream.clear();
+            batch.faceCoeff.clear();
+            batch.producerCell.clear();
+            batch.producerRate.clear();
+        }
 
-        size_t numGridDof =  simulator_.model().numGridDof();
-        std::vector<double> volumes(numGridDof, 0.0);
         ElementContext elemCtx(simulator_);
         auto elemIt = simulator_.gridView().template begin</*codim=*/0>();
         auto elemEndIt = simulator_.gridView().template end</*codim=*/0>();
@@ -434,31 +522,50 @@ protected:
             Scalar dt = elemCtx.simulator().timeStepSize();
 
             size_t I = elemCtx.globalSpaceIndex(/*dofIdx=*/ 0, /*timIdx=*/0);
-            volumes[I] = scvVolume;
-            TracerEvaluation localStorage;
-            TracerEvaluation storageOfTimeIndex0;
-            Scalar storageOfTimeIndex1;
-            computeStorage_(storageOfTimeIndex0, elemCtx, 0, /*timIdx=*/0, tracerIdx);
-            if (elemCtx.enableStorageCache())
-                storageOfTimeIndex1 = storageOfTimeIndex1_[tracerIdx][I];
-            else
-                computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timIdx=*/1, tracerIdx);
-
-            localStorage = (storageOfTimeIndex0 - storageOfTimeIndex1) * scvVolume/dt;
-            tracerResidual_[I][0] += localStorage.value(); //residual + flux
-            (*tracerMatrix_)[I][I][0][0] = localStorage.derivative(0);
             size_t numInteriorFaces = elemCtx.numInteriorFaces(/*timIdx=*/0);
-            for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
-                TracerEvaluation flux;
-                const auto& face = elemCtx.stencil(0).interiorFace(scvfIdx);
-                unsigned j = face.exteriorIndex();
-                unsigned J = elemCtx.globalSpaceIndex(/*dofIdx=*/ j, /*timIdx=*/0);
-                computeFlux_(flux, elemCtx, scvfIdx, 0, tracerIdx);
-                tracerResidual_[I][0] += flux.value(); //residual + flux
-                (*tracerMatrix_)[J][I][0][0] = -flux.derivative(0);
-                (*tracerMatrix_)[I][J][0][0] = flux.derivative(0);
-            }
+            for (auto& batch : batches_) {
+                auto& M = batch.matrix;
+                const int tracerPhaseIdx = batch.phaseIdx;
+
+                batch.storageCoeff[I] =
+                    phaseVolume_(elemCtx.intensiveQuantities(/*dofIdx=*/ 0, /*timeIdx=*/0), tracerPhaseIdx)
+                    * scvVolume/dt;
+                M[I][I][0][0] = batch.storageCoeff[I];
+
+                for (int tracerIdx : batch.tracerIdx) {
+                    Scalar storageOfTimeIndex1;
+                    if (elemCtx.enableStorageCache())
+                        storageOfTimeIndex1 = storageOfTimeIndex1_[tracerIdx][I];
+                    else
+                        computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timIdx=*/1, tracerIdx);
+                    tracerRhs_[tracerIdx][I][0] = storageOfTimeIndex1 * scvVolume/dt;
+                }
 
+                for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
+                    const auto& face = elemCtx.stencil(0).interiorFace(scvfIdx);
+                    const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, /*timeIdx=*/0);
+                    unsigned j = face.exteriorIndex();
+                    unsigned J = elemCtx.globalSpaceIndex(/*dofIdx=*/ j, /*timIdx=*/0);
+                    unsigned upIdx = extQuants.upstreamIndex(tracerPhaseIdx);
+                    unsigned globalUpIdx = elemCtx.globalSpaceIndex(upIdx, /*timIdx=*/0);
+
+                    // the tracer flux over the face is faceCoeff times the
+                    // concentration of the upstream cell
+                    const auto& fs = elemCtx.intensiveQuantities(upIdx, /*timeIdx=*/0).fluidState();
+                    Scalar A = face.area();
+                    Scalar v = Opm::decay<Scalar>(extQuants.volumeFlux(tracerPhaseIdx));
+                    Scalar b = Opm::decay<Scalar>(fs.invB(tracerPhaseIdx));
+                    Scalar faceCoeff = A*v*b;
+
+                    batch.faceCell.push_back(I);
+                    batch.faceUpstream.push_back(globalUpIdx);
+                    batch.faceCoeff.push_back(faceCoeff);
+
+                    Scalar fluxDerivative = (extQuants.interiorIndex() == upIdx) ? faceCoeff : 0.0;
+                    M[J][I][0][0] = -fluxDerivative;
+                    M[I][J][0][0] = fluxDerivative;
+                }
+            }
         }
 
         // Wells
@@ -469,23 +576,36 @@ protected:
             if (well.getStatus() == Opm::Well::Status::SHUT)
                 continue;
 
-            const double wtracer = well.getTracerProperties().getConcentration(tracerNames_[tracerIdx]);
+            // looked up on the first open connection, a well with only shut
+            // connections is not part of the well model
+            decltype(simulator_.problem().wellModel().well(well.name())) wellModel;
             std::array<int, 3> cartesianCoordinate;
             for (auto& connection : well.getConnections()) {
 
                 if (connection.state() == Opm::Connection::State::SHUT)
                     continue;
 
+                if (!wellModel)
+                    wellModel = simulator_.problem().wellModel().well(well.name());
+
                 cartesianCoordinate[0] = connection.getI();
                 cartesianCoordinate[1] = connection.getJ();
                 cartesianCoordinate[2] = connection.getK();
                 const size_t cartIdx = simulator_.vanguard().cartesianIndex(cartesianCoordinate);
                 const int I = cartToGlobal_[cartIdx];
-                Scalar rate = simulator_.problem().wellModel().well(well.name())->volumetricSurfaceRateForConnection(I, tracerPhaseIdx_[tracerIdx]);
-                if (rate > 0)
-                    tracerResidual_[I][0] -= rate*wtracer;
-                else if (rate < 0)
-                    tracerResidual_[I][0] -= rate*tracerConcentration_[tracerIdx][I];
+                for (auto& batch : batches_) {
+                    Scalar rate = wellModel->volumetricSurfaceRateForConnection(I, batch.phaseIdx);
+                    if (rate > 0) {
+                        for (int tracerIdx : batch.tracerIdx) {
+                            const double wtracer = well.getTracerProperties().getConcentration(tracerNames_[tracerIdx]);
+                            tracerRhs_[tracerIdx][I][0] += rate*wtracer;
+                        }
+                    }
+                    else if (rate < 0) {
+                        batch.producerCell.push_back(I);
+                        batch.producerRate.push_back(rate);
+                    }
+                }
             }
         }
     }
@@ -496,8 +616,9 @@ protected:
     std::vector<int> tracerPhaseIdx_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> tracerConcentration_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> tracerConcentrationInitial_;
-    TracerMatrix *tracerMatrix_;
-    TracerVector tracerResidual_;
+    std::vector<TracerBatch> batches_;
+    std::vector<unsigned> batchIdx_;
+    std::vector<TracerVector> tracerRhs_;
     std::vector<int> cartToGlobal_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> storageOfTimeIndex1_;
 
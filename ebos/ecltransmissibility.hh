@@ -52,6 +52,9 @@
 #include <dune/common/fmatrix.hh>
 
 #include <array>
+#include <cassert>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
@@ -141,6 +144,11 @@ public:
 
         const std::vector<double>& centroids = vanguard_.cellCentroids();
 
+        // the number of interior and boundary intersections of each element. these
+        // determine the layout of the compressed face tables.
+        faceOffsets_.assign(numElements + 1, 0);
+        boundaryFaceOffsets_.assign(numElements + 1, 0);
+
         auto elemIt = gridView.template begin</*codim=*/ 0>();
         const auto& elemEndIt = gridView.template end</*codim=*/ 0>();
         size_t centroidIdx = 0;
@@ -148,6 +156,16 @@ public:
             const auto& elem = *elemIt;
             unsigned elemIdx = elemMapper.index(elem);
 
+            auto isIt = gridView.ibegin(elem);
+            const auto& isEndIt = gridView.iend(elem);
+            for (; isIt != isEndIt; ++ isIt) {
+                const auto& intersection = *isIt;
+                if (intersection.boundary())
+                    ++ boundaryFaceOffsets_[elemIdx + 1];
+                else if (intersection.neighbor())
+                    ++ faceOffsets_[elemIdx + 1];
+            }
+
             // compute the axis specific "centroids" used for the transmissibilities. for
             // consistency with the flow simulator, we use the element centers as
             // computed by opm-parser's Opm::EclipseGrid class for all axes.
@@ -166,23 +184,28 @@ public:
                     axisCentroids[axisIdx][elemIdx][dimIdx] = centroid[dimIdx];
         }
 
-        // reserving some space in the hashmap upfront saves quite a bit of time because
-        // resizes are costly for hashmaps and there would be quite a few of them if we
-        // would not have a rough idea of how large the final map will be (the rough idea
-        // is a conforming Cartesian grid).
-        trans_.clear();
-        trans_.reserve(numElements*3*1.05);
-
-        transBoundary_.clear();
+        // convert the per-element intersection counts to offsets into the face tables
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            faceOffsets_[elemIdx + 1] += faceOffsets_[elemIdx];
+            boundaryFaceOffsets_[elemIdx + 1] += boundaryFaceOffsets_[elemIdx];
+        }
 
-        // if energy is enabled, let's do the same for the "thermal half transmissibilities"
+        faceNeighbors_.resize(faceOffsets_[numElements]);
+        faceTrans_.resize(faceOffsets_[numElements]);
+        boundaryFaceTrans_.resize(boundaryFaceOffsets_[numElements]);
         if (enableEnergy) {
-            thermalHalfTrans_->clear();
-            thermalHalfTrans_->reserve(numElements*6*1.05);
-
-            thermalHalfTransBoundary_.clear();
+            faceThermalHalfTrans_->resize(faceOffsets_[numElements]);
+            boundaryFaceThermalHalfTrans_->resize(boundaryFaceOffsets_[numElements]);
         }
 
+        // the hashmap is only used to assemble the transmissibilities of the
+        // connections. reserving some space in it upfront saves quite a bit of time
+        // because resizes are costly for hashmaps and there would be quite a few of them
+        // if we would not have a rough idea of how large the final map will be (the rough
+        // idea is a conforming Cartesian grid).
+        trans_.clear();
+        trans_.reserve(numElements*3*1.05);
+
         // The MULTZ needs special case if the option is ALL
         // Then the smallest multiplier is applied.
         // Default is to apply the top and bottom multiplier
@@ -204,6 +227,7 @@ public:
             auto isIt = gridView.ibegin(elem);
             const auto& isEndIt = gridView.iend(elem);
             unsigned boundaryIsIdx = 0;
+            unsigned neighborIsIdx = 0;
             for (; isIt != isEndIt; ++ isIt) {
                 // store intersection, this might be costly
                 const auto& intersection = *isIt;
@@ -230,7 +254,8 @@ public:
                     // normally there would be two half-transmissibilities that would be
                     // averaged. on the grid boundary there only is the half
                     // transmissibility of the interior element.
-                    transBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] = transBoundaryIs;
+                    const std::size_t boundaryFaceIdx = boundaryFaceOffsets_[elemIdx] + boundaryIsIdx;
+                    boundaryFaceTrans_[boundaryFaceIdx] = transBoundaryIs;
 
                     // for boundary intersections we also need to compute the thermal
                     // half transmissibilities
@@ -244,8 +269,7 @@ public:
                         // the transmissibility with the face area here
                         Scalar thermalHalfTrans = std::abs(n*d)/(d*d);
 
-                        thermalHalfTransBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] =
-                            thermalHalfTrans;
+                        (*boundaryFaceThermalHalfTrans_)[boundaryFaceIdx] = thermalHalfTrans;
                     }
 
                     ++ boundaryIsIdx;
@@ -260,6 +284,10 @@ public:
                 const auto& outsideElem = intersection.outside();
                 unsigned outsideElemIdx = elemMapper.index(outsideElem);
 
+                const std::size_t faceIdx = faceOffsets_[elemIdx] + neighborIsIdx;
+                faceNeighbors_[faceIdx] = outsideElemIdx;
+                ++ neighborIsIdx;
+
                 // update the "thermal half transmissibility" for the intersection
                 if (enableEnergy) {
                     const auto& n = intersection.centerUnitOuterNormal();
@@ -269,8 +297,7 @@ public:
                     const auto& outPos = intersection.geometry().center();
                     const auto& d = outPos - inPos;
 
-                    (*thermalHalfTrans_)[directionalIsId_(elemIdx, outsideElemIdx)] =
-                        A * (n*d)/(d*d);
+                    (*faceThermalHalfTrans_)[faceIdx] = A * (n*d)/(d*d);
                 }
 
                 // we only need to calculate a face's transmissibility
@@ -402,6 +429,14 @@ public:
 
         //remove very small non-neighbouring transmissibilities
         removeSmallNonCartesianTransmissibilities_();
+
+        // move the transmissibilities of the connections to the face table and release
+        // the memory occupied by the hashmap.
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx)
+            for (std::size_t faceIdx = faceOffsets_[elemIdx]; faceIdx < faceOffsets_[elemIdx + 1]; ++faceIdx)
+                faceTrans_[faceIdx] = trans_.at(isId_(elemIdx, faceNeighbors_[faceIdx]));
+
+        std::unordered_map<std::uint64_t, Scalar>().swap(trans_);
     }
 
     /*!
@@ -412,15 +447,52 @@ public:
 
     /*!
      * \brief Return the transmissibility for the intersection between two elements.
+     *
+     * This requires a search in the neighbors of the first element. If the position of
+     * the intersection within the element is known, faceTransmissibility() is cheaper.
      */
     Scalar transmissibility(unsigned elemIdx1, unsigned elemIdx2) const
-    { return trans_.at(isId_(elemIdx1, elemIdx2)); }
+    { return faceTrans_[faceIndex_(elemIdx1, elemIdx2)]; }
+
+    /*!
+     * \brief Return the transmissibility for an interior intersection of an element.
+     *
+     * The interior intersections of an element are numbered in the order in which they
+     * are visited by the grid view's intersection iterator, i.e., neighborIdx is the
+     * index of the neighbor in the element's stencil minus one.
+     */
+    Scalar faceTransmissibility(unsigned elemIdx, unsigned neighborIdx) const
+    {
+        assert(faceOffsets_[elemIdx] + neighborIdx < faceOffsets_[elemIdx + 1]);
+        return faceTrans_[faceOffsets_[elemIdx] + neighborIdx];
+    }
+
+    /*!
+     * \brief Return the index of the element on the other side of an interior
+     *        intersection of an element.
+     *
+     * The neighbors are numbered the same way as for faceTransmissibility().
+     */
+    unsigned faceNeighbor(unsigned elemIdx, unsigned neighborIdx) const
+    {
+        assert(faceOffsets_[elemIdx] + neighborIdx < faceOffsets_[elemIdx + 1]);
+        return faceNeighbors_[faceOffsets_[elemIdx] + neighborIdx];
+    }
+
+    /*!
+     * \brief Return the number of interior intersections of an element.
+     */
+    unsigned numNeighbors(unsigned elemIdx) const
+    { return faceOffsets_[elemIdx + 1] - faceOffsets_[elemIdx]; }
 
     /*!
      * \brief Return the transmissibility for a given boundary segment.
      */
     Scalar transmissibilityBoundary(unsigned elemIdx, unsigned boundaryFaceIdx) const
-    { return transBoundary_.at(std::make_pair(elemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryFaceOffsets_[elemIdx] + boundaryFaceIdx < boundaryFaceOffsets_[elemIdx + 1]);
+        return boundaryFaceTrans_[boundaryFaceOffsets_[elemIdx] + boundaryFaceIdx];
+    }
 
     /*!
      * \brief Return the thermal "half transmissibility" for the intersection between two
@@ -437,10 +509,25 @@ public:
      * cell and the center of the intersection.
      */
     Scalar thermalHalfTrans(unsigned insideElemIdx, unsigned outsideElemIdx) const
-    { return thermalHalfTrans_->at(directionalIsId_(insideElemIdx, outsideElemIdx)); }
+    { return (*faceThermalHalfTrans_)[faceIndex_(insideElemIdx, outsideElemIdx)]; }
+
+    /*!
+     * \brief Return the thermal "half transmissibility" for an interior intersection
+     *        of an element.
+     *
+     * The neighbors are numbered the same way as for faceTransmissibility().
+     */
+    Scalar faceThermalHalfTrans(unsigned insideElemIdx, unsigned neighborIdx) const
+    {
+        assert(faceOffsets_[insideElemIdx] + neighborIdx < faceOffsets_[insideElemIdx + 1]);
+        return (*faceThermalHalfTrans_)[faceOffsets_[insideElemIdx] + neighborIdx];
+    }
 
     Scalar thermalHalfTransBoundary(unsigned insideElemIdx, unsigned boundaryFaceIdx) const
-    { return thermalHalfTransBoundary_.at(std::make_pair(insideElemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryFaceOffsets_[insideElemIdx] + boundaryFaceIdx < boundaryFaceOffsets_[insideElemIdx + 1]);
+        return (*boundaryFaceThermalHalfTrans_)[boundaryFaceOffsets_[insideElemIdx] + boundaryFaceIdx];
+    }
 
 private:
 
@@ -759,9 +846,16 @@ private:
         return std::make_pair(elemAIdx, elemBIdx);
     }
 
-    std::uint64_t directionalIsId_(std::uint32_t elemIdx1, std::uint32_t elemIdx2) const
+    std::size_t faceIndex_(unsigned elemIdx1, unsigned elemIdx2) const
     {
-        return (std::uint64_t(elemIdx1)<<elemIdxShift) + elemIdx2;
+        // the number of neighbors of an element is small, so a linear search is
+        // typically faster than anything more fancy
+        for (std::size_t faceIdx = faceOffsets_[elemIdx1]; faceIdx < faceOffsets_[elemIdx1 + 1]; ++faceIdx)
+            if (faceNeighbors_[faceIdx] == elemIdx2)
+                return faceIdx;
+
+        throw std::out_of_range("Elements " + std::to_string(elemIdx1) + " and "
+                                + std::to_string(elemIdx2) + " are not connected");
     }
 
     void computeHalfTrans_(Scalar& halfTrans,
@@ -859,11 +953,22 @@ private:
     const Vanguard& vanguard_;
     Scalar transmissibilityThreshold_;
     std::vector<DimMatrix> permeability_;
+
+    // transmissibilities of all connections. this is only used while the
+    // transmissibilities are computed and is empty afterwards.
     std::unordered_map<std::uint64_t, Scalar> trans_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> transBoundary_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> thermalHalfTransBoundary_;
-    Opm::ConditionalStorage<enableEnergy,
-                            std::unordered_map<std::uint64_t, Scalar> > thermalHalfTrans_;
+
+    // the face tables: the interior (boundary) intersections of element i are stored at
+    // the positions [faceOffsets_[i], faceOffsets_[i + 1]) ([boundaryFaceOffsets_[i],
+    // boundaryFaceOffsets_[i + 1])) in the order of the element's intersections.
+    std::vector<std::size_t> faceOffsets_;
+    std::vector<std::uint32_t> faceNeighbors_;
+    std::vector<Scalar> faceTrans_;
+    Opm::ConditionalStorage<enableEnergy, std::vector<Scalar> > faceThermalHalfTrans_;
+
+    std::vector<std::size_t> boundaryFaceOffsets_;
+    std::vector<Scalar> boundaryFaceTrans_;
+    Opm::ConditionalStorage<enableEnergy, std::vector<Scalar> > boundaryFaceThermalHalfTrans_;
 };
 
 } // namespace Opm
@@ -51,6 +51,8 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/UDQ/UDQState.hpp>
 
 #include <opm/simulators/utils/ParallelRestart.hpp>
+#include <opm/simulators/utils/PartitionedRestart.hpp>
+#include <opm/simulators/timestepping/PhaseTimer.hpp>
 #include <opm/grid/GridHelpers.hpp>
 #include <opm/grid/utility/cartesianToCompressed.hpp>
 
@@ -59,10 +61,14 @@
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <algorithm>
 #include <list>
+#include <optional>
+#include <tuple>
 #include <utility>
 #include <string>
 #include <chrono>
+#include <vector>
 
 #ifdef HAVE_MPI
 #include <mpi.h>
@@ -82,6 +88,14 @@ template<class TypeTag, class MyTypeTag>
 struct EclOutputDoublePrecision {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct EclOutputFromIntensiveQuantityCache {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct EclOutputPartitionedRestart {
+    using type = UndefinedProperty;
+};
 
 } // namespace Opm::Properties
 
@@ -186,6 +200,10 @@ public:
 
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncEclOutput,
                              "Write the ECL-formated results in a non-blocking way (i.e., using a separate thread).");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EclOutputFromIntensiveQuantityCache,
+                             "Extract the ECL cell output from the intensive quantities cached by the last linearization instead of recomputing them.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EclOutputPartitionedRestart,
+                             "Let every process write the cell data of its partition to a restart file of its own instead of gathering it on the I/O rank. The partitions can be merged using flow_merge_restart.");
     }
 
     // The Simulator object should preferably have been const - the
@@ -210,6 +228,9 @@ public:
         if (enableAsyncOutput && collectToIORank_.isIORank())
             numWorkerThreads = 1;
         taskletRunner_.reset(new TaskletRunner(numWorkerThreads));
+
+        outputFromIntensiveQuantityCache_ = EWOMS_GET_PARAM(TypeTag, bool, EclOutputFromIntensiveQuantityCache);
+        partitionedRestart_ = EWOMS_GET_PARAM(TypeTag, bool, EclOutputPartitionedRestart);
     }
 
     ~EclWriter()
@@ -226,6 +247,12 @@ public:
         return simulator_.vanguard().equilGrid();
     }
 
+    /// Return the timings of gathering and writing the output since the last call.
+    Opm::PhaseTimings takeOutputTimings()
+    {
+        return std::exchange(this->outputTimings_, Opm::PhaseTimings{});
+    }
+
     void writeInit()
     {
         if (collectToIORank_.isIORank()) {
@@ -277,9 +304,11 @@ public:
 
         this->prepareLocalCellData(isSubStep, reportStepNum);
 
-        if (collectToIORank_.isParallel())
+        if (collectToIORank_.isParallel()) {
+            Opm::PhaseTimer gatherTimer(this->outputTimings_, "output/gather");
             collectToIORank_.collect({}, eclOutputModule_.getBlockData(),
                                      localWellData, localGroupData);
+        }
 
         std::map<std::string, double> miscSummaryData;
         std::map<std::string, std::vector<double>> regionData;
@@ -353,7 +382,11 @@ public:
     {
         const int reportStepNum = simulator_.episodeIndex() + 1;
 
-        this->prepareLocalCellData(isSubStep, reportStepNum);
+        // the cell data has usually been prepared by evalSummaryState() for the same
+        // solution already
+        if (this->preparedCellData_ != this->cellDataKey_(isSubStep, reportStepNum))
+            this->prepareLocalCellData(isSubStep, reportStepNum);
+        this->preparedCellData_.reset();
         this->eclOutputModule_.outputErrorLog();
 
         // output using eclWriter if enabled
@@ -369,10 +402,24 @@ public:
         }
 
         if (collectToIORank_.isParallel()) {
+            // if every rank writes its own part of the restart cell data, only the
+            // well, group and block data needs to be gathered on the I/O rank
+            if (this->writeRestartPartition_(isSubStep, reportStepNum, localCellData)) {
+                this->eclOutputModule_.recycleBuffers(localCellData);
+                localCellData = {};
+            }
+
+            Opm::PhaseTimer gatherTimer(this->outputTimings_, "output/gather");
             collectToIORank_.collect(localCellData, eclOutputModule_.getBlockData(), localWellData, localGroupData);
+            gatherTimer.stop();
+
+            // the local cell data has been gathered, its storage can be reused
+            this->eclOutputModule_.recycleBuffers(localCellData);
         }
 
         if (this->collectToIORank_.isIORank()) {
+            // with asynchronous output this is the time to wait for the previous write
+            Opm::PhaseTimer writeTimer(this->outputTimings_, "output/write");
             this->writeOutput(reportStepNum, isSubStep,
                               std::move(localCellData),
                               std::move(localWellData),
@@ -666,6 +713,8 @@ private:
         double secondsElapsed_;
         Opm::RestartValue restartValue_;
         bool writeDoublePrecision_;
+        // receives the cell data buffers after writing, may be null
+        EclOutputBlackOilModule<TypeTag>* outputModule_;
 
         explicit EclWriteTasklet(const Opm::Action::State& actionState,
                                  const Opm::SummaryState& summaryState,
@@ -675,7 +724,8 @@ private:
                                  bool isSubStep,
                                  double secondsElapsed,
                                  Opm::RestartValue restartValue,
-                                 bool writeDoublePrecision)
+                                 bool writeDoublePrecision,
+                                 EclOutputBlackOilModule<TypeTag>* outputModule)
             : actionState_(actionState)
             , summaryState_(summaryState)
             , udqState_(udqState)
@@ -683,8 +733,9 @@ private:
             , reportStepNum_(reportStepNum)
             , isSubStep_(isSubStep)
             , secondsElapsed_(secondsElapsed)
-            , restartValue_(restartValue)
+            , restartValue_(std::move(restartValue))
             , writeDoublePrecision_(writeDoublePrecision)
+            , outputModule_(outputModule)
         { }
 
         // callback to eclIO serial writeTimeStep method
@@ -698,6 +749,9 @@ private:
                                  secondsElapsed_,
                                  restartValue_,
                                  writeDoublePrecision_);
+
+            if (outputModule_)
+                outputModule_->recycleBuffers(restartValue_.solution);
         }
     };
 
@@ -725,6 +779,10 @@ private:
 
         eclOutputModule_.allocBuffers(numElements, reportStepNum,
                                       isSubStep, log, /*isRestart*/ false);
+        preparedCellData_ = cellDataKey_(isSubStep, reportStepNum);
+
+        if (outputFromIntensiveQuantityCache_ && eclOutputModule_.processCachedIntensiveQuantities())
+            return;
 
         ElementContext elemCtx(simulator_);
         ElementIterator elemIt = gridView.template begin</*codim=*/0>();
@@ -776,7 +834,9 @@ private:
         auto eclWriteTasklet = std::make_shared<EclWriteTasklet>(
             this->actionState(), this->summaryState(), this->udqState(), *this->eclIO_,
             reportStepNum, isSubStep, curTime, std::move(restartValue),
-            EWOMS_GET_PARAM(TypeTag, bool, EclOutputDoublePrecision)
+            EWOMS_GET_PARAM(TypeTag, bool, EclOutputDoublePrecision),
+            // the global cell data of parallel runs is larger than the local buffers
+            isParallel ? nullptr : &this->eclOutputModule_
             );
 
         // then, make sure that the previous I/O request has been completed
@@ -788,12 +848,61 @@ private:
         this->taskletRunner_->dispatch(std::move(eclWriteTasklet));
     }
 
+    bool writeRestartPartition_(const bool isSubStep,
+                                const int reportStepNum,
+                                const Opm::data::Solution& localCellData)
+    {
+        if (!partitionedRestart_ || isSubStep ||
+            !schedule().restart().getWriteRestartFile(reportStepNum, /*log=*/false))
+            return false;
+
+        const auto& comm = simulator_.gridView().comm();
+        if (numGlobalCells_ < 0) {
+            const int numElements = simulator_.vanguard().gridView().size(/*codim=*/0);
+            partitionGlobalIndex_.resize(numElements);
+            int maxGlobalIdx = -1;
+            for (int elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+                partitionGlobalIndex_[elemIdx] = collectToIORank_.localIdxToGlobalIdx(elemIdx);
+                maxGlobalIdx = std::max(maxGlobalIdx, partitionGlobalIndex_[elemIdx]);
+            }
+            numGlobalCells_ = comm.max(maxGlobalIdx) + 1;
+        }
+
+        const auto& eclState = simulator_.vanguard().eclState();
+        const auto& ioConfig = eclState.getIOConfig();
+        Opm::PhaseTimer writeTimer(this->outputTimings_, "output/write");
+        Opm::writeRestartPartition(Opm::restartPartitionFileName(ioConfig.getOutputDir(),
+                                                                 ioConfig.getBaseName(),
+                                                                 comm.rank(),
+                                                                 reportStepNum),
+                                   comm.rank(), comm.size(), reportStepNum,
+                                   numGlobalCells_, partitionGlobalIndex_,
+                                   localCellData, eclState.getUnits(),
+                                   EWOMS_GET_PARAM(TypeTag, bool, EclOutputDoublePrecision));
+        return true;
+    }
+
+    // identifies the solution for which the cell output buffers have been prepared
+    using CellDataKey = std::tuple<Scalar, Scalar, int, int, bool>;
+
+    CellDataKey cellDataKey_(const bool isSubStep, const int reportStepNum) const
+    {
+        return CellDataKey{simulator_.time(), simulator_.timeStepSize(),
+                           simulator_.timeStepIndex(), reportStepNum, isSubStep};
+    }
+
     Simulator& simulator_;
     CollectDataToIORankType collectToIORank_;
     EclOutputBlackOilModule<TypeTag> eclOutputModule_;
     std::unique_ptr<Opm::EclipseIO> eclIO_;
     std::unique_ptr<TaskletRunner> taskletRunner_;
     Scalar restartTimeStepSize_;
+    bool outputFromIntensiveQuantityCache_;
+    bool partitionedRestart_;
+    int numGlobalCells_ = -1;
+    std::vector<int> partitionGlobalIndex_;
+    std::optional<CellDataKey> preparedCellData_;
+    Opm::PhaseTimings outputTimings_;
 };
 } // namespace Opm
 
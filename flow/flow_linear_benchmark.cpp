@@ -0,0 +1,255 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+
+#include <opm/common/utility/FileSystem.hpp>
+#include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/SystemSnapshot.hpp>
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+    const std::string matrixTag = "matrix_istl";
+    const std::string rhsTag = "rhs_istl";
+
+    struct Snapshot
+    {
+        std::string matrixFile;
+        std::string rhsFile;
+    };
+
+    struct BenchmarkResult
+    {
+        double readTime = 0.0;
+        double setupTime = 0.0;
+        double applyTime = 0.0;
+        int iterations = 0;
+        bool converged = false;
+        double matrixMemory = 0.0;
+    };
+
+    bool isMatrixFile(const std::string& fileName)
+    {
+        const auto pos = fileName.rfind(matrixTag);
+        if (pos == std::string::npos)
+            return false;
+        const auto extension = fileName.substr(pos + matrixTag.size());
+        return extension == ".mm" || extension == Opm::Helper::binarySnapshotExtension;
+    }
+
+    // the snapshots written by Helper::writeSystem() are named
+    // <prefix>matrix_istl.mm and <prefix>rhs_istl.mm
+    Snapshot makeSnapshot(const std::string& matrixFile)
+    {
+        Snapshot snapshot{matrixFile, matrixFile};
+        const auto pos = matrixFile.rfind(matrixTag);
+        snapshot.rhsFile.replace(pos, matrixTag.size(), rhsTag);
+        return snapshot;
+    }
+
+    std::vector<Snapshot> findSnapshots(const std::vector<std::string>& paths)
+    {
+        namespace fs = Opm::filesystem;
+        std::vector<Snapshot> snapshots;
+        for (const auto& path : paths) {
+            if (!fs::is_directory(path)) {
+                if (!isMatrixFile(path))
+                    throw std::runtime_error(path + " is not a matrix snapshot");
+                snapshots.push_back(makeSnapshot(path));
+                continue;
+            }
+
+            std::vector<std::string> files;
+            for (const auto& entry : fs::directory_iterator(path)) {
+                if (isMatrixFile(entry.path().string()))
+                    files.push_back(entry.path().string());
+            }
+            std::sort(files.begin(), files.end());
+            for (const auto& file : files)
+                snapshots.push_back(makeSnapshot(file));
+        }
+        return snapshots;
+    }
+
+    double peakMemoryMB()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss / 1024.0; // kB on Linux
+    }
+
+    template <int bz>
+    BenchmarkResult runSnapshot(const Snapshot& snapshot,
+                                const boost::property_tree::ptree& prm,
+                                const bool convert)
+    {
+        using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+        using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+        BenchmarkResult result;
+        Dune::Timer timer;
+
+        Matrix matrix;
+        Vector rhs;
+        timer.start();
+        Opm::Helper::readSystem(snapshot.matrixFile, snapshot.rhsFile, matrix, rhs);
+        result.readTime = timer.stop();
+        result.matrixMemory = (matrix.nonzeroes() * (sizeof(typename Matrix::block_type) + sizeof(typename Matrix::size_type))
+                               + matrix.N() * sizeof(typename Matrix::row_type)) / (1024.0 * 1024.0);
+
+        if (convert) {
+            auto binaryFile = snapshot.matrixFile;
+            binaryFile.replace(binaryFile.rfind(matrixTag), std::string::npos, matrixTag + Opm::Helper::binarySnapshotExtension);
+            if (binaryFile != snapshot.matrixFile)
+                Opm::Helper::writeBinarySystem(binaryFile, matrix, rhs);
+        }
+
+        // the true-IMPES weights need the reservoir state, the quasi-IMPES weights
+        // are used for both CPR variants
+        std::function<Vector()> weightsCalculator;
+        const auto preconditionerType = prm.get<std::string>("preconditioner.type", "cpr");
+        if (preconditionerType == "cpr" || preconditionerType == "cprt") {
+            const bool transpose = preconditionerType == "cprt";
+            const int pressureIndex = prm.get<int>("preconditioner.pressure_var_index", 1);
+            weightsCalculator = [&matrix, pressureIndex, transpose]() {
+                return Opm::Amg::getQuasiImpesWeights<Matrix, Vector>(matrix, pressureIndex, transpose);
+            };
+        }
+
+        using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+        Operator op(matrix);
+        timer.reset();
+        timer.start();
+        Dune::FlexibleSolver<Matrix, Vector> solver(op, prm, weightsCalculator);
+        result.setupTime = timer.stop();
+
+        Vector x(rhs.size());
+        x = 0.0;
+        Dune::InverseOperatorResult res;
+        timer.reset();
+        timer.start();
+        solver.apply(x, rhs, res);
+        result.applyTime = timer.stop();
+        result.iterations = res.iterations;
+        result.converged = res.converged;
+        return result;
+    }
+
+    BenchmarkResult runSnapshot(const Snapshot& snapshot,
+                                const boost::property_tree::ptree& prm,
+                                const bool convert)
+    {
+        const int blockSize = Opm::Helper::snapshotBlockSize(snapshot.matrixFile);
+        switch (blockSize) {
+        case 1: return runSnapshot<1>(snapshot, prm, convert);
+        case 2: return runSnapshot<2>(snapshot, prm, convert);
+        case 3: return runSnapshot<3>(snapshot, prm, convert);
+        case 4: return runSnapshot<4>(snapshot, prm, convert);
+        default:
+            throw std::runtime_error("Block size " + std::to_string(blockSize) + " of "
+                                     + snapshot.matrixFile + " is not supported");
+        }
+    }
+
+} // anonymous namespace
+
+// Run a FlexibleSolver configuration over the linear systems written by flow with
+// --linear-solver-verbosity > 10, to tune the linear solver without the simulator.
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    const auto convertArg = std::find(args.begin(), args.end(), "--convert");
+    const bool convert = convertArg != args.end();
+    if (convert)
+        args.erase(convertArg);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--convert] CONFIG.json SNAPSHOT...\n\n"
+                  << "CONFIG.json is a linear solver configuration as for --linear-solver-configuration-json-file.\n"
+                  << "A SNAPSHOT is a directory or a file <prefix>matrix_istl.mm as written by flow, the rhs is\n"
+                  << "read from <prefix>rhs_istl.mm. Binary snapshots <prefix>matrix_istl.bcsr are read much faster,\n"
+                  << "with --convert a binary snapshot is written for every Matrix Market snapshot.\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        boost::property_tree::ptree prm;
+        boost::property_tree::read_json(args[0], prm);
+
+        const auto snapshots = findSnapshots({args.begin() + 1, args.end()});
+        if (snapshots.empty())
+            throw std::runtime_error("No snapshots found");
+
+        std::cout << std::left << std::setw(60) << "snapshot" << std::right
+                  << std::setw(10) << "read (s)" << std::setw(10) << "setup (s)"
+                  << std::setw(10) << "apply (s)" << std::setw(8) << "its"
+                  << std::setw(6) << "conv" << std::setw(12) << "matrix (MB)" << '\n';
+
+        BenchmarkResult total;
+        int numConverged = 0;
+        for (const auto& snapshot : snapshots) {
+            const auto result = runSnapshot(snapshot, prm, convert);
+            std::cout << std::left << std::setw(60) << Opm::filesystem::path(snapshot.matrixFile).filename().string()
+                      << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(10) << result.readTime << std::setw(10) << result.setupTime
+                      << std::setw(10) << result.applyTime << std::setw(8) << result.iterations
+                      << std::setw(6) << (result.converged ? "yes" : "no")
+                      << std::setw(12) << result.matrixMemory << '\n';
+
+            total.readTime += result.readTime;
+            total.setupTime += result.setupTime;
+            total.applyTime += result.applyTime;
+            total.iterations += result.iterations;
+            numConverged += result.converged;
+        }
+
+        std::cout << "\nSnapshots: " << snapshots.size() << " (" << numConverged << " converged)\n"
+                  << "Total read time:  " << total.readTime << " s\n"
+                  << "Total setup time: " << total.setupTime << " s\n"
+                  << "Total apply time: " << total.applyTime << " s\n"
+                  << "Total iterations: " << total.iterations << '\n'
+                  << "Peak memory:      " << peakMemoryMB() << " MB\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "The benchmark failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
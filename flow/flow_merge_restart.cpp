@@ -0,0 +1,61 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+
+#include <opm/common/utility/FileSystem.hpp>
+#include <opm/simulators/utils/PartitionedRestart.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+// Merge the restart partitions written with --ecl-output-partitioned-restart=true
+// into a restart file which contains the cell data of the whole grid.
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " RESTART_FILE [OUTPUT_FILE]\n\n"
+                  << "RESTART_FILE is the restart file written by the I/O rank (e.g. CASE.UNRST or CASE.X0012),\n"
+                  << "the partitions CASE_P<rank>.X<report step> are expected in the same directory.\n"
+                  << "The merged file is written to OUTPUT_FILE, by default to CASE_MERGED with the\n"
+                  << "extension of RESTART_FILE.\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::string restartFile = argv[1];
+    std::string outputFile;
+    if (argc == 3) {
+        outputFile = argv[2];
+    }
+    else {
+        const Opm::filesystem::path path(restartFile);
+        outputFile = (path.parent_path() / (path.stem().string() + "_MERGED" + path.extension().string())).string();
+    }
+
+    try {
+        Opm::mergeRestartPartitions(restartFile, outputFile);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Merging the restart partitions failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
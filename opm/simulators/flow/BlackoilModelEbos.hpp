@@ -38,6 +38,7 @@
 
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
+#include <opm/simulators/timestepping/PhaseTimer.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 #include <opm/common/ErrorMacros.hpp>
@@ -61,8 +62,13 @@
 #include <dune/common/timer.hh>
 #include <dune/common/unused.hh>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <cassert>
 #include <cmath>
+#include <exception>
 #include <iostream>
 #include <iomanip>
 #include <limits>
@@ -156,6 +162,9 @@ namespace Opm {
         using Simulator = GetPropType<TypeTag, Properties::Simulator>;
         using Grid = GetPropType<TypeTag, Properties::Grid>;
         using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+        using GridView = GetPropType<TypeTag, Properties::GridView>;
+        using Element = typename GridView::template Codim<0>::Entity;
+        using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
         using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
         using SolutionVector = GetPropType<TypeTag, Properties::SolutionVector>;
         using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
@@ -249,6 +258,7 @@ namespace Opm {
             ebosSimulator_.setTime(timer.simulationTimeElapsed());
             ebosSimulator_.setTimeStepSize(timer.currentStepLength());
             ebosSimulator_.problem().beginTimeStep();
+            relChangeUpToDate_ = false;
 
             unsigned numDof = ebosSimulator_.model().numGridDof();
             wasSwitched_.resize(numDof);
@@ -308,6 +318,7 @@ namespace Opm {
             perfTimer.start();
             // the step is not considered converged until at least minIter iterations is done
             {
+                PhaseTimer convergenceTimer(report.phase_timings, "convergence");
                 auto convrep = getConvergence(timer, iteration,residual_norms);
                 report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
                 ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
@@ -336,21 +347,27 @@ namespace Opm {
 
                 // apply the Schur compliment of the well model to the reservoir linearized
                 // equations
-                wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
-                                      ebosSimulator().model().linearizer().residual());
+                {
+                    PhaseTimer wellTimer(report.phase_timings, "linear/wells");
+                    wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
+                                          ebosSimulator().model().linearizer().residual());
+                }
 
                 // Solve the linear system.
                 linear_solve_setup_time_ = 0.0;
+                linear_solve_timings_.clear();
                 try {
                     solveJacobianSystem(x);
                     report.linear_solve_setup_time += linear_solve_setup_time_;
                     report.linear_solve_time += perfTimer.stop();
                     report.total_linear_iterations += linearIterationsLastSolve();
+                    addPhaseTimings(report.phase_timings, linear_solve_timings_);
                 }
                 catch (...) {
                     report.linear_solve_setup_time += linear_solve_setup_time_;
                     report.linear_solve_time += perfTimer.stop();
                     report.total_linear_iterations += linearIterationsLastSolve();
+                    addPhaseTimings(report.phase_timings, linear_solve_timings_);
 
                     failureReport_ += report;
                     throw; // re-throw up
@@ -362,7 +379,10 @@ namespace Opm {
                 // handling well state update before oscillation treatment is a decision based
                 // on observation to avoid some big performance degeneration under some circumstances.
                 // there is no theorectical explanation which way is better for sure.
-                wellModel().postSolve(x);
+                {
+                    PhaseTimer wellTimer(report.phase_timings, "update/wells");
+                    wellModel().postSolve(x);
+                }
 
                 if (param_.use_update_stabilization_) {
                     // Stabilize the nonlinear update.
@@ -383,7 +403,10 @@ namespace Opm {
 
                 // Apply the update, with considering model-dependent limitations and
                 // chopping of the update.
-                updateSolution(x);
+                {
+                    PhaseTimer updateTimer(report.phase_timings, "update/solution");
+                    updateSolution(x);
+                }
 
                 report.update_time += perfTimer.stop();
             }
@@ -413,91 +436,49 @@ namespace Opm {
         SimulatorReportSingle assembleReservoir(const SimulatorTimerInterface& /* timer */,
                                                 const int iterationIdx)
         {
+            SimulatorReportSingle report;
+
             // -------- Mass balance equations --------
             ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
-            ebosSimulator_.problem().beginIteration();
-            ebosSimulator_.model().linearizer().linearizeDomain();
+            {
+                // the wells are assembled when the iteration begins
+                PhaseTimer wellTimer(report.phase_timings, "assembly/wells");
+                ebosSimulator_.problem().beginIteration();
+            }
+            {
+                // includes the update of the intensive quantities of the cells
+                PhaseTimer reservoirTimer(report.phase_timings, "assembly/reservoir");
+                ebosSimulator_.model().linearizer().linearizeDomain();
+            }
             ebosSimulator_.problem().endIteration();
 
-            return wellModel().lastReport();
+            report += wellModel().lastReport();
+            return report;
         }
 
         // compute the "relative" change of the solution between time steps
         double relativeChange() const
         {
-            Scalar resultDelta = 0.0;
-            Scalar resultDenom = 0.0;
-
-            const auto& elemMapper = ebosSimulator_.model().elementMapper();
-            const auto& gridView = ebosSimulator_.gridView();
-            auto elemIt = gridView.template begin</*codim=*/0>();
-            const auto& elemEndIt = gridView.template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const auto& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
-
-                unsigned globalElemIdx = elemMapper.index(elem);
-                const auto& priVarsNew = ebosSimulator_.model().solution(/*timeIdx=*/0)[globalElemIdx];
-
-                Scalar pressureNew;
-                pressureNew = priVarsNew[Indices::pressureSwitchIdx];
-
-                Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationNew = 1.0;
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                    saturationsNew[FluidSystem::waterPhaseIdx] = priVarsNew[Indices::waterSaturationIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::waterPhaseIdx];
-                }
-
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
-                    saturationsNew[FluidSystem::gasPhaseIdx] = priVarsNew[Indices::compositionSwitchIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::gasPhaseIdx];
-                }
-
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                    saturationsNew[FluidSystem::oilPhaseIdx] = oilSaturationNew;
-                }
-
-                const auto& priVarsOld = ebosSimulator_.model().solution(/*timeIdx=*/1)[globalElemIdx];
-
-                Scalar pressureOld;
-                pressureOld = priVarsOld[Indices::pressureSwitchIdx];
-
-                Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationOld = 1.0;
-
-                // NB fix me! adding pressures changes to satutation changes does not make sense
-                Scalar tmp = pressureNew - pressureOld;
-                resultDelta += tmp*tmp;
-                resultDenom += pressureNew*pressureNew;
-
-                if (FluidSystem::numActivePhases() > 1) {
-                    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                        saturationsOld[FluidSystem::waterPhaseIdx] = priVarsOld[Indices::waterSaturationIdx];
-                        oilSaturationOld -= saturationsOld[FluidSystem::waterPhaseIdx];
-                    }
-
-                    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) &&
-                        priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg)
-                    {
-                        saturationsOld[FluidSystem::gasPhaseIdx] = priVarsOld[Indices::compositionSwitchIdx];
-                        oilSaturationOld -= saturationsOld[FluidSystem::gasPhaseIdx];
-                    }
-
-                    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                        saturationsOld[FluidSystem::oilPhaseIdx] = oilSaturationOld;
-                    }
-                    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
-                        Scalar tmpSat = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
-                        resultDelta += tmpSat*tmpSat;
-                        resultDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
-                        assert(std::isfinite(resultDelta));
-                        assert(std::isfinite(resultDenom));
-                    }
-                }
+            // the local contributions are normally gathered by the convergence check of
+            // the last nonlinear iteration. they only need to be recomputed if the
+            // solution has been modified since then.
+            Scalar resultDelta = relChangeDelta_;
+            Scalar resultDenom = relChangeDenom_;
+            if (!relChangeUpToDate_) {
+                const auto data =
+                    reduceInteriorCells_(LocalConvergenceData(/*numComp=*/0),
+                                         [this](LocalConvergenceData& local,
+                                                unsigned cellIdx,
+                                                const auto& /*elem*/,
+                                                ElementContext& /*elemCtx*/)
+                                         {
+                                             addRelativeChange_(cellIdx, local);
+                                         });
+                resultDelta = data.relChangeDelta;
+                resultDenom = data.relChangeDenom;
             }
 
+            const auto& gridView = ebosSimulator_.gridView();
             resultDelta = gridView.comm().sum(resultDelta);
             resultDenom = gridView.comm().sum(resultDenom);
 
@@ -527,7 +508,10 @@ namespace Opm {
             auto& ebosSolver = ebosSimulator_.model().newtonMethod().linearSolver();
             Dune::Timer perfTimer;
             perfTimer.start();
-            ebosSolver.prepare(ebosJac, ebosResid);
+            {
+                PhaseTimer setupTimer(linear_solve_timings_, "linear/setup/" + ebosSolver.preconditionerName());
+                ebosSolver.prepare(ebosJac, ebosResid);
+            }
             linear_solve_setup_time_ = perfTimer.stop();
             ebosSolver.setResidual(ebosResid);
             // actually, the error needs to be calculated after setResidual in order to
@@ -535,6 +519,7 @@ namespace Opm {
             // discretizations does not need to be synchronized across processes to be
             // consistent, this is not relevant for OPM-flow...
             ebosSolver.setMatrix(ebosJac);
+            PhaseTimer solveTimer(linear_solve_timings_, "linear/solve");
             ebosSolver.solve(x);
        }
 
@@ -555,6 +540,7 @@ namespace Opm {
 
             // if the solution is updated, the intensive quantities need to be recalculated
             ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+            relChangeUpToDate_ = false;
         }
 
         /// Return true if output to cout is wanted.
@@ -620,95 +606,56 @@ namespace Opm {
         }
 
         // Get reservoir quantities on this process needed for convergence calculations.
+        //
+        // All quantities are gathered in a single pass over the interior cells which is
+        // shared by all threads. The intensive quantities cached by the linearizer are
+        // used where available. As a by-product, the pore volumes needed by
+        // computeCnvErrorPv() and the local contributions to relativeChange() are
+        // stored.
         double localConvergenceData(std::vector<Scalar>& R_sum,
                                     std::vector<Scalar>& maxCoeff,
                                     std::vector<Scalar>& B_avg)
         {
-            double pvSumLocal = 0.0;
             const auto& ebosModel = ebosSimulator_.model();
             const auto& ebosProblem = ebosSimulator_.problem();
-
-            const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
-
-            ElementContext elemCtx(ebosSimulator_);
-            const auto& gridView = ebosSimulator().gridView();
-            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
-
-            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
-                 elemIt != elemEndIt;
-                 ++elemIt)
-            {
-                const auto& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = intQuants.fluidState();
-
-                const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
-                pvSumLocal += pvValue;
-
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
-                {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                        continue;
-                    }
-
-                    const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
-
-                    B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][compIdx];
-
-                    R_sum[ compIdx ] += R2;
-                    maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
-                }
-
-                if ( has_solvent_ ) {
-                    B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
-                    const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
-                    R_sum[ contiSolventEqIdx ] += R2;
-                    maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if (has_polymer_ ) {
-                    B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
-                    R_sum[ contiPolymerEqIdx ] += R2;
-                    maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if (has_foam_ ) {
-                    B_avg[ contiFoamEqIdx ] += 1.0 / fs.invB(FluidSystem::gasPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiFoamEqIdx];
-                    R_sum[ contiFoamEqIdx ] += R2;
-                    maxCoeff[ contiFoamEqIdx ] = std::max( maxCoeff[ contiFoamEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if (has_brine_ ) {
-                    B_avg[ contiBrineEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiBrineEqIdx];
-                    R_sum[ contiBrineEqIdx ] += R2;
-                    maxCoeff[ contiBrineEqIdx ] = std::max( maxCoeff[ contiBrineEqIdx ], std::abs( R2 ) / pvValue );
-                }
-
-                if (has_polymermw_) {
-                    assert(has_polymer_);
-
-                    B_avg[contiPolymerMWEqIdx] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
-                    // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
-                    // TODO: there should be a more general way to determine the scaling-down coefficient
-                    const auto R2 = ebosResid[cell_idx][contiPolymerMWEqIdx] / 100.;
-                    R_sum[contiPolymerMWEqIdx] += R2;
-                    maxCoeff[contiPolymerMWEqIdx] = std::max( maxCoeff[contiPolymerMWEqIdx], std::abs( R2 ) / pvValue );
-                }
-
-                if (has_energy_ ) {
-                    B_avg[ contiEnergyEqIdx ] += 1.0;
-                    const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
-                    R_sum[ contiEnergyEqIdx ] += R2;
-                    maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
-                }
-
+            const auto& ebosResid = ebosModel.linearizer().residual();
+
+            cellPoreVolume_.assign(ebosModel.numGridDof(), 0.0);
+
+            const auto data =
+                reduceInteriorCells_(LocalConvergenceData(B_avg.size()),
+                                     [&](LocalConvergenceData& local,
+                                         unsigned cell_idx,
+                                         const auto& elem,
+                                         ElementContext& elemCtx)
+                                     {
+                                         const IntensiveQuantities* intQuants =
+                                             ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0);
+                                         if (!intQuants) {
+                                             elemCtx.updatePrimaryStencil(elem);
+                                             elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                                             intQuants = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                                         }
+
+                                         const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0)
+                                             * ebosModel.dofTotalVolume(cell_idx);
+                                         cellPoreVolume_[cell_idx] = pvValue;
+                                         local.pvSum += pvValue;
+
+                                         addConvergenceData_(*intQuants, ebosResid[cell_idx], pvValue, local);
+                                         addRelativeChange_(cell_idx, local);
+                                     });
+
+            for (std::size_t compIdx = 0; compIdx < B_avg.size(); ++compIdx) {
+                B_avg[compIdx] += data.B_avg[compIdx];
+                R_sum[compIdx] += data.R_sum[compIdx];
+                maxCoeff[compIdx] = std::max(maxCoeff[compIdx], data.maxCoeff[compIdx]);
             }
 
+            relChangeDelta_ = data.relChangeDelta;
+            relChangeDenom_ = data.relChangeDenom;
+            relChangeUpToDate_ = true;
+
             // compute local average in terms of global number of elements
             const int bSize = B_avg.size();
             for ( int i = 0; i<bSize; ++i )
@@ -716,24 +663,28 @@ namespace Opm {
                 B_avg[ i ] /= Scalar( global_nc_ );
             }
 
-            return pvSumLocal;
+            return data.pvSum;
         }
 
+        // Note that this uses the pore volumes which have been stored by the last call
+        // to localConvergenceData().
         double computeCnvErrorPv(const std::vector<Scalar>& B_avg, double dt)
         {
             double errorPV{};
-            const auto& ebosModel = ebosSimulator_.model();
-            const auto& ebosProblem = ebosSimulator_.problem();
             const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
-            const auto& gridView = ebosSimulator().gridView();
-            ElementContext elemCtx(ebosSimulator_);
+            const int numCells = cellPoreVolume_.size();
 
-            for (const auto& elem: elements(gridView, Dune::Partitions::interiorBorder))
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:errorPV)
+#endif
+            for (int cell_idx = 0; cell_idx < numCells; ++cell_idx)
             {
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
+                // cells which are not interior have zero pore volume here. (for all
+                // other cells, a zero pore volume would not contribute either.)
+                const double pvValue = cellPoreVolume_[cell_idx];
+                if (pvValue == 0.0)
+                    continue;
+
                 const auto& cellResidual = ebosResid[cell_idx];
                 bool cnvViolated = false;
 
@@ -791,7 +742,7 @@ namespace Opm {
             }
 
             // Setup component names, only the first time the function is run.
-            static std::vector<std::string> compNames;
+            auto& compNames = compNames_;
             if (compNames.empty()) {
                 compNames.resize(numComp);
                 for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
@@ -1009,6 +960,257 @@ namespace Opm {
         double drMaxRel() const { return param_.dr_max_rel_; }
         double maxResidualAllowed() const { return param_.max_residual_allowed_; }
         double linear_solve_setup_time_;
+        PhaseTimings linear_solve_timings_;
+        std::vector<std::string> compNames_;
+
+        // partial results of the reductions over the cells which are needed to check
+        // for convergence.
+        struct LocalConvergenceData
+        {
+            explicit LocalConvergenceData(std::size_t numComp = 0)
+                : B_avg(numComp, 0.0)
+                , R_sum(numComp, 0.0)
+                , maxCoeff(numComp, std::numeric_limits<Scalar>::lowest())
+            {}
+
+            void merge(const LocalConvergenceData& other)
+            {
+                for (std::size_t compIdx = 0; compIdx < B_avg.size(); ++compIdx) {
+                    B_avg[compIdx] += other.B_avg[compIdx];
+                    R_sum[compIdx] += other.R_sum[compIdx];
+                    maxCoeff[compIdx] = std::max(maxCoeff[compIdx], other.maxCoeff[compIdx]);
+                }
+                pvSum += other.pvSum;
+                relChangeDelta += other.relChangeDelta;
+                relChangeDenom += other.relChangeDenom;
+            }
+
+            std::vector<Scalar> B_avg;
+            std::vector<Scalar> R_sum;
+            std::vector<Scalar> maxCoeff;
+            double pvSum = 0.0;
+            Scalar relChangeDelta = 0.0;
+            Scalar relChangeDenom = 0.0;
+        };
+
+        // call a functor for all interior cells of the grid and reduce the results.
+        //
+        // the interior cells are split into chunks of a fixed size which are processed
+        // by all threads concurrently. each chunk accumulates into its own copy of
+        // 'init' and the chunks are merged in their order at the end, so the result
+        // does neither depend on the number of threads nor on the scheduling.
+        // exceptions thrown by the functor are passed on to the caller.
+        template <class Functor>
+        LocalConvergenceData reduceInteriorCells_(const LocalConvergenceData& init,
+                                                  const Functor& functor) const
+        {
+            const auto& dofMapper = ebosSimulator_.model().dofMapper();
+            const auto& interiorElements = interiorElements_();
+            const int numChunks = static_cast<int>((interiorElements.size() + reductionChunkSize - 1) / reductionChunkSize);
+
+            std::vector<LocalConvergenceData> chunkData(numChunks, init);
+            std::exception_ptr exceptionPtr;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                ElementContext elemCtx(ebosSimulator_);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+                for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx) {
+                    try {
+                        const std::size_t chunkEnd = std::min(interiorElements.size(), (chunkIdx + 1)*reductionChunkSize);
+                        for (std::size_t i = chunkIdx*reductionChunkSize; i < chunkEnd; ++i) {
+                            const auto& elem = interiorElements[i];
+                            functor(chunkData[chunkIdx], dofMapper.index(elem), elem, elemCtx);
+                        }
+                    }
+                    catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                        {
+                            if (!exceptionPtr)
+                                exceptionPtr = std::current_exception();
+                        }
+                    }
+                }
+            }
+
+            if (exceptionPtr)
+                std::rethrow_exception(exceptionPtr);
+
+            LocalConvergenceData result = init;
+            for (const auto& local : chunkData)
+                result.merge(local);
+            return result;
+        }
+
+        // the interior elements of the grid in the order of the grid view. they are
+        // collected by the first call since the grid does not change during a run.
+        const std::vector<Element>& interiorElements_() const
+        {
+            const auto& gridView = ebosSimulator_.gridView();
+            if (interiorElementsCache_.empty() && gridView.size(/*codim=*/0) > 0) {
+                const auto elemEndIt = gridView.template end</*codim=*/0>();
+                for (auto elemIt = gridView.template begin</*codim=*/0>(); elemIt != elemEndIt; ++elemIt) {
+                    if (elemIt->partitionType() == Dune::InteriorEntity)
+                        interiorElementsCache_.push_back(*elemIt);
+                }
+            }
+            return interiorElementsCache_;
+        }
+
+        template <class CellResidual>
+        void addConvergenceData_(const IntensiveQuantities& intQuants,
+                                 const CellResidual& cellResidual,
+                                 const double pvValue,
+                                 LocalConvergenceData& local) const
+        {
+            const auto& fs = intQuants.fluidState();
+            auto& B_avg = local.B_avg;
+            auto& R_sum = local.R_sum;
+            auto& maxCoeff = local.maxCoeff;
+
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            {
+                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                    continue;
+                }
+
+                const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+
+                B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
+                const auto R2 = cellResidual[compIdx];
+
+                R_sum[ compIdx ] += R2;
+                maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
+            }
+
+            if ( has_solvent_ ) {
+                B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
+                const auto R2 = cellResidual[contiSolventEqIdx];
+                R_sum[ contiSolventEqIdx ] += R2;
+                maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if (has_polymer_ ) {
+                B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                const auto R2 = cellResidual[contiPolymerEqIdx];
+                R_sum[ contiPolymerEqIdx ] += R2;
+                maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if (has_foam_ ) {
+                B_avg[ contiFoamEqIdx ] += 1.0 / fs.invB(FluidSystem::gasPhaseIdx).value();
+                const auto R2 = cellResidual[contiFoamEqIdx];
+                R_sum[ contiFoamEqIdx ] += R2;
+                maxCoeff[ contiFoamEqIdx ] = std::max( maxCoeff[ contiFoamEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if (has_brine_ ) {
+                B_avg[ contiBrineEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                const auto R2 = cellResidual[contiBrineEqIdx];
+                R_sum[ contiBrineEqIdx ] += R2;
+                maxCoeff[ contiBrineEqIdx ] = std::max( maxCoeff[ contiBrineEqIdx ], std::abs( R2 ) / pvValue );
+            }
+
+            if (has_polymermw_) {
+                assert(has_polymer_);
+
+                B_avg[contiPolymerMWEqIdx] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
+                // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
+                // TODO: there should be a more general way to determine the scaling-down coefficient
+                const auto R2 = cellResidual[contiPolymerMWEqIdx] / 100.;
+                R_sum[contiPolymerMWEqIdx] += R2;
+                maxCoeff[contiPolymerMWEqIdx] = std::max( maxCoeff[contiPolymerMWEqIdx], std::abs( R2 ) / pvValue );
+            }
+
+            if (has_energy_ ) {
+                B_avg[ contiEnergyEqIdx ] += 1.0;
+                const auto R2 = cellResidual[contiEnergyEqIdx];
+                R_sum[ contiEnergyEqIdx ] += R2;
+                maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
+            }
+        }
+
+        // add the contribution of a cell to the "relative" change of the solution
+        // between time steps
+        void addRelativeChange_(unsigned globalElemIdx, LocalConvergenceData& local) const
+        {
+            const auto& priVarsNew = ebosSimulator_.model().solution(/*timeIdx=*/0)[globalElemIdx];
+
+            Scalar pressureNew;
+            pressureNew = priVarsNew[Indices::pressureSwitchIdx];
+
+            Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
+            Scalar oilSaturationNew = 1.0;
+            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                saturationsNew[FluidSystem::waterPhaseIdx] = priVarsNew[Indices::waterSaturationIdx];
+                oilSaturationNew -= saturationsNew[FluidSystem::waterPhaseIdx];
+            }
+
+            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
+                saturationsNew[FluidSystem::gasPhaseIdx] = priVarsNew[Indices::compositionSwitchIdx];
+                oilSaturationNew -= saturationsNew[FluidSystem::gasPhaseIdx];
+            }
+
+            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                saturationsNew[FluidSystem::oilPhaseIdx] = oilSaturationNew;
+            }
+
+            const auto& priVarsOld = ebosSimulator_.model().solution(/*timeIdx=*/1)[globalElemIdx];
+
+            Scalar pressureOld;
+            pressureOld = priVarsOld[Indices::pressureSwitchIdx];
+
+            Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
+            Scalar oilSaturationOld = 1.0;
+
+            // NB fix me! adding pressures changes to satutation changes does not make sense
+            Scalar tmp = pressureNew - pressureOld;
+            local.relChangeDelta += tmp*tmp;
+            local.relChangeDenom += pressureNew*pressureNew;
+
+            if (FluidSystem::numActivePhases() > 1) {
+                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                    saturationsOld[FluidSystem::waterPhaseIdx] = priVarsOld[Indices::waterSaturationIdx];
+                    oilSaturationOld -= saturationsOld[FluidSystem::waterPhaseIdx];
+                }
+
+                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) &&
+                    priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg)
+                {
+                    saturationsOld[FluidSystem::gasPhaseIdx] = priVarsOld[Indices::compositionSwitchIdx];
+                    oilSaturationOld -= saturationsOld[FluidSystem::gasPhaseIdx];
+                }
+
+                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                    saturationsOld[FluidSystem::oilPhaseIdx] = oilSaturationOld;
+                }
+                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
+                    Scalar tmpSat = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
+                    local.relChangeDelta += tmpSat*tmpSat;
+                    local.relChangeDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
+                    assert(std::isfinite(local.relChangeDelta));
+                    assert(std::isfinite(local.relChangeDenom));
+                }
+            }
+        }
+
+        // pore volumes of the interior cells as used by the last convergence check
+        std::vector<double> cellPoreVolume_;
+
+        // see interiorElements_()
+        mutable std::vector<Element> interiorElementsCache_;
+
+        // number of cells per chunk of the reductions over the interior cells
+        static constexpr std::size_t reductionChunkSize = 1024;
+
+        // local contributions to relativeChange() of the last convergence check
+        Scalar relChangeDelta_ = 0.0;
+        Scalar relChangeDenom_ = 0.0;
+        bool relChangeUpToDate_ = false;
     public:
         std::vector<bool> wasSwitched_;
     };
@@ -29,6 +29,7 @@
 #include <opm/simulators/flow/SimulatorFullyImplicitBlackoilEbos.hpp>
 #include <opm/simulators/utils/ParallelFileMerger.hpp>
 #include <opm/simulators/utils/moduleVersion.hpp>
+#include <opm/simulators/utils/PerformanceReport.hpp>
 #include <opm/simulators/linalg/ExtractParallelGridInformationToISTL.hpp>
 
 #include <opm/core/props/satfunc/RelpermDiagnostics.hpp>
@@ -62,6 +63,10 @@ template<class TypeTag, class MyTypeTag>
 struct EnableLoggingFalloutWarning {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct OutputPerformanceReport {
+    using type = UndefinedProperty;
+};
 
 // TODO: enumeration parameters. we use strings for now.
 template<class TypeTag>
@@ -77,6 +82,10 @@ template<class TypeTag>
 struct OutputInterval<TypeTag, TTag::EclFlowProblem> {
     static constexpr int value = 1;
 };
+template<class TypeTag>
+struct OutputPerformanceReport<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
 
 } // namespace Opm::Properties
 
@@ -125,6 +134,8 @@ namespace Opm
                                  "Specify the number of report steps between two consecutive writes of restart data");
             EWOMS_REGISTER_PARAM(TypeTag, bool, EnableLoggingFalloutWarning,
                                  "Developer option to see whether logging was on non-root processors. In that case it will be appended to the *.DBG or *.PRT files");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OutputPerformanceReport,
+                                 "Write the timings of the simulation phases, aggregated over all processes, to <CASE>.PERF.json");
 
             Simulator::registerParameters();
 
@@ -580,15 +591,22 @@ namespace Opm
         // Output summary after simulation has completed
         void runSimulatorAfterSim_(SimulatorReport &report)
         {
+#if _OPENMP
+            int threads = omp_get_max_threads();
+#else
+            int threads = 1;
+#endif
+            if (EWOMS_GET_PARAM(TypeTag, bool, OutputPerformanceReport)) {
+                // collective, the file is written by rank 0
+                const auto& ioConfig = eclState().getIOConfig();
+                const auto fileName = Opm::filesystem::path(ioConfig.getOutputDir()) / (ioConfig.getBaseName() + ".PERF.json");
+                writePerformanceReport(fileName.string(), report, threads);
+            }
+
             if (this->output_cout_) {
                 std::ostringstream ss;
                 ss << "\n\n================    End of simulation     ===============\n\n";
                 ss << "Number of MPI processes: " << std::setw(6) << mpi_size_ << "\n";
-#if _OPENMP
-                int threads = omp_get_max_threads();
-#else
-                int threads = 1;
-#endif
                 ss << "Threads per MPI process:  " << std::setw(5) << threads << "\n";
                 report.reportFullyImplicit(ss);
                 OpmLog::info(ss.str());
@@ -439,7 +439,8 @@ namespace Opm
 
                 readDeck(mpiRank, deckFilename, deck_, eclipseState_, schedule_,
                          summaryConfig_, nullptr, python, std::move(parseContext),
-                         init_from_restart_file, outputCout_);
+                         init_from_restart_file, outputCout_,
+                         EWOMS_GET_PARAM(PreTypeTag, std::string, EclStartupCacheDir));
 
                 if (outputCout_) {
                     OpmLog::info("Done reading deck file.");
@@ -224,6 +224,7 @@ public:
             ebosSimulator_.problem().writeOutput();
 
             report_.success.output_write_time += perfTimer.stop();
+            addPhaseTimings(report_.success.phase_timings, ebosSimulator_.problem().takeOutputTimings());
         }
 
         // Run a multiple steps of the solver depending on the time step control.
@@ -276,6 +277,7 @@ public:
         ebosSimulator_.problem().setNextTimeStepSize(nextstep);
         ebosSimulator_.problem().writeOutput();
         report_.success.output_write_time += perfTimer.stop();
+        addPhaseTimings(report_.success.phase_timings, ebosSimulator_.problem().takeOutputTimings());
 
         solver->model().endReportStep();
 
@@ -311,6 +313,7 @@ public:
             Dune::Timer finalOutputTimer;
             finalOutputTimer.start();
 
+            addPhaseTimings(report_.success.phase_timings, ebosSimulator_.problem().takeOutputTimings());
             ebosSimulator_.problem().finalizeOutput();
             report_.success.output_write_time += finalOutputTimer.stop();
         }
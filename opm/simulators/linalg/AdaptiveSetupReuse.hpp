@@ -0,0 +1,90 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ADAPTIVESETUPREUSE_HEADER_INCLUDED
+#define OPM_ADAPTIVESETUPREUSE_HEADER_INCLUDED
+
+#include <algorithm>
+
+namespace Opm
+{
+
+/// Decides when the linear solver and its preconditioner hierarchy are rebuilt
+/// from scratch instead of only updating the numerical values of a reused setup.
+///
+/// After a rebuild, the number of iterations of the first solve is the reference.
+/// Every later solve with more iterations costs the additional iterations times
+/// the measured time per iteration. Once the accumulated additional cost exceeds
+/// the saving of an update compared to a rebuild, the next setup is a rebuild.
+/// A solve which does not converge also triggers a rebuild.
+class AdaptiveSetupReuse
+{
+public:
+    /// Whether the next setup should rebuild the solver.
+    bool rebuildNext() const
+    {
+        return !converged_ || !hasReference_ || extraApplyCost_ > std::max(rebuildTime_ - updateTime_, 0.0);
+    }
+
+    /// Record the time of a setup, rebuilt tells whether it was a rebuild or an update.
+    void setupDone(const bool rebuilt, const double time)
+    {
+        if (rebuilt) {
+            rebuildTime_ = time;
+            extraApplyCost_ = 0.0;
+            hasReference_ = false;
+        }
+        else {
+            updateTime_ = time;
+        }
+    }
+
+    /// Record the number of iterations and the time of a solve.
+    void solveDone(const int iterations, const double time, const bool converged)
+    {
+        converged_ = converged;
+        if (!hasReference_) {
+            referenceIterations_ = iterations;
+            hasReference_ = true;
+            return;
+        }
+
+        const int extraIterations = iterations - referenceIterations_;
+        if (extraIterations > 0 && iterations > 0)
+            extraApplyCost_ += extraIterations * time / iterations;
+    }
+
+    /// The additional time of the solves since the last rebuild.
+    double extraApplyCost() const
+    {
+        return extraApplyCost_;
+    }
+
+private:
+    double rebuildTime_ = 0.0;
+    double updateTime_ = 0.0;
+    double extraApplyCost_ = 0.0;
+    int referenceIterations_ = 0;
+    bool hasReference_ = false;
+    bool converged_ = true;
+};
+
+} // namespace Opm
+
+#endif // OPM_ADAPTIVESETUPREUSE_HEADER_INCLUDED
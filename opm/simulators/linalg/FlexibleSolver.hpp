@@ -22,6 +22,7 @@
 #ifndef OPM_FLEXIBLE_SOLVER_HEADER_INCLUDED
 #define OPM_FLEXIBLE_SOLVER_HEADER_INCLUDED
 
+#include <opm/simulators/linalg/FusedDotProducts.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
 
 #include <dune/istl/solver.hh>
@@ -72,6 +73,7 @@ public:
 private:
     using AbstractScalarProductType = Dune::ScalarProduct<VectorType>;
     using AbstractSolverType = Dune::InverseOperator<VectorType, VectorType>;
+    using AbstractFusedDotsType = Dune::FusedDotProducts<VectorType>;
 
     // Machinery for making sequential or parallel operators/preconditioners/scalar products.
     template <class Comm>
@@ -95,6 +97,7 @@ private:
     std::shared_ptr<AbstractOperatorType> linearoperator_for_precond_;
     std::shared_ptr<AbstractPrecondType> preconditioner_;
     std::shared_ptr<AbstractScalarProductType> scalarproduct_;
+    std::shared_ptr<AbstractFusedDotsType> fuseddots_;
     std::shared_ptr<AbstractSolverType> linsolver_;
 };
 
@@ -22,6 +22,7 @@
 #define OPM_FLEXIBLE_SOLVER_IMPL_HEADER_INCLUDED
 
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/PipelinedSolvers.hpp>
 #include <opm/simulators/linalg/PreconditionerFactory.hpp>
 #include <opm/simulators/linalg/matrixblock.hh>
 
@@ -112,6 +113,9 @@ namespace Dune
                                                                                     weightsCalculator,
                                                                                     comm);
         scalarproduct_ = Dune::createScalarProduct<VectorType, Comm>(comm, op.category());
+#if HAVE_MPI
+        fuseddots_ = std::make_shared<Dune::ParallelFusedDotProducts<VectorType, Comm>>(comm);
+#endif
         linearoperator_for_precond_ = op_prec;
     }
 
@@ -133,6 +137,7 @@ namespace Dune
                                                                               child ? *child : pt(),
                                                                               weightsCalculator);
         scalarproduct_ = std::make_shared<Dune::SeqScalarProduct<VectorType>>();
+        fuseddots_ = std::make_shared<Dune::SeqFusedDotProducts<VectorType>>();
         linearoperator_for_precond_ = op_prec;
     }
 
@@ -168,6 +173,22 @@ namespace Dune
                                                                         restart, // desired residual reduction factor
                                                                         maxiter, // maximum number of iterations
                                                                         verbosity));
+        } else if (solver_type == "pipelined_bicgstab") {
+            linsolver_.reset(new Dune::PipelinedBiCGSTABSolver<VectorType>(*linearoperator_for_solver_,
+                                                                           *fuseddots_,
+                                                                           *preconditioner_,
+                                                                           tol, // desired residual reduction factor
+                                                                           maxiter, // maximum number of iterations
+                                                                           verbosity));
+        } else if (solver_type == "lowsync_gmres") {
+            int restart = prm.get<int>("restart", 15);
+            linsolver_.reset(new Dune::LowSyncGMResSolver<VectorType>(*linearoperator_for_solver_,
+                                                                              *fuseddots_,
+                                                                              *preconditioner_,
+                                                                              tol, // desired residual reduction factor
+                                                                              restart,
+                                                                              maxiter, // maximum number of iterations
+                                                                              verbosity));
 #if HAVE_SUITESPARSE_UMFPACK
         } else if (solver_type == "umfpack") {
             bool dummy = false;
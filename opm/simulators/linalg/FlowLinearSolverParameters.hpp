@@ -24,6 +24,7 @@
 #ifndef OPM_FLOWLINEARSOLVERPARAMETERS_HEADER_INCLUDED
 #define OPM_FLOWLINEARSOLVERPARAMETERS_HEADER_INCLUDED
 
+#include <opm/common/ErrorMacros.hpp>
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/simulators/linalg/ParallelOverlappingILU0.hpp>
 
@@ -32,6 +33,7 @@
 
 #include <array>
 #include <memory>
+#include <stdexcept>
 
 namespace Opm {
 template <class TypeTag>
@@ -142,6 +144,10 @@ struct LinearSolverConfigurationJsonFile {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct LinearSolverPreconditionerPrecision {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct GpuMode {
     using type = UndefinedProperty;
 };
@@ -257,6 +263,10 @@ struct LinearSolverConfigurationJsonFile<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = "none";
 };
 template<class TypeTag>
+struct LinearSolverPreconditionerPrecision<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "double";
+};
+template<class TypeTag>
 struct GpuMode<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = "none";
 };
@@ -338,6 +348,7 @@ namespace Opm
         bool scale_linear_system_;
         std::string linear_solver_configuration_;
         std::string linear_solver_configuration_json_file_;
+        std::string preconditioner_precision_;
         std::string gpu_mode_;
         int bda_device_id_;
         int opencl_platform_id_;
@@ -367,8 +378,13 @@ namespace Opm
             cpr_max_ell_iter_  =  EWOMS_GET_PARAM(TypeTag, int, CprMaxEllIter);
             cpr_ell_solvetype_  =  EWOMS_GET_PARAM(TypeTag, int, CprEllSolvetype);
             cpr_reuse_setup_  =  EWOMS_GET_PARAM(TypeTag, int, CprReuseSetup);
+            if (cpr_reuse_setup_ < 0 || cpr_reuse_setup_ > 4) {
+                OPM_THROW(std::invalid_argument, "Invalid value " << cpr_reuse_setup_
+                          << " for --cpr-reuse-setup, valid values are 0 to 4.");
+            }
             linear_solver_configuration_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverConfiguration);
             linear_solver_configuration_json_file_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverConfigurationJsonFile);
+            preconditioner_precision_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverPreconditionerPrecision);
             gpu_mode_ = EWOMS_GET_PARAM(TypeTag, std::string, GpuMode);
             bda_device_id_ = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId);
             opencl_platform_id_ = EWOMS_GET_PARAM(TypeTag, int, OpenclPlatformId);
@@ -397,10 +413,11 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, bool, CprUseDrs, "Use dynamic row sum using weights");
             EWOMS_REGISTER_PARAM(TypeTag, int, CprMaxEllIter, "MaxIterations of the elliptic pressure part of the cpr solver");
             EWOMS_REGISTER_PARAM(TypeTag, int, CprEllSolvetype, "Solver type of elliptic pressure solve (0: bicgstab, 1: cg, 2: only amg preconditioner)");
-            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse Amg Setup");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse preconditioner setup. Valid options are 0: recreate the preconditioner for every linear solve, 1: recreate once every timestep, 2: recreate if last linear solve took more than 10 iterations, 3: never recreate, 4: recreate when the additional iterations since the last rebuild cost more than the rebuild");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverConfiguration, "Configuration of solver valid is: ilu0 (default), cpr_quasiimpes, cpr_trueimpes or file (specified in LinearSolverConfigurationJsonFile) ");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverConfigurationJsonFile, "Filename of JSON configuration for flexible linear solver system.");
-            EWOMS_REGISTER_PARAM(TypeTag, std::string, GpuMode, "Use GPU cusparseSolver or openclSolver as the linear solver, usage: '--gpu-mode=[none|cusparse|opencl]'");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverPreconditionerPrecision, "Precision of the ILU factors and AMG hierarchies of the flexible linear solver (double or float), the Krylov solver always uses double. Ignored when the configuration is read from a JSON file, which sets \"precision\" for each preconditioner");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, GpuMode, "Use GPU cusparseSolver or openclSolver, or their threaded CPU counterpart cpuSolver, as the linear solver, usage: '--gpu-mode=[none|cpu|cusparse|opencl]'");
             EWOMS_REGISTER_PARAM(TypeTag, int, BdaDeviceId, "Choose device ID for cusparseSolver or openclSolver, use 'nvidia-smi' or 'clinfo' to determine valid IDs");
             EWOMS_REGISTER_PARAM(TypeTag, int, OpenclPlatformId, "Choose platform ID for openclSolver, use 'clinfo' to determine valid platform IDs");
         }
@@ -424,6 +441,7 @@ namespace Opm
             ilu_milu_                 = MILU_VARIANT::ILU;
             ilu_redblack_             = false;
             ilu_reorder_sphere_       = true;
+            preconditioner_precision_ = "double";
             gpu_mode_                 = "none";
             bda_device_id_            = 0;
             opencl_platform_id_       = 0;
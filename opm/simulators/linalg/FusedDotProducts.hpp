@@ -0,0 +1,144 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_FUSEDDOTPRODUCTS_HEADER_INCLUDED
+#define OPM_FUSEDDOTPRODUCTS_HEADER_INCLUDED
+
+#if HAVE_MPI
+#include <dune/common/parallel/mpitraits.hh>
+#include <mpi.h>
+#endif
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace Dune
+{
+
+/// Computes several global dot products with a single reduction, which is
+/// started by start() and completed by wait(). In parallel the reduction is
+/// non-blocking, so that the caller may apply the operator or the
+/// preconditioner while the reduction is under way.
+template <class X>
+class FusedDotProducts
+{
+public:
+    using field_type = typename X::field_type;
+    using Pairs = std::vector<std::pair<const X*, const X*>>;
+
+    virtual ~FusedDotProducts() = default;
+
+    /// Start the computation of the dot products of the given pairs of vectors.
+    virtual void start(const Pairs& pairs) = 0;
+
+    /// Wait for the results of the last start(), in the order of the pairs.
+    virtual const std::vector<field_type>& wait() = 0;
+
+protected:
+    template <class Mask>
+    void localDots(const Pairs& pairs, const Mask& mask)
+    {
+        result_.assign(pairs.size(), 0.0);
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            const X& x = *pairs[k].first;
+            const X& y = *pairs[k].second;
+            assert(x.size() == y.size());
+            field_type sum = 0.0;
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                sum += mask(i) * x[i].dot(y[i]);
+            }
+            result_[k] = sum;
+        }
+    }
+
+    std::vector<field_type> result_;
+};
+
+/// The sequential case, the dot products are computed by start().
+template <class X>
+class SeqFusedDotProducts : public FusedDotProducts<X>
+{
+public:
+    using typename FusedDotProducts<X>::Pairs;
+    using typename FusedDotProducts<X>::field_type;
+
+    void start(const Pairs& pairs) override
+    {
+        this->localDots(pairs, [](std::size_t) { return 1.0; });
+    }
+
+    const std::vector<field_type>& wait() override
+    {
+        return this->result_;
+    }
+};
+
+#if HAVE_MPI
+/// The parallel case for an OwnerOverlapCopyCommunication, only the entries
+/// owned by a process contribute to its local sums.
+template <class X, class Comm>
+class ParallelFusedDotProducts : public FusedDotProducts<X>
+{
+public:
+    using typename FusedDotProducts<X>::Pairs;
+    using typename FusedDotProducts<X>::field_type;
+
+    explicit ParallelFusedDotProducts(const Comm& comm)
+        : comm_(comm)
+    {
+    }
+
+    void start(const Pairs& pairs) override
+    {
+        if (!pairs.empty() && mask_.size() != pairs.front().first->size()) {
+            buildOwnerMask(pairs.front().first->size());
+        }
+        this->localDots(pairs, [this](std::size_t i) { return mask_[i]; });
+        MPI_Iallreduce(MPI_IN_PLACE, this->result_.data(), static_cast<int>(this->result_.size()),
+                       Dune::MPITraits<field_type>::getType(), MPI_SUM,
+                       comm_.communicator(), &request_);
+    }
+
+    const std::vector<field_type>& wait() override
+    {
+        MPI_Wait(&request_, MPI_STATUS_IGNORE);
+        return this->result_;
+    }
+
+private:
+    void buildOwnerMask(const std::size_t size)
+    {
+        mask_.assign(size, 1.0);
+        for (const auto& ind : comm_.indexSet()) {
+            if (!Comm::OwnerSet::contains(ind.local().attribute())) {
+                mask_[ind.local().local()] = 0.0;
+            }
+        }
+    }
+
+    const Comm& comm_;
+    std::vector<field_type> mask_;
+    MPI_Request request_ = MPI_REQUEST_NULL;
+};
+#endif // HAVE_MPI
+
+} // namespace Dune
+
+#endif // OPM_FUSEDDOTPRODUCTS_HEADER_INCLUDED
@@ -32,6 +32,7 @@
 #include <opm/simulators/linalg/findOverlapRowsAndColumns.hpp>
 #include <opm/simulators/linalg/setupPropertyTree.hpp>
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/AdaptiveSetupReuse.hpp>
 #include <opm/simulators/linalg/WriteSystemMatrixHelper.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
@@ -47,12 +48,11 @@
 #include <dune/istl/solvers.hh>
 #include <dune/istl/owneroverlapcopy.hh>
 #include <dune/istl/paamg/amg.hh>
+#include <dune/common/timer.hh>
 
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
-#if HAVE_CUDA || HAVE_OPENCL
 #include <opm/simulators/linalg/bda/BdaBridge.hpp>
-#endif
 
 namespace Opm::Properties {
 
@@ -127,10 +127,8 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
         enum { pressureVarIndex = Indices::pressureSwitchIdx };
         static const int numEq = Indices::numEq;
 
-#if HAVE_CUDA || HAVE_OPENCL
         static const unsigned int block_size = Matrix::block_type::rows;
         std::unique_ptr<BdaBridge<Matrix, Vector, block_size>> bdaBridge;
-#endif
 
 #if HAVE_MPI
         typedef Dune::OwnerOverlapCopyCommunication<int,int> communication_type;
@@ -166,7 +164,6 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
                 prm_ = setupPropertyTree<TypeTag>(parameters_);
             }
             const auto& gridForConn = simulator_.vanguard().grid();
-#if HAVE_CUDA || HAVE_OPENCL
             std::string gpu_mode = EWOMS_GET_PARAM(TypeTag, std::string, GpuMode);
             int platformID = EWOMS_GET_PARAM(TypeTag, int, OpenclPlatformId);
             int deviceID = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId);
@@ -178,12 +175,6 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
             const double tolerance = EWOMS_GET_PARAM(TypeTag, double, LinearSolverReduction);
             const int linear_solver_verbosity = parameters_.linear_solver_verbosity_;
             bdaBridge.reset(new BdaBridge<Matrix, Vector, block_size>(gpu_mode, linear_solver_verbosity, maxit, tolerance, platformID, deviceID));
-#else
-            const std::string gpu_mode = EWOMS_GET_PARAM(TypeTag, std::string, GpuMode);
-            if (gpu_mode.compare("none") != 0) {
-                OPM_THROW(std::logic_error,"Error cannot use GPU solver since neither CUDA nor OpenCL were found by cmake");
-            }
-#endif
             extractParallelGridInformationToISTL(simulator_.vanguard().grid(), parallelInformation_);
             useWellConn_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
             ownersFirst_ = EWOMS_GET_PARAM(TypeTag, bool, OwnerCellsFirst);
@@ -222,9 +213,8 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
 
         void prepare(const SparseMatrixAdapter& M, Vector& b)
         {
-            static bool firstcall = true;
 #if HAVE_MPI
-            if (firstcall && parallelInformation_.type() == typeid(ParallelISTLInformation)) {
+            if (firstcall_ && parallelInformation_.type() == typeid(ParallelISTLInformation)) {
                 // Parallel case.
                 const ParallelISTLInformation* parinfo = std::any_cast<ParallelISTLInformation>(&parallelInformation_);
                 assert(parinfo);
@@ -240,7 +230,7 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
             }
             else
             {
-                if (firstcall)
+                if (firstcall_)
                 {
                     // ebos will not change the matrix object. Hence simply store a pointer
                     // to the original one with a deleter that does nothing.
@@ -267,7 +257,7 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
             {
                 this->scaleSystem();
             }
-            firstcall = false;
+            firstcall_ = false;
         }
 
         void scaleSystem()
@@ -335,7 +325,10 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
             {
                 Dune::InverseOperatorResult res;
                 assert(flexibleSolver_);
+                Dune::Timer applyTimer;
+                applyTimer.start();
                 flexibleSolver_->apply(x, *rhs_, res);
+                setupReuse_.solveDone(res.iterations, applyTimer.stop(), res.converged);
                 iterations_ = res.iterations;
                 if (write_matrix) {
                     Opm::Helper::writeSystem(simulator_, //simulator is only used to get names
@@ -396,6 +389,14 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
         /// \copydoc NewtonIterationBlackoilInterface::iterations
         int iterations () const { return iterations_; }
 
+        /// Name of the preconditioner, used to label its setup time.
+        std::string preconditionerName() const
+        {
+            if (useFlexible_)
+                return prm_.get<std::string>("preconditioner.type", "cpr");
+            return parameters_.linear_solver_use_amg_ ? "amg" : "ilu";
+        }
+
         /// \copydoc NewtonIterationBlackoilInterface::parallelInformation
         const std::any& parallelInformation() const { return parallelInformation_; }
 
@@ -462,7 +463,6 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
 #endif
             {
                 // tries to solve linear system
-#if HAVE_CUDA || HAVE_OPENCL
                 bool use_gpu = bdaBridge->getUseGpu();
                 if (use_gpu) {
                     const std::string gpu_mode = EWOMS_GET_PARAM(TypeTag, std::string, GpuMode);
@@ -486,6 +486,10 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
                             if(gpu_mode.compare("opencl") == 0){
                                 OpmLog::warning("openclSolver did not converge, now trying Dune to solve current linear system...");
                             }
+
+                            if(gpu_mode.compare("cpu") == 0){
+                                OpmLog::warning("cpuSolver did not converge, now trying Dune to solve current linear system...");
+                            }
                         }
 
                         // call Dune
@@ -496,13 +500,6 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
                     auto precond = constructPrecond(linearOperator, parallelInformation_arg);
                     solve(linearOperator, x, istlb, *sp, *precond, result);
                 }
-#else
-                // Construct preconditioner.
-                auto precond = constructPrecond(linearOperator, parallelInformation_arg);
-
-                // Solve.
-                solve(linearOperator, x, istlb, *sp, *precond, result);
-#endif
             }
         }
 
@@ -707,10 +704,13 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
                 if (this->iterations() > 10) {
                     recreate_solver = true;
                 }
-            } else {
-                assert(this->parameters_.cpr_reuse_setup_ == 3);
-                assert(recreate_solver == false);
+            } else if (this->parameters_.cpr_reuse_setup_ == 3) {
                 // Never recreate solver.
+            } else {
+                assert(this->parameters_.cpr_reuse_setup_ == 4);
+                // Recreate solver when the additional iterations since the last
+                // rebuild cost more than the rebuild. All processes must agree.
+                recreate_solver = this->simulator_.gridView().comm().max(static_cast<int>(setupReuse_.rebuildNext())) != 0;
             }
 
             std::function<Vector()> weightsCalculator;
@@ -748,7 +748,10 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
                 }
             }
 
-            if (recreate_solver || !flexibleSolver_) {
+            Dune::Timer setupTimer;
+            setupTimer.start();
+            const bool rebuilt = recreate_solver || !flexibleSolver_;
+            if (rebuilt) {
                 if (isParallel()) {
 #if HAVE_MPI
                     if (useWellConn_) {
@@ -784,6 +787,7 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
             {
                 flexibleSolver_->preconditioner().update();
             }
+            setupReuse_.setupDone(rebuilt, setupTimer.stop());
         }
 
         /// Create sparsity pattern of matrix without off-diagonal ghost entries.
@@ -1034,8 +1038,10 @@ DenseMatrix transposeDenseMatrix(const DenseMatrix& M)
         Matrix* matrix_;
         std::unique_ptr<Matrix> noGhostMat_;
         Vector *rhs_;
+        bool firstcall_ = true;
 
         std::unique_ptr<FlexibleSolverType> flexibleSolver_;
+        AdaptiveSetupReuse setupReuse_;
         std::unique_ptr<AbstractOperatorType> linearOperatorForFlexibleSolver_;
         std::unique_ptr<WellModelAsLinearOperator<WellModel, Vector, Vector>> wellOperator_;
         std::vector<int> overlapRows_;
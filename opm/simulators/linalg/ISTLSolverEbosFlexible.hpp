@@ -23,11 +23,14 @@
 #include <opm/simulators/linalg/matrixblock.hh>
 #include <opm/simulators/linalg/findOverlapRowsAndColumns.hpp>
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/AdaptiveSetupReuse.hpp>
 #include <opm/simulators/linalg/setupPropertyTree.hpp>
 #include <opm/simulators/linalg/WriteSystemMatrixHelper.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
 
+#include <dune/common/timer.hh>
+
 #include <boost/property_tree/json_parser.hpp>
 
 #include <memory>
@@ -132,14 +135,13 @@ public:
     void prepare(SparseMatrixAdapter& mat, VectorType& b)
     {
 #if HAVE_MPI
-        static bool firstcall = true;
-        if (firstcall && parallelInformation_.type() == typeid(ParallelISTLInformation)) {
+        if (firstcall_ && parallelInformation_.type() == typeid(ParallelISTLInformation)) {
             // Parallel case.
             const ParallelISTLInformation* parinfo = std::any_cast<ParallelISTLInformation>(&parallelInformation_);
             assert(parinfo);
             const size_t size = mat.istlMatrix().N();
             parinfo->copyValuesTo(comm_->indexSet(), comm_->remoteIndices(), size, 1);
-            firstcall = false;
+            firstcall_ = false;
         }
         if (isParallel() && matrixAddWellContributions_) {
             makeOverlapRowsInvalid(mat.istlMatrix());
@@ -149,7 +151,10 @@ public:
         matrix_ = &mat.istlMatrix(); // Store pointer for output if needed.
         std::function<VectorType()> weightsCalculator = getWeightsCalculator(mat.istlMatrix(), b);
 
-        if (shouldCreateSolver()) {
+        Dune::Timer setupTimer;
+        setupTimer.start();
+        const bool rebuilt = shouldCreateSolver();
+        if (rebuilt) {
             if (isParallel()) {
 #if HAVE_MPI
                 if (matrixAddWellContributions_) {
@@ -194,11 +199,15 @@ public:
             solver_->preconditioner().update();
             rhs_ = b;
         }
+        setupReuse_.setupDone(rebuilt, setupTimer.stop());
     }
 
     bool solve(VectorType& x)
     {
+        Dune::Timer applyTimer;
+        applyTimer.start();
         solver_->apply(x, rhs_, res_);
+        setupReuse_.solveDone(res_.iterations, applyTimer.stop(), res_.converged);
         this->writeMatrix();
         return res_.converged;
     }
@@ -217,6 +226,11 @@ public:
         return res_.iterations;
     }
 
+    std::string preconditionerName() const
+    {
+        return prm_.get<std::string>("preconditioner.type", "cpr");
+    }
+
     void setResidual(VectorType& /* b */)
     {
         // rhs_ = &b; // Must be handled in prepare() instead.
@@ -251,10 +265,13 @@ protected:
             if (this->iterations() > 10) {
                 recreate_solver = true;
             }
-        } else {
-            assert(this->parameters_.cpr_reuse_setup_ == 3);
-            assert(recreate_solver == false);
+        } else if (this->parameters_.cpr_reuse_setup_ == 3) {
             // Never recreate solver.
+        } else {
+            assert(this->parameters_.cpr_reuse_setup_ == 4);
+            // Recreate solver when the additional iterations since the last
+            // rebuild cost more than the rebuild. All processes must agree.
+            recreate_solver = this->simulator_.gridView().comm().max(static_cast<int>(setupReuse_.rebuildNext())) != 0;
         }
         return recreate_solver;
     }
@@ -340,7 +357,9 @@ protected:
     boost::property_tree::ptree prm_;
     VectorType rhs_;
     Dune::InverseOperatorResult res_;
+    AdaptiveSetupReuse setupReuse_;
     std::any parallelInformation_;
+    bool firstcall_ = true;
     bool ownersFirst_;
     bool matrixAddWellContributions_;
     int interiorCellNum_;
@@ -0,0 +1,146 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+#define OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace Dune
+{
+
+/// A preconditioner which stores its matrix copy and its factors or hierarchy in
+/// a lower precision than the linear system, e.g. float instead of double.
+///
+/// The preconditioner apply is bound by the memory bandwidth, hence halving the
+/// size of the entries roughly halves its cost. The Krylov solver using this
+/// preconditioner still works in the precision of the linear system. Only the
+/// defect and the update are converted when the preconditioner is applied.
+template <class Matrix, class Vector, class LowOperator>
+class MixedPrecisionPreconditioner : public PreconditionerWithUpdate<Vector, Vector>
+{
+public:
+    using LowMatrix = typename LowOperator::matrix_type;
+    using LowVector = typename LowOperator::domain_type;
+    using LowPrecPtr = std::shared_ptr<PreconditionerWithUpdate<LowVector, LowVector>>;
+    using Creator = std::function<LowPrecPtr(const LowOperator&)>;
+
+    /// \param A          the matrix of the linear system, must stay alive.
+    /// \param creator    creates the preconditioner for the low precision operator.
+    /// \param opArgs     further arguments of the low precision operator, e.g. the communication.
+    template <class... OpArgs>
+    MixedPrecisionPreconditioner(const Matrix& A, const Creator& creator, const OpArgs&... opArgs)
+        : A_(A)
+        , lowA_(makeLowMatrix(A))
+        , lowOp_(lowA_, opArgs...)
+        , lowV_(A.N())
+        , lowD_(A.N())
+    {
+        copyValues();
+        lowPrec_ = creator(lowOp_);
+    }
+
+    virtual void pre(Vector& x, Vector& b) override
+    {
+        // the solution stays in full precision, the preconditioners used here
+        // only need the sizes of the vectors.
+        LowVector lowX(x.size());
+        LowVector lowB(b.size());
+        convert(x, lowX);
+        convert(b, lowB);
+        lowPrec_->pre(lowX, lowB);
+    }
+
+    virtual void apply(Vector& v, const Vector& d) override
+    {
+        convert(v, lowV_);
+        convert(d, lowD_);
+        lowPrec_->apply(lowV_, lowD_);
+        convert(lowV_, v);
+    }
+
+    virtual void post(Vector&) override
+    {
+        LowVector lowX(lowV_.size());
+        lowPrec_->post(lowX);
+    }
+
+    virtual SolverCategory::Category category() const override
+    {
+        return lowPrec_->category();
+    }
+
+    virtual void update() override
+    {
+        copyValues();
+        lowPrec_->update();
+    }
+
+private:
+    static LowMatrix makeLowMatrix(const Matrix& A)
+    {
+        LowMatrix lowA(A.N(), A.M(), A.nonzeroes(), LowMatrix::row_wise);
+        for (auto row = lowA.createbegin(); row != lowA.createend(); ++row) {
+            const auto& origRow = A[row.index()];
+            for (auto col = origRow.begin(); col != origRow.end(); ++col) {
+                row.insert(col.index());
+            }
+        }
+        return lowA;
+    }
+
+    void copyValues()
+    {
+        auto lowRow = lowA_.begin();
+        for (auto row = A_.begin(); row != A_.end(); ++row, ++lowRow) {
+            auto lowCol = lowRow->begin();
+            for (auto col = row->begin(); col != row->end(); ++col, ++lowCol) {
+                for (int i = 0; i < Matrix::block_type::rows; ++i) {
+                    for (int j = 0; j < Matrix::block_type::cols; ++j) {
+                        (*lowCol)[i][j] = (*col)[i][j];
+                    }
+                }
+            }
+        }
+    }
+
+    template <class From, class To>
+    static void convert(const From& from, To& to)
+    {
+        for (std::size_t i = 0; i < from.size(); ++i) {
+            for (std::size_t j = 0; j < from[i].size(); ++j) {
+                to[i][j] = from[i][j];
+            }
+        }
+    }
+
+    const Matrix& A_;
+    LowMatrix lowA_;
+    LowOperator lowOp_;
+    LowVector lowV_;
+    LowVector lowD_;
+    LowPrecPtr lowPrec_;
+};
+
+} // namespace Dune
+
+#endif // OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
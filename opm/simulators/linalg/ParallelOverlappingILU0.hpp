@@ -30,11 +30,19 @@
 #include <dune/istl/paamg/graph.hh>
 #include <dune/istl/paamg/pinfo.hh>
 
+#include <algorithm>
 #include <type_traits>
 #include <numeric>
 #include <limits>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Opm
 {
@@ -436,63 +444,230 @@ namespace Opm
         }
     }
 
-    //! Compute Blocked ILU0 decomposition, when we know junk ghost rows are located at the end of A
+    //! Compute the row i of the blocked ILU0 decomposition of A.
+    //! All rows referenced by the lower triangular part of row i need to be decomposed already.
     template<class M>
-    void ghost_last_bilu0_decomposition (M& A, size_t interiorSize)
+    void bilu0_decompose_row (M& A, typename M::size_type i)
     {
         // iterator types
-        typedef typename M::RowIterator rowiterator;
         typedef typename M::ColIterator coliterator;
         typedef typename M::block_type block;
 
+        auto& rowi = A[i];
+
+        // coliterator is diagonal after the following loop
+        coliterator endij=rowi.end();           // end of row i
+        coliterator ij;
+
+        // eliminate entries left of diagonal; store L factor
+        for (ij=rowi.begin(); ij.index()<i; ++ij)
+        {
+            // find A_jj which eliminates A_ij
+            coliterator jj = A[ij.index()].find(ij.index());
+
+            // compute L_ij = A_jj^-1 * A_ij
+            (*ij).rightmultiply(*jj);
+
+            // modify row
+            coliterator endjk=A[ij.index()].end();    // end of row j
+            coliterator jk=jj; ++jk;
+            coliterator ik=ij; ++ik;
+            while (ik!=endij && jk!=endjk)
+                if (ik.index()==jk.index())
+                {
+                    block B(*jk);
+                    B.leftmultiply(*ij);
+                    *ik -= B;
+                    ++ik; ++jk;
+                }
+                else
+                {
+                    if (ik.index()<jk.index())
+                        ++ik;
+                    else
+                        ++jk;
+                }
+        }
+
+        // invert pivot and store it in A
+        if (ij.index()!=i)
+            DUNE_THROW(Dune::ISTLError,"diagonal entry missing");
+        try {
+            (*ij).invert();   // compute inverse of diagonal block
+        }
+        catch (Dune::FMatrixError & e) {
+            DUNE_THROW(Dune::ISTLError,"ILU failed to invert matrix block");
+        }
+    }
+
+    //! Compute Blocked ILU0 decomposition, when we know junk ghost rows are located at the end of A
+    template<class M>
+    void ghost_last_bilu0_decomposition (M& A, size_t interiorSize)
+    {
         // implement left looking variant with stored inverse
-        for (rowiterator i = A.begin(); i.index() < interiorSize; ++i)
+        for (size_t i = 0; i < interiorSize; ++i)
+        {
+            bilu0_decompose_row(A, i);
+        }
+    }
+
+    /// \brief A level schedule of the rows of a triangular sweep.
+    ///
+    /// The rows of a level only depend on rows of previous levels. Hence all rows of
+    /// one level can be processed concurrently.
+    struct LevelSchedule
+    {
+        std::size_t numLevels() const
+        {
+            return levelStart_.empty() ? 0 : levelStart_.size() - 1;
+        }
+
+        //! \brief The start of each level in rows_ (and the end of the last one).
+        std::vector<std::size_t> levelStart_;
+        //! \brief The rows sorted by level.
+        std::vector<std::size_t> rows_;
+    };
+
+    /// \brief Compute the level schedule for a sweep over the rows [begin, end).
+    ///
+    /// The rows are assumed to be processed in increasing order by a serial sweep,
+    /// i.e. row i may only depend on rows j < i. Dependencies outside of [begin, end)
+    /// are ignored.
+    /// \param dependencies Functor called as dependencies(i, f), which has to call f(j)
+    ///        for each row j that row i depends on.
+    template<class Dependencies>
+    LevelSchedule computeLevelSchedule(std::size_t begin, std::size_t end,
+                                       Dependencies dependencies)
+    {
+        LevelSchedule schedule;
+        std::vector<std::size_t> level(end - begin, 0);
+        std::size_t numLevels = 0;
+
+        for (std::size_t i = begin; i < end; ++i)
         {
-            // coliterator is diagonal after the following loop
-            coliterator endij=(*i).end();           // end of row i
-            coliterator ij;
+            std::size_t rowLevel = 0;
+            dependencies(i, [&](std::size_t j)
+                         {
+                             if (j >= begin && j < i)
+                             {
+                                 rowLevel = std::max(rowLevel, level[j - begin] + 1);
+                             }
+                         });
+            level[i - begin] = rowLevel;
+            numLevels = std::max(numLevels, rowLevel + 1);
+        }
 
-            // eliminate entries left of diagonal; store L factor
-            for (ij=(*i).begin(); ij.index()<i.index(); ++ij)
+        // sort the rows by level preserving their order within a level
+        schedule.levelStart_.assign(numLevels + 1, 0);
+        for (const auto rowLevel: level)
+        {
+            ++schedule.levelStart_[rowLevel + 1];
+        }
+        std::partial_sum(schedule.levelStart_.begin(), schedule.levelStart_.end(),
+                         schedule.levelStart_.begin());
+
+        auto next = schedule.levelStart_;
+        schedule.rows_.resize(end - begin);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            schedule.rows_[next[level[i - begin]]++] = i;
+        }
+        return schedule;
+    }
+
+    //! \brief Compute the level schedule for the ILU0 decomposition of the first rows of A.
+    template<class M>
+    LevelSchedule lowerLevelSchedule(const M& A, std::size_t numRows)
+    {
+        return computeLevelSchedule(0, numRows,
+                                    [&A](std::size_t i, const auto& addDependency)
+                                    {
+                                        const auto& row = A[i];
+                                        for (auto col = row.begin(); col.index() < i; ++col)
+                                        {
+                                            addDependency(col.index());
+                                        }
+                                    });
+    }
+
+    //! \brief Compute the blocked ILU0 decomposition of A, processing the rows of each
+    //!        level of the schedule concurrently.
+    template<class M>
+    void level_scheduled_bilu0_decomposition (M& A, const LevelSchedule& schedule)
+    {
+        int failed = 0;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            for (std::size_t level = 0; level < schedule.numLevels(); ++level)
             {
-                // find A_jj which eliminates A_ij
-                coliterator jj = A[ij.index()].find(ij.index());
-                
-                // compute L_ij = A_jj^-1 * A_ij
-                (*ij).rightmultiply(*jj);
-
-                // modify row
-                coliterator endjk=A[ij.index()].end();    // end of row j
-                coliterator jk=jj; ++jk;
-                coliterator ik=ij; ++ik;
-                while (ik!=endij && jk!=endjk)
-                    if (ik.index()==jk.index())
-                    {
-                        block B(*jk);
-                        B.leftmultiply(*ij);
-                        *ik -= B;
-                        ++ik; ++jk;
+                const std::ptrdiff_t levelBegin = schedule.levelStart_[level];
+                const std::ptrdiff_t levelEnd = schedule.levelStart_[level + 1];
+#ifdef _OPENMP
+#pragma omp for
+#endif
+                for (std::ptrdiff_t k = levelBegin; k < levelEnd; ++k)
+                {
+                    // exceptions must not leave the parallel region
+                    try {
+                        bilu0_decompose_row(A, schedule.rows_[k]);
                     }
-                    else
-                    {
-                        if (ik.index()<jk.index())
-                            ++ik;
-                        else
-                            ++jk;
+                    catch (const Dune::Exception&) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                        failed = 1;
                     }
+                }
             }
+        }
+        if (failed)
+        {
+            DUNE_THROW(Dune::MatrixBlockError, "ILU failed to decompose the matrix");
+        }
+    }
 
-            // invert pivot and store it in A
-            if (ij.index()!=i.index())
-                DUNE_THROW(Dune::ISTLError,"diagonal entry missing");
-            try {
-                (*ij).invert();   // compute inverse of diagonal block
-            }
-            catch (Dune::FMatrixError & e) {
-                DUNE_THROW(Dune::ISTLError,"ILU failed to invert matrix block");
+      //! copy the values of the ILU decomposition A to CRS storage created by
+      //! convertToCRS for a matrix with the same sparsity pattern.
+      template<class M, class CRS, class InvVector>
+      void copyValuesToCRS(const M& A, CRS& lower, CRS& upper, InvVector& inv )
+      {
+        typedef typename M :: size_type size_type;
+
+        assert(lower.rows() == A.N() && upper.rows() == A.N() && inv.size() == A.N());
+
+        size_type colcount = 0;
+        const auto endi = A.end();
+        for (auto i=A.begin(); i!=endi; ++i)
+        {
+          const size_type iIndex = i.index();
+          for (auto j=(*i).begin(); j.index() < iIndex; ++j )
+          {
+            lower.values_[ colcount++ ] = (*j);
+          }
+        }
+        assert(colcount == lower.nonZeros());
+
+        const auto rendi = A.beforeBegin();
+        size_type row = 0;
+        colcount = 0;
+        // NOTE: upper and inv store entries in reverse order
+        for (auto i=A.beforeEnd(); i!=rendi; --i, ++ row )
+        {
+          const size_type iIndex = i.index();
+          for (auto j=(*i).beforeEnd(); j.index()>=iIndex; --j )
+          {
+            if( j.index() == iIndex )
+            {
+              inv[ row ] = (*j);
+              break;
             }
+            upper.values_[ colcount++ ] = (*j);
+          }
         }
-    }
+        assert(colcount == upper.nonZeros());
+      }
 
       //! compute ILU decomposition of A. A is overwritten by its decomposition
       template<class M, class CRS, class InvVector>
@@ -851,12 +1026,7 @@ public:
         Range& md = reorderD(d);
         Domain& mv = reorderV(v);
 
-        // iterator types
-        typedef typename Range ::block_type  dblock;
-        typedef typename Domain::block_type  vblock;
-
         const size_type iEnd = lower_.rows();
-        const size_type lastRow = iEnd - 1;
         size_type upperLoppStart = iEnd - interiorSize_;
         size_type lowerLoopEnd = interiorSize_;
         if( iEnd != upper_.rows() )
@@ -864,35 +1034,53 @@ public:
             OPM_THROW(std::logic_error,"ILU: number of lower and upper rows must be the same");
         }
 
-        // lower triangular solve
-        for( size_type i=0; i<lowerLoopEnd; ++ i )
+        if ( useThreads_ )
         {
-          dblock rhs( md[ i ] );
-          const size_type rowI     = lower_.rows_[ i ];
-          const size_type rowINext = lower_.rows_[ i+1 ];
-
-          for( size_type col = rowI; col < rowINext; ++ col )
-          {
-            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
-          }
+            // process the rows of each level concurrently. The implicit barrier at the
+            // end of each worksharing loop separates the levels.
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                for( std::size_t level = 0; level < lowerSchedule_.numLevels(); ++level )
+                {
+                    const std::ptrdiff_t levelBegin = lowerSchedule_.levelStart_[ level ];
+                    const std::ptrdiff_t levelEnd = lowerSchedule_.levelStart_[ level+1 ];
+#ifdef _OPENMP
+#pragma omp for
+#endif
+                    for( std::ptrdiff_t k = levelBegin; k < levelEnd; ++k )
+                    {
+                        lowerSolveRow_( lowerSchedule_.rows_[ k ], md, mv );
+                    }
+                }
 
-          mv[ i ] = rhs;  // Lii = I
+                for( std::size_t level = 0; level < upperSchedule_.numLevels(); ++level )
+                {
+                    const std::ptrdiff_t levelBegin = upperSchedule_.levelStart_[ level ];
+                    const std::ptrdiff_t levelEnd = upperSchedule_.levelStart_[ level+1 ];
+#ifdef _OPENMP
+#pragma omp for
+#endif
+                    for( std::ptrdiff_t k = levelBegin; k < levelEnd; ++k )
+                    {
+                        upperSolveRow_( upperSchedule_.rows_[ k ], mv );
+                    }
+                }
+            }
         }
-
-        for( size_type i=upperLoppStart; i<iEnd; ++ i )
+        else
         {
-            vblock& vBlock = mv[ lastRow - i ];
-            vblock rhs ( vBlock );
-            const size_type rowI     = upper_.rows_[ i ];
-            const size_type rowINext = upper_.rows_[ i+1 ];
-
-            for( size_type col = rowI; col < rowINext; ++ col )
+            // lower triangular solve
+            for( size_type i=0; i<lowerLoopEnd; ++ i )
             {
-                upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
+                lowerSolveRow_( i, md, mv );
             }
 
-            // apply inverse and store result
-            inv_[ i ].mv( rhs, vBlock);
+            for( size_type i=upperLoppStart; i<iEnd; ++ i )
+            {
+                upperSolveRow_( i, mv );
+            }
         }
 
         copyOwnerToAll( mv );
@@ -943,9 +1131,17 @@ public:
         std::string message;
         const int rank = ( comm_ ) ? comm_->communicator().rank() : 0;
 
+        // For ILU0 the sparsity pattern of the decomposition is the one of the
+        // (reordered) matrix. As long as it does not change, we keep the reordered
+        // matrix, the ordering, the index arrays of the CRS storage and the level
+        // schedules and only refill the values.
+        const std::size_t fingerprint = computePatternFingerprint_();
+        const bool reusePattern = iluIteration_ == 0 && ILU0_
+            && ILU0_->N() == A_->N() && ILU0_->nonzeroes() == A_->nonzeroes()
+            && patternFingerprint_ == fingerprint;
         std::unique_ptr< Matrix > ILU;
 
-        if ( redBlack_ )
+        if ( redBlack_ && !reusePattern )
         {
             using Graph = Dune::Amg::MatrixGraph<const Matrix>;
             Graph graph(*A_);
@@ -965,71 +1161,64 @@ public:
             }
         }
 
-        std::vector<std::size_t> inverseOrdering(ordering_.size());
-        std::size_t index = 0;
-        for( auto newIndex: ordering_)
-        {
-            inverseOrdering[newIndex] = index++;
-        }
-
         try
         {
             if( iluIteration_ == 0 ) {
                 // create ILU-0 decomposition
-                if ( ordering_.empty() )
+                if ( !reusePattern )
                 {
-                    ILU.reset( new Matrix( *A_ ) );
-                }
-                else
-                {
-                    ILU.reset( new Matrix(A_->N(), A_->M(), A_->nonzeroes(), Matrix::row_wise));
-                    auto& newA = *ILU;
-                    // Create sparsity pattern
-                    for(auto iter=newA.createbegin(), iend = newA.createend(); iter != iend; ++iter)
-                    {
-                        const auto& row = (*A_)[inverseOrdering[iter.index()]];
-                        for(auto col = row.begin(), cend = row.end(); col != cend; ++col)
-                        {
-                            iter.insert(ordering_[col.index()]);
-                        }
-                    }
-                    // Copy values
-                    for(auto iter = A_->begin(), iend = A_->end(); iter != iend; ++iter)
-                    {
-                        auto& newRow = newA[ordering_[iter.index()]];
-                        for(auto col = iter->begin(), cend = iter->end(); col != cend; ++col)
-                        {
-                            newRow[ordering_[col.index()]] = *col;
-                        }
-                    }
+                    createILU0Pattern_();
+                    patternFingerprint_ = fingerprint;
                 }
+                copyValuesToILU0_();
+                Matrix& ILU0 = *ILU0_;
 
                 switch ( milu_ )
                 {
                 case MILU_VARIANT::MILU_1:
-                    detail::milu0_decomposition ( *ILU);
+                    detail::milu0_decomposition ( ILU0);
                     break;
                 case MILU_VARIANT::MILU_2:
-                    detail::milu0_decomposition ( *ILU, detail::IdentityFunctor(),
+                    detail::milu0_decomposition ( ILU0, detail::IdentityFunctor(),
                                                   detail::SignFunctor() );
                     break;
                 case MILU_VARIANT::MILU_3:
-                    detail::milu0_decomposition ( *ILU, detail::AbsFunctor(),
+                    detail::milu0_decomposition ( ILU0, detail::AbsFunctor(),
                                                   detail::SignFunctor() );
                     break;
                 case MILU_VARIANT::MILU_4:
-                    detail::milu0_decomposition ( *ILU, detail::IdentityFunctor(),
+                    detail::milu0_decomposition ( ILU0, detail::IdentityFunctor(),
                                                   detail::IsPositiveFunctor() );
                     break;
                 default:
+                    if ( threadsAvailable_() )
+                    {
+                        // the lower level schedule of apply is the one of the decomposition
+                        if ( !reusePattern )
+                        {
+                            lowerSchedule_ = detail::lowerLevelSchedule( ILU0, interiorSize_ );
+                        }
+                        if ( worthThreading_( lowerSchedule_ ) )
+                        {
+                            detail::level_scheduled_bilu0_decomposition( ILU0, lowerSchedule_ );
+                            break;
+                        }
+                    }
                     if (interiorSize_ == A_->N())
-                        bilu0_decomposition( *ILU );
+                        bilu0_decomposition( ILU0 );
                     else
-                        detail::ghost_last_bilu0_decomposition(*ILU, interiorSize_);
+                        detail::ghost_last_bilu0_decomposition(ILU0, interiorSize_);
                     break;
                 }
             }
             else {
+                std::vector<std::size_t> inverseOrdering(ordering_.size());
+                std::size_t index = 0;
+                for( auto newIndex: ordering_)
+                {
+                    inverseOrdering[newIndex] = index++;
+                }
+
                 // create ILU-n decomposition
                 ILU.reset( new Matrix( A_->N(), A_->M(), Matrix::row_wise) );
                 std::unique_ptr<detail::Reorderer> reorderer, inverseReorderer;
@@ -1061,14 +1250,211 @@ public:
         const bool local_failure = ilu_setup_successful == 0;
         if ( local_failure || parallel_failure )
         {
+            // the CRS storage might not match the pattern of the reordered matrix
+            ILU0_.reset();
             throw Dune::MatrixBlockError();
         }
 
         // store ILU in simple CRS format
-        detail::convertToCRS( *ILU, lower_, upper_, inv_ );
+        const Matrix& factors = iluIteration_ == 0 ? *ILU0_ : *ILU;
+        if ( reusePattern )
+        {
+            detail::copyValuesToCRS( factors, lower_, upper_, inv_ );
+        }
+        else
+        {
+            detail::convertToCRS( factors, lower_, upper_, inv_ );
+            updateLevelSchedules_();
+        }
     }
 
 protected:
+    /// \brief Create the (reordered) sparsity pattern of the ILU0 decomposition and
+    ///        the map from the blocks of the matrix to the ones of the decomposition.
+    void createILU0Pattern_()
+    {
+        ilu0Blocks_.clear();
+        if ( ordering_.empty() )
+        {
+            ILU0_.reset( new Matrix( *A_ ) );
+            return;
+        }
+
+        std::vector<std::size_t> inverseOrdering(ordering_.size());
+        std::size_t index = 0;
+        for( auto newIndex: ordering_)
+        {
+            inverseOrdering[newIndex] = index++;
+        }
+
+        ILU0_.reset( new Matrix(A_->N(), A_->M(), A_->nonzeroes(), Matrix::row_wise) );
+        auto& newA = *ILU0_;
+        // Create sparsity pattern
+        for(auto iter=newA.createbegin(), iend = newA.createend(); iter != iend; ++iter)
+        {
+            const auto& row = (*A_)[inverseOrdering[iter.index()]];
+            for(auto col = row.begin(), cend = row.end(); col != cend; ++col)
+            {
+                iter.insert(ordering_[col.index()]);
+            }
+        }
+        // The blocks of the reordered matrix in the order of the blocks of A_
+        ilu0Blocks_.reserve(A_->nonzeroes());
+        for(auto iter = A_->begin(), iend = A_->end(); iter != iend; ++iter)
+        {
+            auto& newRow = newA[ordering_[iter.index()]];
+            for(auto col = iter->begin(), cend = iter->end(); col != cend; ++col)
+            {
+                ilu0Blocks_.push_back(&newRow[ordering_[col.index()]]);
+            }
+        }
+    }
+
+    /// \brief Copy the values of the matrix to the ILU0 decomposition, which must
+    ///        have the (reordered) sparsity pattern of the matrix.
+    void copyValuesToILU0_()
+    {
+        if ( ordering_.empty() )
+        {
+            auto newRow = ILU0_->begin();
+            for(auto iter = A_->begin(), iend = A_->end(); iter != iend; ++iter, ++newRow)
+            {
+                std::copy(iter->begin(), iter->end(), newRow->begin());
+            }
+        }
+        else
+        {
+            auto block = ilu0Blocks_.begin();
+            for(auto iter = A_->begin(), iend = A_->end(); iter != iend; ++iter)
+            {
+                for(auto col = iter->begin(), cend = iter->end(); col != cend; ++col, ++block)
+                {
+                    **block = *col;
+                }
+            }
+        }
+    }
+
+    /// \brief A hash of the sparsity pattern of the matrix, i.e. of the row offsets
+    ///        and the column indices.
+    std::size_t computePatternFingerprint_() const
+    {
+        // 64 bit FNV-1a
+        std::uint64_t hash = 14695981039346656037ULL;
+        const auto combine = [&hash](std::uint64_t value)
+        {
+            hash ^= value;
+            hash *= 1099511628211ULL;
+        };
+        std::uint64_t offset = 0;
+        for( auto row = A_->begin(), rend = A_->end(); row != rend; ++row )
+        {
+            offset += row->size();
+            combine( offset );
+            for( auto col = row->begin(), cend = row->end(); col != cend; ++col )
+            {
+                combine( col.index() );
+            }
+        }
+        return hash;
+    }
+
+    /// \brief Solve for row i of the lower triangular factor.
+    void lowerSolveRow_( size_type i, const Range& md, Domain& mv ) const
+    {
+        typename Range::block_type rhs( md[ i ] );
+        const size_type rowI     = lower_.rows_[ i ];
+        const size_type rowINext = lower_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
+        }
+
+        mv[ i ] = rhs;  // Lii = I
+    }
+
+    /// \brief Solve for row i of the upper triangular factor.
+    ///
+    /// The upper factor is stored in reverse row order, i.e. i refers to
+    /// row lower_.rows() - 1 - i of the matrix.
+    void upperSolveRow_( size_type i, Domain& mv ) const
+    {
+        typedef typename Domain::block_type  vblock;
+
+        const size_type lastRow = lower_.rows() - 1;
+        vblock& vBlock = mv[ lastRow - i ];
+        vblock rhs ( vBlock );
+        const size_type rowI     = upper_.rows_[ i ];
+        const size_type rowINext = upper_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
+        }
+
+        // apply inverse and store result
+        inv_[ i ].mv( rhs, vBlock);
+    }
+
+    /// \brief Whether more than one thread may be used.
+    static bool threadsAvailable_()
+    {
+#ifdef _OPENMP
+        return omp_get_max_threads() > 1;
+#else
+        return false;
+#endif
+    }
+
+    /// \brief Whether the levels of a schedule contain enough rows to make
+    ///        processing them concurrently worthwhile.
+    static bool worthThreading_( const detail::LevelSchedule& schedule )
+    {
+        // For a red-black (or any other coloring) ordering the levels coincide
+        // with the colors. For the natural ordering of a structured grid the number of
+        // levels grows with the sum of the grid dimensions.
+        const std::size_t minRowsPerLevel = 64;
+        return schedule.numLevels() > 0
+            && schedule.rows_.size() >= minRowsPerLevel * schedule.numLevels();
+    }
+
+    /// \brief Compute the level schedules of the triangular sweeps in apply.
+    void updateLevelSchedules_()
+    {
+        useThreads_ = false;
+        if ( !threadsAvailable_() || lower_.rows() == 0 )
+        {
+            return;
+        }
+
+        const size_type iEnd = lower_.rows();
+        const size_type lastRow = iEnd - 1;
+
+        lowerSchedule_ = detail::computeLevelSchedule(0, interiorSize_,
+                                                      [this](std::size_t i, const auto& addDependency)
+                                                      {
+                                                          for( size_type col = lower_.rows_[ i ]; col < lower_.rows_[ i+1 ]; ++col )
+                                                          {
+                                                              addDependency( lower_.cols_[ col ] );
+                                                          }
+                                                      });
+
+        // The upper factor is processed in reverse row order and references
+        // the rows of the matrix, which need to be mapped to the positions
+        // within the sweep.
+        upperSchedule_ = detail::computeLevelSchedule(iEnd - interiorSize_, iEnd,
+                                                      [this, lastRow](std::size_t i, const auto& addDependency)
+                                                      {
+                                                          for( size_type col = upper_.rows_[ i ]; col < upper_.rows_[ i+1 ]; ++col )
+                                                          {
+                                                              addDependency( lastRow - upper_.cols_[ col ] );
+                                                          }
+                                                      });
+
+        useThreads_ = worthThreading_( lowerSchedule_ ) && worthThreading_( upperSchedule_ );
+    }
+
     /// \brief Reorder D if needed and return a reference to it.
     Range& reorderD(const Range& d)
     {
@@ -1127,6 +1513,17 @@ protected:
     CRS lower_;
     CRS upper_;
     std::vector< block_type > inv_;
+    //! \brief The level schedules of the lower and upper triangular sweeps.
+    detail::LevelSchedule lowerSchedule_;
+    detail::LevelSchedule upperSchedule_;
+    //! \brief Whether the triangular sweeps are processed level by level using threads.
+    bool useThreads_ = false;
+    //! \brief The (reordered) matrix the ILU0 decomposition is computed in.
+    std::unique_ptr< Matrix > ILU0_;
+    //! \brief The blocks of ILU0_ in the order of the blocks of the matrix, if reordered.
+    std::vector< block_type* > ilu0Blocks_;
+    //! \brief The fingerprint of the sparsity pattern ILU0_ was created for.
+    std::size_t patternFingerprint_ = 0;
     //! \brief the reordering of the unknowns
     std::vector< std::size_t > ordering_;
     //! \brief The reordered right hand side
@@ -0,0 +1,530 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PIPELINEDSOLVERS_HEADER_INCLUDED
+#define OPM_PIPELINEDSOLVERS_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/FusedDotProducts.hpp>
+
+#include <dune/common/timer.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace Dune
+{
+
+/// Pipelined BiCGSTAB, see Cools and Vanroose, "The communication-hiding pipelined
+/// BiCGstab method for the parallel solution of large unsymmetric linear systems",
+/// Parallel Computing 65 (2017).
+///
+/// The method needs two global reductions per iteration instead of the four of
+/// Dune::BiCGSTABSolver, and each reduction is overlapped with an operator and a
+/// preconditioner application. The preconditioner is applied from the right, so
+/// the convergence criterion is the reduction of the unpreconditioned residual as
+/// for Dune::BiCGSTABSolver. To keep the recurred residual close to the true one,
+/// the recurred vectors are replaced by explicitly computed ones from time to time,
+/// and convergence is confirmed with the true residual. The price is a larger
+/// number of work vectors.
+template <class X>
+class PipelinedBiCGSTABSolver : public InverseOperator<X, X>
+{
+public:
+    using field_type = typename X::field_type;
+
+    PipelinedBiCGSTABSolver(LinearOperator<X, X>& op,
+                            FusedDotProducts<X>& dots,
+                            Preconditioner<X, X>& prec,
+                            double reduction,
+                            int maxit,
+                            int verbose)
+        : op_(op)
+        , dots_(dots)
+        , prec_(prec)
+        , reduction_(reduction)
+        , maxit_(maxit)
+        , verbose_(verbose)
+    {
+    }
+
+    void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        apply(x, b, reduction_, res);
+    }
+
+    void apply(X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+        Timer watch;
+        res.clear();
+        prec_.pre(x, b);
+
+        X r(b.size()), r0(b.size()), rh(b.size());
+        X w(b.size()), wh(b.size()), t(b.size()), th(b.size());
+        X ph(b.size()), s(b.size()), sh(b.size()), z(b.size()), zh(b.size());
+        X q(b.size()), qh(b.size()), y(b.size()), yh(b.size()), v(b.size()), vh(b.size());
+        std::vector<field_type> dots;
+        field_type rho = 0.0;
+        field_type alpha = 0.0;
+        field_type beta = 0.0;
+        field_type omega = 0.0;
+
+        // (re)start the recurrences from the true residual r = b - A x and return its
+        // norm. the hatted vectors are the preconditioned ones, e.g. rh = M^{-1} r.
+        const auto restart = [&]() {
+            r = b;
+            op_.applyscaleadd(-1.0, x, r);
+            r0 = r;
+            precondition(rh, r);
+            op_.apply(rh, w);
+            precondition(wh, w);
+            dots_.start({{&r0, &r}, {&r0, &w}, {&r, &r}});
+            op_.apply(wh, t);
+            precondition(th, t);
+            dots = dots_.wait();
+
+            ph = 0.0; s = 0.0; sh = 0.0; z = 0.0; zh = 0.0; v = 0.0; vh = 0.0;
+            rho = dots[0];
+            alpha = dots[1] != 0.0 ? rho / dots[1] : 0.0;
+            beta = 0.0;
+            omega = 0.0;
+            return std::sqrt(dots[2]);
+        };
+
+        // the recurrences of the residual drift further from the true residual than
+        // for Dune::BiCGSTABSolver, see Cools et al., "Analyzing and improving maximal
+        // attainable accuracy in the communication hiding pipelined BiCGStab method",
+        // Parallel Computing 75 (2018). hence the recurred vectors are replaced by
+        // explicitly computed ones whenever the residual has decreased by
+        // residualReplacementReduction, keeping the coefficients.
+        const auto replaceResiduals = [&]() {
+            r = b;
+            op_.applyscaleadd(-1.0, x, r);
+            precondition(rh, r);
+            op_.apply(rh, w);
+            precondition(wh, w);
+            op_.apply(wh, t);
+            precondition(th, t);
+            op_.apply(ph, s);
+            precondition(sh, s);
+            op_.apply(sh, z);
+            precondition(zh, z);
+            op_.apply(zh, v);
+            precondition(vh, v);
+        };
+
+        // in addition convergence is only accepted if the true residual has
+        // converged, too, otherwise the recurrences are restarted from it.
+        const auto trueResidualConverged = [&](field_type& def, const field_type def0,
+                                               const double reduction) {
+            def = restart();
+            if (def < def0 * reduction) {
+                return true;
+            }
+            if (alpha == 0.0) {
+                DUNE_THROW(SolverAbort, "breakdown in PipelinedBiCGSTAB - (r0, w) == 0");
+            }
+            return false;
+        };
+
+        const field_type def0 = restart();
+        field_type def = def0;
+        if (verbose_ > 0) {
+            std::cout << "=== PipelinedBiCGSTABSolver" << std::endl;
+            printOutput(0, def);
+        }
+        if (def0 < 1e-30) {
+            res.converged = true;
+            return finish(x, watch, 0, def0, def, res);
+        }
+        if (alpha == 0.0) {
+            DUNE_THROW(SolverAbort, "breakdown in PipelinedBiCGSTAB - (r0, w) == 0");
+        }
+
+        field_type maxDef = def0;
+        int it = 1;
+        for (; it <= maxit_; ++it) {
+            ph *= beta;
+            ph.axpy(-beta * omega, sh);
+            ph += rh;
+            s *= beta;
+            s.axpy(-beta * omega, z);
+            s += w;
+            sh *= beta;
+            sh.axpy(-beta * omega, zh);
+            sh += wh;
+            z *= beta;
+            z.axpy(-beta * omega, v);
+            z += t;
+            zh *= beta;
+            zh.axpy(-beta * omega, vh);
+            zh += th;
+            q = r;
+            q.axpy(-alpha, s);
+            qh = rh;
+            qh.axpy(-alpha, sh);
+            y = w;
+            y.axpy(-alpha, z);
+            yh = wh;
+            yh.axpy(-alpha, zh);
+
+            dots_.start({{&q, &y}, {&y, &y}, {&q, &q}});
+            op_.apply(zh, v);
+            precondition(vh, v);
+            dots = dots_.wait();
+
+            // converged after the first half step
+            if (std::sqrt(dots[2]) < def0 * reduction) {
+                x.axpy(alpha, ph);
+                res.converged = trueResidualConverged(def, def0, reduction);
+                if (verbose_ > 1) {
+                    printOutput(it, def);
+                }
+                if (res.converged) {
+                    break;
+                }
+                continue;
+            }
+            if (dots[1] == 0.0) {
+                DUNE_THROW(SolverAbort, "breakdown in PipelinedBiCGSTAB - (y, y) == 0");
+            }
+            omega = dots[0] / dots[1];
+            if (omega == 0.0) {
+                DUNE_THROW(SolverAbort, "breakdown in PipelinedBiCGSTAB - omega == 0");
+            }
+
+            x.axpy(alpha, ph);
+            x.axpy(omega, qh);
+            r = q;
+            r.axpy(-omega, y);
+            rh = qh;
+            rh.axpy(-omega, yh);
+            w = y;
+            w.axpy(-omega, t);
+            w.axpy(omega * alpha, v);
+            wh = yh;
+            wh.axpy(-omega, th);
+            wh.axpy(omega * alpha, vh);
+
+            dots_.start({{&r0, &r}, {&r0, &w}, {&r0, &s}, {&r0, &z}, {&r, &r}});
+            op_.apply(wh, t);
+            precondition(th, t);
+            dots = dots_.wait();
+
+            def = std::sqrt(dots[4]);
+            const bool replaceResidual = def < def0 * reduction;
+            if (replaceResidual) {
+                res.converged = trueResidualConverged(def, def0, reduction);
+            }
+            if (verbose_ > 1) {
+                printOutput(it, def);
+            }
+            if (res.converged) {
+                break;
+            }
+            if (replaceResidual) {
+                continue;
+            }
+
+            if (rho == 0.0) {
+                DUNE_THROW(SolverAbort, "breakdown in PipelinedBiCGSTAB - rho == 0");
+            }
+            beta = (alpha / omega) * dots[0] / rho;
+            rho = dots[0];
+            const field_type denominator = dots[1] + beta * dots[2] - beta * omega * dots[3];
+            if (denominator == 0.0) {
+                DUNE_THROW(SolverAbort, "breakdown in PipelinedBiCGSTAB - (r0, s) == 0");
+            }
+            alpha = rho / denominator;
+
+            maxDef = std::max(maxDef, def);
+            if (def < residualReplacementReduction * maxDef) {
+                replaceResiduals();
+                maxDef = def;
+            }
+        }
+
+        finish(x, watch, std::min(it, maxit_), def0, def, res);
+    }
+
+    SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+
+private:
+    void precondition(X& v, const X& d)
+    {
+        v = 0.0;
+        prec_.apply(v, d);
+    }
+
+    void printOutput(const int it, const field_type def) const
+    {
+        std::cout << std::setw(5) << it << "   " << std::scientific << std::setprecision(6) << def << std::endl;
+    }
+
+    void finish(X& x, const Timer& watch, const int it, const field_type def0,
+                const field_type def, InverseOperatorResult& res)
+    {
+        prec_.post(x);
+        res.iterations = it;
+        res.reduction = def0 > 0.0 ? def / def0 : 0.0;
+        res.conv_rate = it > 0 ? std::pow(res.reduction, 1.0 / it) : 0.0;
+        res.elapsed = watch.elapsed();
+        if (verbose_ > 0) {
+            std::cout << "=== rate=" << res.conv_rate << ", T=" << res.elapsed
+                      << ", TIT=" << (it > 0 ? res.elapsed / it : 0.0) << ", IT=" << it << std::endl;
+        }
+    }
+
+    // the decrease of the residual after which the recurred vectors are replaced
+    static constexpr double residualReplacementReduction = 1e-4;
+
+    LinearOperator<X, X>& op_;
+    FusedDotProducts<X>& dots_;
+    Preconditioner<X, X>& prec_;
+    double reduction_;
+    int maxit_;
+    int verbose_;
+};
+
+
+
+/// Restarted GMRES with a number of global reductions per iteration which does
+/// not grow with the size of the Krylov basis.
+///
+/// The new Krylov vector is orthogonalized by classical Gram-Schmidt, where the
+/// projections onto the basis are computed by one reduction, instead of the
+/// modified Gram-Schmidt of Dune::RestartedGMResSolver, which needs k + 2
+/// reductions in the k-th iteration. Since a single classical Gram-Schmidt pass
+/// loses orthogonality, a second pass is done unless the norm of the vector is
+/// largely preserved by the first pass. The norm of the vector is computed by the
+/// same reduction as the projections of the last pass. The preconditioner is
+/// applied from the right, so the convergence criterion is the reduction of the
+/// unpreconditioned residual.
+template <class X>
+class LowSyncGMResSolver : public InverseOperator<X, X>
+{
+public:
+    using field_type = typename X::field_type;
+
+    LowSyncGMResSolver(LinearOperator<X, X>& op,
+                               FusedDotProducts<X>& dots,
+                               Preconditioner<X, X>& prec,
+                               double reduction,
+                               int restart,
+                               int maxit,
+                               int verbose)
+        : op_(op)
+        , dots_(dots)
+        , prec_(prec)
+        , reduction_(reduction)
+        , restart_(restart)
+        , maxit_(maxit)
+        , verbose_(verbose)
+    {
+    }
+
+    void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        apply(x, b, reduction_, res);
+    }
+
+    void apply(X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+        Timer watch;
+        res.clear();
+        prec_.pre(x, b);
+
+        const int m = restart_;
+        std::vector<X> V(m + 1, X(b.size()));
+        std::vector<std::vector<field_type>> H(m + 1, std::vector<field_type>(m, 0.0));
+        std::vector<field_type> g(m + 1), c(m), sn(m);
+        X w(b.size()), z(b.size());
+
+        X& r = V[0];
+        r = b;
+        op_.applyscaleadd(-1.0, x, r);
+        dots_.start({{&r, &r}});
+        const field_type def0 = std::sqrt(dots_.wait()[0]);
+        field_type def = def0;
+        if (verbose_ > 0) {
+            std::cout << "=== LowSyncGMResSolver" << std::endl;
+            printOutput(0, def);
+        }
+
+        int it = 0;
+        bool converged = def0 < 1e-30;
+        while (!converged && it < maxit_) {
+            V[0] *= 1.0 / def;
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = def;
+
+            int j = 0;
+            for (; j < m && it < maxit_; ++j) {
+                ++it;
+                precondition(z, V[j]);
+                op_.apply(z, w);
+
+                const bool breakdown = !orthogonalize(V, j, w, H);
+                if (!breakdown) {
+                    V[j + 1] = w;
+                    V[j + 1] *= 1.0 / H[j + 1][j];
+                }
+
+                // apply the previous rotations to the new column and compute the next one
+                for (int k = 0; k < j; ++k) {
+                    const field_type tmp = c[k] * H[k][j] + sn[k] * H[k + 1][j];
+                    H[k + 1][j] = -sn[k] * H[k][j] + c[k] * H[k + 1][j];
+                    H[k][j] = tmp;
+                }
+                const field_type nu = std::hypot(H[j][j], H[j + 1][j]);
+                c[j] = nu > 0.0 ? H[j][j] / nu : 1.0;
+                sn[j] = nu > 0.0 ? H[j + 1][j] / nu : 0.0;
+                H[j][j] = nu;
+                H[j + 1][j] = 0.0;
+                g[j + 1] = -sn[j] * g[j];
+                g[j] = c[j] * g[j];
+
+                def = std::abs(g[j + 1]);
+                if (verbose_ > 1) {
+                    printOutput(it, def);
+                }
+                if (def < def0 * reduction || breakdown) {
+                    converged = def < def0 * reduction;
+                    ++j;
+                    break;
+                }
+            }
+
+            // x += M^{-1} V y with H y = g
+            std::vector<field_type> yk(j);
+            for (int k = j - 1; k >= 0; --k) {
+                yk[k] = g[k];
+                for (int l = k + 1; l < j; ++l) {
+                    yk[k] -= H[k][l] * yk[l];
+                }
+                yk[k] /= H[k][k];
+            }
+            w = 0.0;
+            for (int k = 0; k < j; ++k) {
+                w.axpy(yk[k], V[k]);
+            }
+            precondition(z, w);
+            x += z;
+
+            if (!converged && it < maxit_) {
+                // restart with the true residual
+                r = b;
+                op_.applyscaleadd(-1.0, x, r);
+                dots_.start({{&r, &r}});
+                def = std::sqrt(dots_.wait()[0]);
+                converged = def < def0 * reduction;
+                if (def == 0.0) {
+                    break;
+                }
+            }
+        }
+
+        res.converged = converged;
+        prec_.post(x);
+        res.iterations = it;
+        res.reduction = def0 > 0.0 ? def / def0 : 0.0;
+        res.conv_rate = it > 0 ? std::pow(res.reduction, 1.0 / it) : 0.0;
+        res.elapsed = watch.elapsed();
+        if (verbose_ > 0) {
+            std::cout << "=== rate=" << res.conv_rate << ", T=" << res.elapsed
+                      << ", TIT=" << (it > 0 ? res.elapsed / it : 0.0) << ", IT=" << it << std::endl;
+        }
+    }
+
+    SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+
+private:
+    // Orthogonalize w against V[0..j] and store the projections and the norm in
+    // column j of H. Returns false if w lies in the span of V[0..j].
+    bool orthogonalize(const std::vector<X>& V, const int j, X& w,
+                       std::vector<std::vector<field_type>>& H)
+    {
+        for (int k = 0; k <= j; ++k) {
+            H[k][j] = 0.0;
+        }
+        field_type norm2 = 0.0;
+        for (int pass = 0; pass < 2; ++pass) {
+            typename FusedDotProducts<X>::Pairs pairs;
+            for (int k = 0; k <= j; ++k) {
+                pairs.emplace_back(&V[k], &w);
+            }
+            pairs.emplace_back(&w, &w);
+            dots_.start(pairs);
+            const auto& dots = dots_.wait();
+
+            field_type projected = 0.0;
+            for (int k = 0; k <= j; ++k) {
+                w.axpy(-dots[k], V[k]);
+                H[k][j] += dots[k];
+                projected += dots[k] * dots[k];
+            }
+            const field_type ww = dots[j + 1];
+            norm2 = ww - projected;
+            // no second pass if the norm is largely preserved, see Daniel et al.,
+            // Math. Comp. 30 (1976)
+            if (norm2 > reorthogonalizationThreshold * ww) {
+                break;
+            }
+        }
+        H[j + 1][j] = norm2 > 0.0 ? std::sqrt(norm2) : 0.0;
+        return H[j + 1][j] > 0.0;
+    }
+
+    void precondition(X& v, const X& d)
+    {
+        v = 0.0;
+        prec_.apply(v, d);
+    }
+
+    void printOutput(const int it, const field_type def) const
+    {
+        std::cout << std::setw(5) << it << "   " << std::scientific << std::setprecision(6) << def << std::endl;
+    }
+
+    static constexpr double reorthogonalizationThreshold = 0.5;
+
+    LinearOperator<X, X>& op_;
+    FusedDotProducts<X>& dots_;
+    Preconditioner<X, X>& prec_;
+    double reduction_;
+    int restart_;
+    int maxit_;
+    int verbose_;
+};
+
+} // namespace Dune
+
+#endif // OPM_PIPELINEDSOLVERS_HEADER_INCLUDED
@@ -22,12 +22,19 @@
 #ifndef OPM_PRECONDITIONERFACTORY_HEADER
 #define OPM_PRECONDITIONERFACTORY_HEADER
 
+#include <opm/simulators/linalg/MixedPrecisionPreconditioner.hpp>
 #include <opm/simulators/linalg/OwningBlockPreconditioner.hpp>
 #include <opm/simulators/linalg/OwningTwoLevelPreconditioner.hpp>
 #include <opm/simulators/linalg/ParallelOverlappingILU0.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
 #include <opm/simulators/linalg/amgcpr.hh>
 
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/schwarz.hh>
 #include <dune/istl/paamg/amg.hh>
 #include <dune/istl/paamg/kamg.hh>
 #include <dune/istl/paamg/fastamg.hh>
@@ -37,6 +44,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 
 namespace Opm
 {
@@ -118,14 +126,21 @@ public:
     }
 
 private:
-    using CriterionBase
-        = Dune::Amg::AggregationCriterion<Dune::Amg::SymmetricMatrixDependency<Matrix, Dune::Amg::FirstDiagonal>>;
-    using Criterion = Dune::Amg::CoarsenCriterion<CriterionBase>;
+    template <class M>
+    using CriterionFor = Dune::Amg::CoarsenCriterion<
+        Dune::Amg::AggregationCriterion<Dune::Amg::SymmetricMatrixDependency<M, Dune::Amg::FirstDiagonal>>>;
+    using Criterion = CriterionFor<Matrix>;
+
+    // Single precision types used by the preconditioners with "precision": "float".
+    using FloatMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<float, Matrix::block_type::rows, Matrix::block_type::cols>>;
+    using FloatVector = Dune::BlockVector<Dune::FieldVector<float, Vector::block_type::dimension>>;
+    using FloatPrecPtr = std::shared_ptr<Dune::PreconditionerWithUpdate<FloatVector, FloatVector>>;
 
     // Helpers for creation of AMG preconditioner.
-    static Criterion amgCriterion(const boost::property_tree::ptree& prm)
+    template <class C = Criterion>
+    static C amgCriterion(const boost::property_tree::ptree& prm)
     {
-        Criterion criterion(15, prm.get<int>("coarsenTarget", 1200));
+        C criterion(15, prm.get<int>("coarsenTarget", 1200));
         criterion.setDefaultValuesIsotropic(2);
         criterion.setAlpha(prm.get<double>("alpha", 0.33));
         criterion.setBeta(prm.get<double>("beta", 1e-5));
@@ -161,10 +176,11 @@ private:
         return smootherArgs;
     }
 
+    template <class M, class V>
     static auto amgSmootherArgs(const boost::property_tree::ptree& prm,
-                                Id<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>>)
+                                Id<Opm::ParallelOverlappingILU0<M, V, V, Comm>>)
     {
-        using Smoother = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>;
+        using Smoother = Opm::ParallelOverlappingILU0<M, V, V, Comm>;
         using SmootherArgs = typename Dune::Amg::SmootherTraits<Smoother>::Arguments;
         SmootherArgs smootherArgs;
         smootherArgs.iterations = prm.get<int>("iterations", 1);
@@ -237,6 +253,88 @@ private:
         }
     }
 
+    // Create a preconditioner which is built and applied in single precision,
+    // the supported types are the ILU variants and AMG with an ILU0 smoother.
+    static PrecPtr createFloatPreconditioner(const Operator& op, const boost::property_tree::ptree& prm)
+    {
+        using FloatOperator = Dune::MatrixAdapter<FloatMatrix, FloatVector, FloatVector>;
+        using MixedPrec = Dune::MixedPrecisionPreconditioner<Matrix, Vector, FloatOperator>;
+        const std::string type = prm.get<std::string>("type", "ParOverILU0");
+        typename MixedPrec::Creator creator;
+        if (type == "ILU0" || type == "ParOverILU0" || type == "ILUn") {
+            const int n = (type == "ILU0") ? 0 : prm.get<int>("ilulevel", 0);
+            const float w = prm.get<double>("relaxation", 1.0);
+            creator = [n, w](const FloatOperator& fop) -> FloatPrecPtr {
+                return std::make_shared<Opm::ParallelOverlappingILU0<FloatMatrix, FloatVector, FloatVector>>(
+                    fop.getmat(), n, w, Opm::MILU_VARIANT::ILU);
+            };
+        } else if (type == "amg" && isIlu0Smoother(prm)) {
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 7)
+            using Smoother = Dune::SeqILU<FloatMatrix, FloatVector, FloatVector>;
+#else
+            using Smoother = Dune::SeqILU0<FloatMatrix, FloatVector, FloatVector>;
+#endif
+            creator = [prm](const FloatOperator& fop) -> FloatPrecPtr {
+                auto crit = amgCriterion<CriterionFor<FloatMatrix>>(prm);
+                auto sargs = amgSmootherArgs<Smoother>(prm);
+                return std::make_shared<Dune::Amg::AMGCPR<FloatOperator, FloatVector, Smoother>>(fop, crit, sargs);
+            };
+        } else {
+            OPM_THROW(std::invalid_argument, "Preconditioner type " << type << " is not available in single precision.");
+        }
+        return std::make_shared<MixedPrec>(op.getmat(), creator);
+    }
+
+    static PrecPtr createFloatPreconditioner(const Operator& op, const boost::property_tree::ptree& prm, const Comm& comm)
+    {
+        using FloatOperator = Dune::OverlappingSchwarzOperator<FloatMatrix, FloatVector, FloatVector, Comm>;
+        using MixedPrec = Dune::MixedPrecisionPreconditioner<Matrix, Vector, FloatOperator>;
+        const std::string type = prm.get<std::string>("type", "ParOverILU0");
+        typename MixedPrec::Creator creator;
+        if (type == "ILU0" || type == "ParOverILU0" || type == "ILUn") {
+            const int n = (type == "ILU0") ? 0 : prm.get<int>("ilulevel", 0);
+            const float w = prm.get<double>("relaxation", 1.0);
+            const bool redblack = prm.get<bool>("redblack", false);
+            const bool reorder_spheres = prm.get<bool>("reorder_spheres", false);
+            creator = [&comm, n, w, redblack, reorder_spheres](const FloatOperator& fop) -> FloatPrecPtr {
+                using ILU = Opm::ParallelOverlappingILU0<FloatMatrix, FloatVector, FloatVector, Comm>;
+                if (n == 0) {
+                    const size_t num_interior = interiorIfGhostLast(comm);
+                    return std::make_shared<ILU>(fop.getmat(), comm, w, Opm::MILU_VARIANT::ILU,
+                                                 num_interior, redblack, reorder_spheres);
+                } else {
+                    return std::make_shared<ILU>(fop.getmat(), comm, n, w, Opm::MILU_VARIANT::ILU,
+                                                 redblack, reorder_spheres);
+                }
+            };
+        } else if (type == "amg" && isIlu0Smoother(prm)) {
+            using Smoother = Opm::ParallelOverlappingILU0<FloatMatrix, FloatVector, FloatVector, Comm>;
+            creator = [&comm, prm](const FloatOperator& fop) -> FloatPrecPtr {
+                auto crit = amgCriterion<CriterionFor<FloatMatrix>>(prm);
+                auto sargs = amgSmootherArgs<Smoother>(prm);
+                return std::make_shared<Dune::Amg::AMGCPR<FloatOperator, FloatVector, Smoother, Comm>>(fop, crit, sargs, comm);
+            };
+        } else {
+            OPM_THROW(std::invalid_argument, "Parallel preconditioner type " << type << " is not available in single precision.");
+        }
+        return std::make_shared<MixedPrec>(op.getmat(), creator, comm);
+    }
+
+    static bool isIlu0Smoother(const boost::property_tree::ptree& prm)
+    {
+        const std::string smoother = prm.get<std::string>("smoother", "ParOverILU0");
+        return smoother == "ILU0" || smoother == "ParOverILU0";
+    }
+
+    static bool useFloat(const boost::property_tree::ptree& prm)
+    {
+        const std::string precision = prm.get<std::string>("precision", "double");
+        if (precision != "double" && precision != "float") {
+            OPM_THROW(std::invalid_argument, "Preconditioner precision " << precision << " is not known, use double or float.");
+        }
+        return precision == "float";
+    }
+
     // Add a useful default set of preconditioners to the factory.
     // This is the default template, used for parallel preconditioners.
     // (Serial specialization below).
@@ -442,6 +540,9 @@ private:
     PrecPtr doCreate(const Operator& op, const boost::property_tree::ptree& prm,
                      const std::function<Vector()> weightsCalculator)
     {
+        if (useFloat(prm)) {
+            return createFloatPreconditioner(op, prm);
+        }
         const std::string& type = prm.get<std::string>("type", "ParOverILU0");
         auto it = creators_.find(type);
         if (it == creators_.end()) {
@@ -459,6 +560,9 @@ private:
     PrecPtr doCreate(const Operator& op, const boost::property_tree::ptree& prm,
                      const std::function<Vector()> weightsCalculator, const Comm& comm)
     {
+        if (useFloat(prm)) {
+            return createFloatPreconditioner(op, prm, comm);
+        }
         const std::string& type = prm.get<std::string>("type", "ParOverILU0");
         auto it = parallel_creators_.find(type);
         if (it == parallel_creators_.end()) {
@@ -0,0 +1,257 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SYSTEMSNAPSHOT_HEADER_INCLUDED
+#define OPM_SYSTEMSNAPSHOT_HEADER_INCLUDED
+
+#include <dune/istl/matrixmarket.hh>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+namespace Helper
+{
+    /// Extension of the binary block-CSR snapshots of a linear system.
+    /// The file holds the header "OPMBCSR1", the block size, the number of block
+    /// rows and of nonzero blocks (int32, uint64, uint64), the row offsets
+    /// (uint64), the column indices (uint32), the blocks in row-major order and
+    /// the right hand side (double).
+    inline const std::string binarySnapshotExtension = ".bcsr";
+
+    namespace detail
+    {
+        inline const char binarySnapshotMagic[8] = {'O', 'P', 'M', 'B', 'C', 'S', 'R', '1'};
+
+        template <class T>
+        void writeArray(std::ofstream& os, const T* data, std::size_t size)
+        {
+            os.write(reinterpret_cast<const char*>(data), size * sizeof(T));
+        }
+
+        template <class T>
+        void readArray(std::ifstream& is, T* data, std::size_t size, const std::string& fileName)
+        {
+            is.read(reinterpret_cast<char*>(data), size * sizeof(T));
+            if (!is)
+                throw std::runtime_error("The snapshot " + fileName + " is truncated");
+        }
+
+        inline bool hasSuffix(const std::string& str, const std::string& suffix)
+        {
+            return str.size() >= suffix.size()
+                && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+    } // namespace detail
+
+    /// Block size of the matrix of a snapshot, either a binary snapshot or a
+    /// Matrix Market file with the "% ISTL_STRUCT blocked" header of dune-istl.
+    inline int snapshotBlockSize(const std::string& fileName)
+    {
+        std::ifstream is(fileName, std::ios::binary);
+        if (!is)
+            throw std::runtime_error("Could not open the snapshot " + fileName);
+
+        if (detail::hasSuffix(fileName, binarySnapshotExtension)) {
+            char magic[sizeof(detail::binarySnapshotMagic)];
+            std::int32_t blockSize = 0;
+            detail::readArray(is, magic, sizeof(magic), fileName);
+            if (std::memcmp(magic, detail::binarySnapshotMagic, sizeof(magic)) != 0)
+                throw std::runtime_error(fileName + " is not a binary snapshot");
+            detail::readArray(is, &blockSize, 1, fileName);
+            return blockSize;
+        }
+
+        std::string line;
+        while (std::getline(is, line) && !line.empty() && line[0] == '%') {
+            std::istringstream header(line);
+            std::string percent, istlStruct, blocked;
+            int rows = 1;
+            if (header >> percent >> istlStruct >> blocked >> rows
+                && istlStruct == "ISTL_STRUCT" && blocked == "blocked")
+                return rows;
+        }
+        return 1;
+    }
+
+    /// Write a linear system to a binary block-CSR snapshot, which is much
+    /// faster to read than the Matrix Market files written by writeSystem().
+    template <class MatrixType, class VectorType>
+    void writeBinarySystem(const std::string& fileName,
+                           const MatrixType& matrix,
+                           const VectorType& rhs)
+    {
+        constexpr int bz = MatrixType::block_type::rows;
+        static_assert(MatrixType::block_type::cols == bz, "Only square blocks are supported");
+
+        std::vector<std::uint64_t> rowStart(1, 0);
+        std::vector<std::uint32_t> cols;
+        std::vector<double> values;
+        rowStart.reserve(matrix.N() + 1);
+        cols.reserve(matrix.nonzeroes());
+        values.reserve(matrix.nonzeroes() * bz * bz);
+        for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                cols.push_back(col.index());
+                for (int i = 0; i < bz; ++i)
+                    for (int j = 0; j < bz; ++j)
+                        values.push_back((*col)[i][j]);
+            }
+            rowStart.push_back(cols.size());
+        }
+
+        std::vector<double> b;
+        b.reserve(rhs.size() * bz);
+        for (const auto& block : rhs)
+            for (int i = 0; i < bz; ++i)
+                b.push_back(block[i]);
+
+        std::ofstream os(fileName, std::ios::binary);
+        if (!os)
+            throw std::runtime_error("Could not create the snapshot " + fileName);
+
+        const std::int32_t blockSize = bz;
+        const std::uint64_t numRows = matrix.N();
+        const std::uint64_t numNonzeroes = cols.size();
+        detail::writeArray(os, detail::binarySnapshotMagic, sizeof(detail::binarySnapshotMagic));
+        detail::writeArray(os, &blockSize, 1);
+        detail::writeArray(os, &numRows, 1);
+        detail::writeArray(os, &numNonzeroes, 1);
+        detail::writeArray(os, rowStart.data(), rowStart.size());
+        detail::writeArray(os, cols.data(), cols.size());
+        detail::writeArray(os, values.data(), values.size());
+        detail::writeArray(os, b.data(), b.size());
+        if (!os)
+            throw std::runtime_error("Could not write the snapshot " + fileName);
+    }
+
+    /// Read a linear system from a binary block-CSR snapshot.
+    template <class MatrixType, class VectorType>
+    void readBinarySystem(const std::string& fileName,
+                          MatrixType& matrix,
+                          VectorType& rhs)
+    {
+        constexpr int bz = MatrixType::block_type::rows;
+
+        std::ifstream is(fileName, std::ios::binary);
+        if (!is)
+            throw std::runtime_error("Could not open the snapshot " + fileName);
+
+        char magic[sizeof(detail::binarySnapshotMagic)];
+        std::int32_t blockSize = 0;
+        std::uint64_t numRows = 0;
+        std::uint64_t numNonzeroes = 0;
+        detail::readArray(is, magic, sizeof(magic), fileName);
+        if (std::memcmp(magic, detail::binarySnapshotMagic, sizeof(magic)) != 0)
+            throw std::runtime_error(fileName + " is not a binary snapshot");
+        detail::readArray(is, &blockSize, 1, fileName);
+        detail::readArray(is, &numRows, 1, fileName);
+        detail::readArray(is, &numNonzeroes, 1, fileName);
+        if (blockSize != bz)
+            throw std::runtime_error("The snapshot " + fileName + " has block size " + std::to_string(blockSize)
+                                     + ", expected " + std::to_string(bz));
+
+        // check the sizes against the size of the file before allocating anything
+        const auto headerEnd = is.tellg();
+        is.seekg(0, std::ios::end);
+        const std::uint64_t remaining = is.tellg() - headerEnd;
+        is.seekg(headerEnd);
+        if (numRows > remaining / sizeof(std::uint64_t) || numNonzeroes > remaining / sizeof(std::uint32_t)
+            || remaining < (numRows + 1) * sizeof(std::uint64_t) + numNonzeroes * sizeof(std::uint32_t)
+                           + (numNonzeroes * bz * bz + numRows * bz) * sizeof(double))
+            throw std::runtime_error("The snapshot " + fileName + " is truncated");
+
+        std::vector<std::uint64_t> rowStart(numRows + 1);
+        std::vector<std::uint32_t> cols(numNonzeroes);
+        detail::readArray(is, rowStart.data(), rowStart.size(), fileName);
+        detail::readArray(is, cols.data(), cols.size(), fileName);
+        if (rowStart.front() != 0 || rowStart.back() != numNonzeroes)
+            throw std::runtime_error("The snapshot " + fileName + " is inconsistent");
+        // the columns of each row must be increasing and within the matrix
+        for (std::uint64_t row = 0; row < numRows; ++row) {
+            if (rowStart[row] > rowStart[row + 1])
+                throw std::runtime_error("The snapshot " + fileName + " is inconsistent");
+            for (auto idx = rowStart[row]; idx < rowStart[row + 1]; ++idx) {
+                if (cols[idx] >= numRows || (idx > rowStart[row] && cols[idx] <= cols[idx - 1]))
+                    throw std::runtime_error("The snapshot " + fileName + " is inconsistent");
+            }
+        }
+
+        matrix = MatrixType(numRows, numRows, numNonzeroes, MatrixType::row_wise);
+        for (auto row = matrix.createbegin(); row != matrix.createend(); ++row) {
+            for (auto idx = rowStart[row.index()]; idx < rowStart[row.index() + 1]; ++idx)
+                row.insert(cols[idx]);
+        }
+
+        // the blocks are stored in the order of the sparsity pattern
+        std::vector<double> values(bz * bz);
+        for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                detail::readArray(is, values.data(), values.size(), fileName);
+                for (int i = 0; i < bz; ++i)
+                    for (int j = 0; j < bz; ++j)
+                        (*col)[i][j] = values[i * bz + j];
+            }
+        }
+
+        rhs.resize(numRows);
+        for (auto& block : rhs) {
+            detail::readArray(is, values.data(), bz, fileName);
+            for (int i = 0; i < bz; ++i)
+                block[i] = values[i];
+        }
+    }
+
+    /// Read a linear system stored by writeSystem() in Matrix Market files or by
+    /// writeBinarySystem(). The rhs file is not used for binary snapshots.
+    template <class MatrixType, class VectorType>
+    void readSystem(const std::string& matrixFile,
+                    const std::string& rhsFile,
+                    MatrixType& matrix,
+                    VectorType& rhs)
+    {
+        if (detail::hasSuffix(matrixFile, binarySnapshotExtension)) {
+            readBinarySystem(matrixFile, matrix, rhs);
+            return;
+        }
+
+        {
+            std::ifstream mfile(matrixFile);
+            if (!mfile)
+                throw std::runtime_error("Could not read the matrix file " + matrixFile);
+            Dune::readMatrixMarket(matrix, mfile);
+        }
+        {
+            std::ifstream rhsfile(rhsFile);
+            if (!rhsfile)
+                throw std::runtime_error("Could not read the rhs file " + rhsFile);
+            Dune::readMatrixMarket(rhs, rhsfile);
+        }
+    }
+
+} // namespace Helper
+} // namespace Opm
+
+#endif // OPM_SYSTEMSNAPSHOT_HEADER_INCLUDED
@@ -56,18 +56,20 @@ BdaBridge<BridgeMatrix, BridgeVector, block_size>::BdaBridge(std::string gpu_mod
 #else
         OPM_THROW(std::logic_error, "Error openclSolver was chosen, but OpenCL was not found by CMake");
 #endif
+    } else if (gpu_mode.compare("cpu") == 0) {
+        use_gpu = true;
+        backend.reset(new bda::cpuSolverBackend<block_size>(linear_solver_verbosity, maxit, tolerance));
     } else if (gpu_mode.compare("none") == 0) {
         use_gpu = false;
     } else {
-        OPM_THROW(std::logic_error, "Error unknown value for parameter 'GpuMode', should be passed like '--gpu-mode=[none|cusparse|opencl]");
+        OPM_THROW(std::logic_error, "Error unknown value for parameter 'GpuMode', should be passed like '--gpu-mode=[none|cpu|cusparse|opencl]");
     }
 }
 
 
 
 template <class BridgeMatrix>
-int checkZeroDiagonal(BridgeMatrix& mat) {
-    static std::vector<typename BridgeMatrix::size_type> diag_indices;   // contains offsets of the diagonal nnzs
+int checkZeroDiagonal(BridgeMatrix& mat, std::vector<typename BridgeMatrix::size_type>& diag_indices) {
     int numZeros = 0;
     const int dim = 3;                    // might be replaced with mat[0][0].N() or BridgeMatrix::block_type::size()
     const double zero_replace = 1e-15;
@@ -139,14 +141,12 @@ void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatri
     if (use_gpu) {
         BdaResult result;
         result.converged = false;
-        static std::vector<int> h_rows;
-        static std::vector<int> h_cols;
         const int dim = (*mat)[0][0].N();
         const int N = mat->N()*dim;
         const int nnz = (h_rows.empty()) ? mat->nonzeroes()*dim*dim : h_rows.back()*dim*dim;
 
         if (dim != 3) {
-            OpmLog::warning("cusparseSolver only accepts blocksize = 3 at this time, will use Dune for the remainder of the program");
+            OpmLog::warning("BdaSolver only accepts blocksize = 3 at this time, will use Dune for the remainder of the program");
             use_gpu = false;
             return;
         }
@@ -167,12 +167,12 @@ void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatri
 
 #if PRINT_TIMERS_BRIDGE
         Dune::Timer t_zeros;
-        int numZeros = checkZeroDiagonal(*mat);
+        int numZeros = checkZeroDiagonal(*mat, diag_indices);
         std::ostringstream out;
         out << "Checking zeros took: " << t_zeros.stop() << " s, found " << numZeros << " zeros";
         OpmLog::info(out.str());
 #else
-        checkZeroDiagonal(*mat);
+        checkZeroDiagonal(*mat, diag_indices);
 #endif
 
 
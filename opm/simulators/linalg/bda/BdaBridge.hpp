@@ -25,7 +25,11 @@
 #include "dune/istl/bcrsmatrix.hh"
 #include <opm/simulators/linalg/matrixblock.hh>
 
+#include <memory>
+#include <vector>
+
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
+#include <opm/simulators/linalg/bda/cpuSolverBackend.hpp>
 
 #if HAVE_CUDA
 #include <opm/simulators/linalg/bda/cusparseSolverBackend.hpp>
@@ -47,10 +51,13 @@ class BdaBridge
 private:
     std::unique_ptr<bda::BdaSolver<block_size> > backend;
     bool use_gpu = false;
+    std::vector<int> h_rows;                                      // rowPointers of the sparsity pattern
+    std::vector<int> h_cols;                                      // colIndices of the sparsity pattern
+    std::vector<typename BridgeMatrix::size_type> diag_indices;   // contains offsets of the diagonal nnzs
 
 public:
     /// Construct a BdaBridge
-    /// \param[in] gpu_mode                   to select if a gpu solver is used, is passed via command-line: '--gpu-mode=[none|cusparse|opencl]'
+    /// \param[in] gpu_mode                   to select if a BdaSolver is used, is passed via command-line: '--gpu-mode=[none|cpu|cusparse|opencl]', 'cpu' runs the BdaSolver on host threads
     /// \param[in] linear_solver_verbosity    verbosity of BdaSolver
     /// \param[in] maxit                      maximum number of iterations for BdaSolver
     /// \param[in] tolerance                  required relative tolerance for BdaSolver
@@ -71,8 +78,8 @@ public:
     /// \param[inout] x    vector x, should be of type Dune::BlockVector
     void get_result(BridgeVector &x);
 
-    /// Return whether the BdaBridge will use the GPU or not
-    /// return whether the BdaBridge will use the GPU or not
+    /// Return whether the BdaBridge will use a BdaSolver (on GPU or CPU) or not
+    /// return whether the BdaBridge will use a BdaSolver or not
     bool getUseGpu(){
         return use_gpu;
     }
@@ -19,6 +19,8 @@
 
 
 #include <config.h> // CMake
+#include <algorithm>
+#include <cassert>
 #include <cstdlib>
 #include <cstring>
 
@@ -38,11 +40,28 @@ WellContributions::WellContributions(std::string gpu_mode){
     if(gpu_mode.compare("opencl") == 0){
         opencl_gpu = true;
     }
+
+    if(gpu_mode.compare("cpu") == 0){
+        cpu_host = true;
+    }
 }
 
 void WellContributions::alloc()
 {
     if (num_std_wells > 0) {
+        if(cpu_host){
+            h_Cnnzs.resize(num_blocks * dim * dim_wells);
+            h_Dnnzs.resize(num_std_wells * dim_wells * dim_wells);
+            h_Bnnzs.resize(num_blocks * dim * dim_wells);
+            h_Ccols.resize(num_blocks);
+            h_Bcols.resize(num_blocks);
+            h_val_pointers.resize(num_std_wells + 1);
+            h_z1.resize(dim_wells);
+            h_z2.resize(dim_wells);
+
+            allocated = true;
+        }
+
 #if HAVE_CUDA
         if(cuda_gpu){
             allocStandardWells();
@@ -63,7 +82,9 @@ void WellContributions::alloc()
 #endif
 
 #if !HAVE_CUDA && !HAVE_OPENCL
-        OPM_THROW(std::logic_error, "Error cannot allocate on GPU because neither CUDA nor OpenCL were found by cmake");
+        if(!cpu_host){
+            OPM_THROW(std::logic_error, "Error cannot allocate on GPU because neither CUDA nor OpenCL were found by cmake");
+        }
 #endif
     }
 }
@@ -185,6 +206,38 @@ void WellContributions::addMatrix([[maybe_unused]] MatrixType type, [[maybe_unus
         OPM_THROW(std::logic_error, "Error cannot add wellcontribution before allocating memory in WellContributions");
     }
 
+    if(cpu_host){
+        switch (type) {
+            case MatrixType::C:
+                std::copy(colIndices, colIndices + val_size, h_Ccols.begin() + num_blocks_so_far);
+                std::copy(values, values + val_size*dim*dim_wells, h_Cnnzs.begin() + num_blocks_so_far*dim*dim_wells);
+                break;
+
+            case MatrixType::D:
+                std::copy(values, values + dim_wells*dim_wells, h_Dnnzs.begin() + num_std_wells_so_far*dim_wells*dim_wells);
+                break;
+
+            case MatrixType::B:
+                std::copy(colIndices, colIndices + val_size, h_Bcols.begin() + num_blocks_so_far);
+                std::copy(values, values + val_size*dim*dim_wells, h_Bnnzs.begin() + num_blocks_so_far*dim*dim_wells);
+                h_val_pointers[num_std_wells_so_far] = num_blocks_so_far;
+
+                if(num_std_wells_so_far == num_std_wells - 1){
+                    h_val_pointers[num_std_wells] = num_blocks;
+                }
+                break;
+
+            default:
+                OPM_THROW(std::logic_error, "Error unsupported matrix ID for WellContributions::addMatrix()");
+        }
+
+        if (MatrixType::B == type) {
+            num_blocks_so_far += val_size;
+            num_std_wells_so_far++;
+        }
+        return;
+    }
+
 #if HAVE_CUDA
     if(cuda_gpu){
         addMatrixGpu(type, colIndices, values, val_size);
@@ -231,6 +284,56 @@ void WellContributions::addMatrix([[maybe_unused]] MatrixType type, [[maybe_unus
 }
 
 
+void WellContributions::applyHost(double *x, double *y)
+{
+    // apply StandardWells, the wells are applied one after another since they can share perforated cells
+    for (unsigned int wellID = 0; wellID < num_std_wells; ++wellID) {
+        const unsigned int blockStart = h_val_pointers[wellID];
+        const unsigned int blockEnd = h_val_pointers[wellID + 1];
+
+        // z1 = B * x
+        std::fill(h_z1.begin(), h_z1.end(), 0.0);
+        for (unsigned int blockID = blockStart; blockID < blockEnd; ++blockID) {
+            const double *B = h_Bnnzs.data() + blockID * dim * dim_wells;
+            const double *xb = x + h_Bcols[blockID] * dim;
+            for (unsigned int row = 0; row < dim_wells; ++row) {
+                for (unsigned int col = 0; col < dim; ++col) {
+                    h_z1[row] += B[row * dim + col] * xb[col];
+                }
+            }
+        }
+
+        // z2 = D^-1 * z1, D is stored inverted
+        const double *D = h_Dnnzs.data() + wellID * dim_wells * dim_wells;
+        for (unsigned int row = 0; row < dim_wells; ++row) {
+            double temp = 0.0;
+            for (unsigned int col = 0; col < dim_wells; ++col) {
+                temp += D[row * dim_wells + col] * h_z1[col];
+            }
+            h_z2[row] = temp;
+        }
+
+        // y -= C^T * z2
+        for (unsigned int blockID = blockStart; blockID < blockEnd; ++blockID) {
+            const double *C = h_Cnnzs.data() + blockID * dim * dim_wells;
+            double *yb = y + h_Ccols[blockID] * dim;
+            for (unsigned int col = 0; col < dim; ++col) {
+                double temp = 0.0;
+                for (unsigned int row = 0; row < dim_wells; ++row) {
+                    temp += C[row * dim + col] * h_z2[row];
+                }
+                yb[col] -= temp;
+            }
+        }
+    }
+
+    // apply MultisegmentWells
+    for (MultisegmentWellContribution *well : multisegments) {
+        well->apply(x, y);
+    }
+}
+
+
 void WellContributions::setBlockSize(unsigned int dim_, unsigned int dim_wells_)
 {
     dim = dim_;
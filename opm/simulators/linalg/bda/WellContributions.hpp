@@ -28,6 +28,7 @@
 #include <opm/simulators/linalg/bda/opencl.hpp>
 #endif
 
+#include <string>
 #include <vector>
 
 #include <opm/simulators/linalg/bda/MultisegmentWellContribution.hpp>
@@ -39,7 +40,7 @@ namespace Opm
 /// This class serves to eliminate the need to include the WellContributions into the matrix (with --matrix-add-well-contributions=true) for the cusparseSolver
 /// If the --matrix-add-well-contributions commandline parameter is true, this class should not be used
 /// So far, StandardWell and MultisegmentWell are supported
-/// StandardWells are only supported for cusparseSolver (CUDA), MultisegmentWells are supported for both cusparseSolver and openclSolver
+/// StandardWells are only supported for cusparseSolver (CUDA) and cpuSolver, MultisegmentWells are supported for cusparseSolver, openclSolver and cpuSolver
 /// A single instance (or pointer) of this class is passed to the BdaSolver.
 /// For StandardWell, this class contains all the data and handles the computation. For MultisegmentWell, the vector 'multisegments' contains all the data. For more information, check the MultisegmentWellContribution class.
 
@@ -82,6 +83,17 @@ private:
 
     bool opencl_gpu = false;
     bool cuda_gpu = false;
+    bool cpu_host = false;
+
+    // data for StandardWells if the BdaSolver runs on the host, could remain empty if not used
+    std::vector<double> h_Cnnzs;
+    std::vector<double> h_Dnnzs;
+    std::vector<double> h_Bnnzs;
+    std::vector<int> h_Ccols;
+    std::vector<int> h_Bcols;
+    std::vector<unsigned int> h_val_pointers;
+    std::vector<double> h_z1;
+    std::vector<double> h_z2;
 
 #if HAVE_CUDA
     cudaStream_t stream;
@@ -165,6 +177,12 @@ public:
     void setKernel(kernel_type *stdwell_apply);
 #endif
 
+    /// Apply all Wells in this object, used by the cpuSolver
+    /// performs y -= (C^T * (D^-1 * (B*x))) for all Wells
+    /// \param[in] x         vector x, in host memory
+    /// \param[inout] y      vector y, in host memory
+    void applyHost(double *x, double *y);
+
     /// Create a new WellContributions
     WellContributions(std::string gpu_mode);
 
@@ -0,0 +1,518 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <dune/common/timer.hh>
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+
+#include <opm/simulators/linalg/bda/cpuSolverBackend.hpp>
+#include <opm/simulators/linalg/bda/BdaResult.hpp>
+#include <opm/simulators/linalg/bda/BlockedMatrix.hpp>
+#include <opm/simulators/linalg/bda/Reorder.hpp>
+
+namespace bda
+{
+
+using Opm::OpmLog;
+using Dune::Timer;
+
+namespace
+{
+
+// y += mat * x, the loops have a fixed trip count so the compiler can unroll and vectorize them
+template <unsigned int bs>
+inline void blockMultVecAdd(const double *mat, const double *x, double *y)
+{
+    for (unsigned int row = 0; row < bs; ++row) {
+        double temp = 0.0;
+        for (unsigned int col = 0; col < bs; ++col) {
+            temp += mat[row * bs + col] * x[col];
+        }
+        y[row] += temp;
+    }
+}
+
+// y -= mat * x
+template <unsigned int bs>
+inline void blockMultVecSub(const double *mat, const double *x, double *y)
+{
+    for (unsigned int row = 0; row < bs; ++row) {
+        double temp = 0.0;
+        for (unsigned int col = 0; col < bs; ++col) {
+            temp += mat[row * bs + col] * x[col];
+        }
+        y[row] -= temp;
+    }
+}
+
+} // anonymous namespace
+
+
+template <unsigned int block_size>
+cpuSolverBackend<block_size>::cpuSolverBackend(int verbosity_, int maxit_, double tolerance_) : BdaSolver<block_size>(verbosity_, maxit_, tolerance_, 0) {
+}
+
+
+template <unsigned int block_size>
+double cpuSolverBackend<block_size>::dot(const double *in1, const double *in2)
+{
+    double sum = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:sum)
+#endif
+    for (int i = 0; i < N; ++i) {
+        sum += in1[i] * in2[i];
+    }
+    return sum;
+}
+
+
+template <unsigned int block_size>
+double cpuSolverBackend<block_size>::norm(const double *in)
+{
+    return std::sqrt(dot(in, in));
+}
+
+
+template <unsigned int block_size>
+void cpuSolverBackend<block_size>::axpy(const double *in, const double a, double *out)
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < N; ++i) {
+        out[i] += a * in[i];
+    }
+}
+
+
+template <unsigned int block_size>
+void cpuSolverBackend<block_size>::custom(double *p_, const double *v_, const double *r_, const double omega, const double beta)
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < N; ++i) {
+        p_[i] = (p_[i] - omega * v_[i]) * beta + r_[i];
+    }
+}
+
+
+template <unsigned int block_size>
+void cpuSolverBackend<block_size>::spmv_blocked(const double *in, double *out)
+{
+    const unsigned int bs = block_size;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int row = 0; row < Nb; ++row) {
+        double temp[bs] = {};
+        for (int k = rows[row]; k < rows[row + 1]; ++k) {
+            blockMultVecAdd<bs>(vals + k * bs * bs, in + cols[k] * bs, temp);
+        }
+        std::copy(temp, temp + bs, out + row * bs);
+    }
+}
+
+
+// the forward substitution processes the levels in order, the backward substitution in reverse order
+// a single parallel region is used, the implicit barrier of each 'omp for' separates the levels
+template <unsigned int block_size>
+void cpuSolverBackend<block_size>::ilu_apply(const double *in, double *out)
+{
+    const unsigned int bs = block_size;
+    const double *LU = LUvals.data();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        // out = L^-1 * in, L has unit diagonal blocks
+        for (int level = 0; level < numLevels; ++level) {
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (int idx = levelPointers[level]; idx < levelPointers[level + 1]; ++idx) {
+                const int row = levelRows[idx];
+                double temp[bs];
+                std::copy(in + row * bs, in + (row + 1) * bs, temp);
+                for (int k = rows[row]; k < diagIndex[row]; ++k) {
+                    blockMultVecSub<bs>(LU + k * bs * bs, out + cols[k] * bs, temp);
+                }
+                std::copy(temp, temp + bs, out + row * bs);
+            }
+        }
+
+        // out = U^-1 * out, the diagonal blocks of U are stored inverted
+        for (int level = numLevels - 1; level >= 0; --level) {
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (int idx = levelPointers[level]; idx < levelPointers[level + 1]; ++idx) {
+                const int row = levelRows[idx];
+                double temp[bs];
+                std::copy(out + row * bs, out + (row + 1) * bs, temp);
+                for (int k = diagIndex[row] + 1; k < rows[row + 1]; ++k) {
+                    blockMultVecSub<bs>(LU + k * bs * bs, out + cols[k] * bs, temp);
+                }
+                std::fill(out + row * bs, out + (row + 1) * bs, 0.0);
+                blockMultVecAdd<bs>(LU + diagIndex[row] * bs * bs, temp, out + row * bs);
+            }
+        }
+    }
+}
+
+
+template <unsigned int block_size>
+void cpuSolverBackend<block_size>::cpu_pbicgstab(WellContributions& wellContribs, BdaResult& res) {
+    float it;
+    double rho, rhop, beta, alpha, omega, tmp1, tmp2;
+    double norm_, norm_0;
+
+    Timer t_total, t_prec(false), t_spmv(false), t_well(false), t_rest(false);
+
+    // set initial values
+    std::fill(x.begin(), x.end(), 0.0);
+    std::fill(p.begin(), p.end(), 0.0);
+    std::fill(v.begin(), v.end(), 0.0);
+    rho = 1.0;
+    alpha = 1.0;
+    omega = 1.0;
+
+    std::copy(b, b + N, r.begin());
+    std::copy(r.begin(), r.end(), rw.begin());
+    std::copy(r.begin(), r.end(), p.begin());
+
+    norm_ = norm(r.data());
+    norm_0 = norm_;
+
+    if (verbosity > 1) {
+        std::ostringstream out;
+        out << std::scientific << "cpuSolver initial norm: " << norm_0;
+        OpmLog::info(out.str());
+    }
+
+    t_rest.start();
+    for (it = 0.5; it < maxit; it += 0.5) {
+        rhop = rho;
+        rho = dot(rw.data(), r.data());
+
+        if (it > 1) {
+            beta = (rho / rhop) * (alpha / omega);
+            custom(p.data(), v.data(), r.data(), omega, beta);
+        }
+        t_rest.stop();
+
+        // pw = prec(p)
+        t_prec.start();
+        ilu_apply(p.data(), pw.data());
+        t_prec.stop();
+
+        // v = A * pw
+        t_spmv.start();
+        spmv_blocked(pw.data(), v.data());
+        t_spmv.stop();
+
+        // apply wellContributions
+        t_well.start();
+        wellContribs.applyHost(pw.data(), v.data());
+        t_well.stop();
+
+        t_rest.start();
+        tmp1 = dot(rw.data(), v.data());
+        alpha = rho / tmp1;
+        axpy(v.data(), -alpha, r.data());      // r = r - alpha * v
+        axpy(pw.data(), alpha, x.data());      // x = x + alpha * pw
+        norm_ = norm(r.data());
+        t_rest.stop();
+
+        if (norm_ < tolerance * norm_0) {
+            break;
+        }
+
+        it += 0.5;
+
+        // s = prec(r)
+        t_prec.start();
+        ilu_apply(r.data(), s.data());
+        t_prec.stop();
+
+        // t = A * s
+        t_spmv.start();
+        spmv_blocked(s.data(), t.data());
+        t_spmv.stop();
+
+        // apply wellContributions
+        t_well.start();
+        wellContribs.applyHost(s.data(), t.data());
+        t_well.stop();
+
+        t_rest.start();
+        tmp1 = dot(t.data(), r.data());
+        tmp2 = dot(t.data(), t.data());
+        omega = tmp1 / tmp2;
+        axpy(s.data(), omega, x.data());     // x = x + omega * s
+        axpy(t.data(), -omega, r.data());    // r = r - omega * t
+        norm_ = norm(r.data());
+        t_rest.stop();
+
+        if (norm_ < tolerance * norm_0) {
+            break;
+        }
+
+        if (verbosity > 1) {
+            std::ostringstream out;
+            out << "it: " << it << std::scientific << ", norm: " << norm_;
+            OpmLog::info(out.str());
+        }
+    }
+
+    res.iterations = std::min(it, (float)maxit);
+    res.reduction = norm_ / norm_0;
+    res.conv_rate  = static_cast<double>(pow(res.reduction, 1.0 / it));
+    res.elapsed = t_total.stop();
+    res.converged = (it != (maxit + 0.5));
+
+    if (verbosity > 0) {
+        std::ostringstream out;
+        out << "=== converged: " << res.converged << ", conv_rate: " << res.conv_rate << ", time: " << res.elapsed << \
+            ", time per iteration: " << res.elapsed / it << ", iterations: " << it;
+        OpmLog::info(out.str());
+    }
+    if (verbosity >= 4) {
+        std::ostringstream out;
+        out << "cpuSolver::ilu_apply:      " << t_prec.elapsed() << " s\n";
+        out << "wellContributions::apply:  " << t_well.elapsed() << " s\n";
+        out << "cpuSolver::spmv:           " << t_spmv.elapsed() << " s\n";
+        out << "cpuSolver::rest:           " << t_rest.elapsed() << " s\n";
+        out << "cpuSolver::total_solve:    " << res.elapsed << " s\n";
+        OpmLog::info(out.str());
+    }
+}
+
+
+template <unsigned int block_size>
+void cpuSolverBackend<block_size>::initialize(int N_, int nnz_, int dim) {
+    this->N = N_;
+    this->nnz = nnz_;
+    this->nnzb = nnz_ / block_size / block_size;
+
+    Nb = (N + dim - 1) / dim;
+    std::ostringstream out;
+    out << "Initializing cpuSolver, matrix size: " << N << " blocks, nnzb: " << nnzb << "\n";
+    out << "Maxit: " << maxit << std::scientific << ", tolerance: " << tolerance << "\n";
+    OpmLog::info(out.str());
+
+    x.resize(N);
+    r.resize(N);
+    rw.resize(N);
+    p.resize(N);
+    pw.resize(N);
+    s.resize(N);
+    t.resize(N);
+    v.resize(N);
+
+    LUvals.resize(nnz);
+    diagIndex.resize(Nb);
+
+    initialized = true;
+} // end initialize()
+
+
+template <unsigned int block_size>
+bool cpuSolverBackend<block_size>::analyse_matrix() {
+    Timer t_analysis;
+
+    for (int row = 0; row < Nb; ++row) {
+        const int *rowStart = cols + rows[row];
+        const int *rowEnd = cols + rows[row + 1];
+        const int *diag = std::lower_bound(rowStart, rowEnd, row);
+        if (diag == rowEnd || *diag != row) {
+            std::ostringstream out;
+            out << "cpuSolver Error could not find diagonal value in row: " << row;
+            OpmLog::error(out.str());
+            return false;
+        }
+        diagIndex[row] = diag - cols;
+    }
+
+    // the levels of the lower triangular part are used for both substitutions,
+    // this assumes a structurally symmetric matrix, like BILU0 does
+    std::vector<int> CSCRowIndices(nnzb);
+    std::vector<int> CSCColPointers(Nb + 1);
+    std::vector<int> toOrder(Nb);
+    std::vector<int> rowsPerLevel;
+    levelRows.resize(Nb);
+    csrPatternToCsc(cols, rows, CSCRowIndices.data(), CSCColPointers.data(), Nb);
+    findLevelScheduling(cols, rows, CSCRowIndices.data(), CSCColPointers.data(), Nb, &numLevels, toOrder.data(), levelRows.data(), rowsPerLevel);
+
+    levelPointers.resize(numLevels + 1);
+    levelPointers[0] = 0;
+    for (int level = 0; level < numLevels; ++level) {
+        levelPointers[level + 1] = levelPointers[level] + rowsPerLevel[level];
+    }
+
+    if (verbosity > 2) {
+        std::ostringstream out;
+        out << "cpuSolver::analyse_matrix(): " << t_analysis.stop() << " s, " << numLevels << " levels";
+        OpmLog::info(out.str());
+    }
+
+    analysis_done = true;
+
+    return true;
+} // end analyse_matrix()
+
+
+template <unsigned int block_size>
+bool cpuSolverBackend<block_size>::create_preconditioner() {
+    const unsigned int bs = block_size;
+    Timer t_decomposition;
+
+    std::copy(vals, vals + nnz, LUvals.begin());
+    double *LU = LUvals.data();
+    int numFailed = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Opm::Detail::Inverter<bs> inverter;
+        double pivot[bs * bs];
+        double diag[bs * bs];
+
+        for (int level = 0; level < numLevels; ++level) {
+#ifdef _OPENMP
+#pragma omp for reduction(+:numFailed)
+#endif
+            for (int idx = levelPointers[level]; idx < levelPointers[level + 1]; ++idx) {
+                const int i = levelRows[idx];
+                const int iRowEnd = rows[i + 1];
+
+                // all rows j < i that row i depends on are in an earlier level, and are decomposed already
+                for (int ij = rows[i]; ij < diagIndex[i]; ++ij) {
+                    const int j = cols[ij];
+                    // calculate the pivot of this row, the diagonal of row j is stored inverted
+                    blockMult<bs>(LU + ij * bs * bs, LU + diagIndex[j] * bs * bs, pivot);
+                    std::memcpy(LU + ij * bs * bs, pivot, sizeof(double) * bs * bs);
+
+                    // subtract row j scaled by the pivot from this row
+                    const int jRowEnd = rows[j + 1];
+                    int jk = diagIndex[j] + 1;
+                    int ik = ij + 1;
+                    while (ik < iRowEnd && jk < jRowEnd) {
+                        if (cols[ik] == cols[jk]) {
+                            blockMultSub<bs>(LU + ik * bs * bs, pivot, LU + jk * bs * bs);
+                            ik++;
+                            jk++;
+                        } else if (cols[ik] < cols[jk]) {
+                            ik++;
+                        } else {
+                            jk++;
+                        }
+                    }
+                }
+
+                // store the inverse in the diagonal
+                double *diagBlock = LU + diagIndex[i] * bs * bs;
+                std::memcpy(diag, diagBlock, sizeof(double) * bs * bs);
+                inverter(diag, diagBlock);
+                if (!std::all_of(diagBlock, diagBlock + bs * bs, [](double val) { return std::isfinite(val); })) {
+                    numFailed++;
+                }
+            }
+        }
+    }
+
+    if (verbosity > 2) {
+        std::ostringstream out;
+        out << "cpuSolver::create_preconditioner(): " << t_decomposition.stop() << " s";
+        OpmLog::info(out.str());
+    }
+
+    if (numFailed > 0) {
+        std::ostringstream out;
+        out << "cpuSolver Error could not invert " << numFailed << " diagonal blocks of BILU0";
+        OpmLog::error(out.str());
+        return false;
+    }
+    return true;
+} // end create_preconditioner()
+
+
+template <unsigned int block_size>
+void cpuSolverBackend<block_size>::get_result(double *x_) {
+    std::copy(x.begin(), x.end(), x_);
+} // end get_result()
+
+
+template <unsigned int block_size>
+SolverStatus cpuSolverBackend<block_size>::solve_system(int N_, int nnz_, int dim, double *vals_, int *rows_, int *cols_, double *b_, WellContributions& wellContribs, BdaResult &res) {
+    if (initialized == false) {
+        initialize(N_, nnz_, dim);
+    }
+
+    // the sparsity pattern is assumed to stay the same, only the pointers to the values might change
+    this->vals = vals_;
+    this->rows = rows_;
+    this->cols = cols_;
+    this->b = b_;
+
+    if (analysis_done == false) {
+        if (!analyse_matrix()) {
+            return SolverStatus::BDA_SOLVER_ANALYSIS_FAILED;
+        }
+    }
+    if (!create_preconditioner()) {
+        return SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+    }
+
+    Timer t_solve;
+    cpu_pbicgstab(wellContribs, res);
+
+    if (verbosity > 2) {
+        std::ostringstream out;
+        out << "cpuSolver::solve_system(): " << t_solve.stop() << " s";
+        OpmLog::info(out.str());
+    }
+
+    return SolverStatus::BDA_SOLVER_SUCCESS;
+}
+
+
+#define INSTANTIATE_BDA_FUNCTIONS(n)                                                  \
+template cpuSolverBackend<n>::cpuSolverBackend(int, int, double);                     \
+template SolverStatus cpuSolverBackend<n>::solve_system(int, int, int, double*, int*, int*, double*, WellContributions&, BdaResult&); \
+template void cpuSolverBackend<n>::get_result(double*);                               \
+
+INSTANTIATE_BDA_FUNCTIONS(1);
+INSTANTIATE_BDA_FUNCTIONS(2);
+INSTANTIATE_BDA_FUNCTIONS(3);
+INSTANTIATE_BDA_FUNCTIONS(4);
+
+#undef INSTANTIATE_BDA_FUNCTIONS
+
+} // namespace bda
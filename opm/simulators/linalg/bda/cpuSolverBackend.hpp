@@ -0,0 +1,161 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CPUSOLVER_BACKEND_HEADER_INCLUDED
+#define OPM_CPUSOLVER_BACKEND_HEADER_INCLUDED
+
+#include <vector>
+
+#include <opm/simulators/linalg/bda/BdaResult.hpp>
+#include <opm/simulators/linalg/bda/BdaSolver.hpp>
+#include <opm/simulators/linalg/bda/WellContributions.hpp>
+
+namespace bda
+{
+
+/// This class implements a blocked ilu0-bicgstab solver on the host, using OpenMP threads
+/// The matrix is not copied, the solver works directly on the arrays that are passed to solve_system()
+/// The rows of the matrix are not reordered either, the BILU0 decomposition and application
+/// are parallelized by level scheduling, so the preconditioner equals a sequential ILU0
+template <unsigned int block_size>
+class cpuSolverBackend : public BdaSolver<block_size>
+{
+
+    typedef BdaSolver<block_size> Base;
+
+    using Base::N;
+    using Base::Nb;
+    using Base::nnz;
+    using Base::nnzb;
+    using Base::verbosity;
+    using Base::maxit;
+    using Base::tolerance;
+    using Base::initialized;
+
+private:
+
+    // matrix and right-hand side, these point to memory owned by the caller
+    double *vals = nullptr;
+    int *rows = nullptr;
+    int *cols = nullptr;
+    double *b = nullptr;
+
+    // vectors, used during linear solve
+    std::vector<double> x, r, rw, p, pw, s, t, v;
+
+    // BILU0 decomposition, stored with the sparsity pattern of the matrix
+    // the diagonal blocks contain the inverse of the diagonal of U
+    std::vector<double> LUvals;
+    std::vector<int> diagIndex;
+
+    // level scheduling: the rows in level l are levelRows[levelPointers[l]] until levelRows[levelPointers[l+1]]
+    std::vector<int> levelRows;
+    std::vector<int> levelPointers;
+    int numLevels = 0;
+
+    bool analysis_done = false;
+
+    /// Calculate dot product between in1 and in2
+    /// \param[in] in1           input vector 1
+    /// \param[in] in2           input vector 2
+    /// \return                  dot product
+    double dot(const double *in1, const double *in2);
+
+    /// Calculate the norm of in
+    /// Equal to Dune::DenseVector::two_norm()
+    /// \param[in] in          input vector
+    /// \return                norm
+    double norm(const double *in);
+
+    /// Perform axpy: out += a * in
+    /// \param[in] in         input vector
+    /// \param[in] a          scalar value to multiply input vector
+    /// \param[inout] out     output vector
+    void axpy(const double *in, const double a, double *out);
+
+    /// Custom function that combines scale, axpy and add functions in bicgstab
+    /// p = (p - omega * v) * beta + r
+    /// \param[inout] p      output vector
+    /// \param[in] v         input vector
+    /// \param[in] r         input vector
+    /// \param[in] omega     scalar value
+    /// \param[in] beta      scalar value
+    void custom(double *p, const double *v, const double *r, const double omega, const double beta);
+
+    /// Sparse matrix-vector multiply, spmv
+    /// out = A * in
+    /// \param[in] in        input vector
+    /// \param[out] out      output vector
+    void spmv_blocked(const double *in, double *out);
+
+    /// Apply the BILU0 preconditioner, out = (LU)^-1 * in
+    /// \param[in] in        input vector
+    /// \param[out] out      output vector
+    void ilu_apply(const double *in, double *out);
+
+    /// Solve linear system using ilu0-bicgstab
+    /// \param[in] wellContribs   WellContributions, to apply them separately, instead of adding them to matrix A
+    /// \param[inout] res         summary of solver result
+    void cpu_pbicgstab(WellContributions& wellContribs, BdaResult& res);
+
+    /// Allocate memory for the vectors and the preconditioner
+    /// \param[in] N              number of rows, divide by dim to get number of blockrows
+    /// \param[in] nnz            number of nonzeroes, divide by dim*dim to get number of blocks
+    /// \param[in] dim            size of block
+    void initialize(int N, int nnz, int dim);
+
+    /// Analyse sparsity pattern to find the levels for the BILU0
+    /// \return true iff analysis was successful
+    bool analyse_matrix();
+
+    /// Perform ilu0-decomposition
+    /// \return true iff decomposition was successful
+    bool create_preconditioner();
+
+public:
+
+    /// Construct a cpuSolver
+    /// \param[in] linear_solver_verbosity    verbosity of cpuSolver
+    /// \param[in] maxit                      maximum number of iterations for cpuSolver
+    /// \param[in] tolerance                  required relative tolerance for cpuSolver
+    cpuSolverBackend(int linear_solver_verbosity, int maxit, double tolerance);
+
+    /// Solve linear system, A*x = b, matrix A must be in blocked-CSR format
+    /// The arrays are not copied, they must stay valid until get_result() is called
+    /// \param[in] N              number of rows, divide by dim to get number of blockrows
+    /// \param[in] nnz            number of nonzeroes, divide by dim*dim to get number of blocks
+    /// \param[in] dim            size of block
+    /// \param[in] vals           array of nonzeroes, each block is stored row-wise and contiguous, contains nnz values
+    /// \param[in] rows           array of rowPointers, contains N/dim+1 values
+    /// \param[in] cols           array of columnIndices, contains nnz values
+    /// \param[in] b              input vector, contains N values
+    /// \param[in] wellContribs   WellContributions, to apply them separately, instead of adding them to matrix A
+    /// \param[inout] res         summary of solver result
+    /// \return                   status code
+    SolverStatus solve_system(int N, int nnz, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs, BdaResult &res) override;
+
+    /// Get result after linear solve
+    /// \param[inout] x          resulting x vector, caller must guarantee that x points to a valid array
+    void get_result(double *x) override;
+
+}; // end class cpuSolverBackend
+
+} // namespace bda
+
+#endif
@@ -20,10 +20,19 @@
 #ifndef OPM_GET_QUASI_IMPES_WEIGHTS_HEADER_INCLUDED
 #define OPM_GET_QUASI_IMPES_WEIGHTS_HEADER_INCLUDED
 
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+#include <opm/models/parallel/threadedentityiterator.hh>
+
+#include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
 
 #include <algorithm>
 #include <cmath>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Opm
 {
@@ -40,6 +49,34 @@ namespace Details
 
         return tmp;
     }
+
+    /// Solve D^T w = e_p, or D w = e_p if transpose is true. The solution is row
+    /// (column) p of the inverse of D, which uses the closed form inverses for
+    /// blocks up to 4x4. Singular blocks fall back to the pivoting dense solver.
+    template <class MatrixBlockType, class VectorBlockType>
+    void solvePressureRow(const MatrixBlockType& D, const int pressureVarIndex,
+                          const bool transpose, VectorBlockType& w)
+    {
+        constexpr int n = MatrixBlockType::rows;
+        using K = typename MatrixBlockType::field_type;
+        if constexpr (n <= 4) {
+            Dune::FieldMatrix<K, n, n> inverse;
+            const Dune::FieldMatrix<K, n, n>& block = D;
+            const K det = Dune::FMatrixHelp::invertMatrix(block, inverse);
+            if (det != 0.0 && std::isfinite(det)) {
+                for (int k = 0; k < n; ++k)
+                    w[k] = transpose ? inverse[k][pressureVarIndex] : inverse[pressureVarIndex][k];
+                return;
+            }
+        }
+
+        VectorBlockType rhs(0.0);
+        rhs[pressureVarIndex] = 1.0;
+        if (transpose)
+            D.solve(w, rhs);
+        else
+            transposeDenseMatrix(D).solve(w, rhs);
+    }
 } // namespace Details
 
 namespace Amg
@@ -50,31 +87,41 @@ namespace Amg
         using VectorBlockType = typename Vector::block_type;
         using MatrixBlockType = typename Matrix::block_type;
         const Matrix& A = matrix;
-        VectorBlockType rhs(0.0);
-        rhs[pressureVarIndex] = 1.0;
-        const auto endi = A.end();
-        for (auto i = A.begin(); i != endi; ++i) {
-            const auto endj = (*i).end();
-            MatrixBlockType diag_block(0.0);
-            for (auto j = (*i).begin(); j != endj; ++j) {
-                if (i.index() == j.index()) {
-                    diag_block = (*j);
-                    break;
-                }
+        const int numRows = A.N();
+        std::exception_ptr exceptionPtr;
+
+        // the rows are independent
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int row = 0; row < numRows; ++row) {
+            try {
+                const auto& rowEntries = A[row];
+                const auto diag = rowEntries.find(row);
+                MatrixBlockType diag_block(0.0);
+                if (diag != rowEntries.end())
+                    diag_block = *diag;
+
+                VectorBlockType bweights;
+                Details::solvePressureRow(diag_block, pressureVarIndex, transpose, bweights);
+                double abs_max = *std::max_element(
+                    bweights.begin(), bweights.end(), [](double a, double b) { return std::fabs(a) < std::fabs(b); });
+                bweights /= std::fabs(abs_max);
+                weights[row] = bweights;
             }
-            VectorBlockType bweights;
-            if (transpose) {
-                diag_block.solve(bweights, rhs);
-            } else {
-                auto diag_block_transpose = Opm::Details::transposeDenseMatrix(diag_block);
-                diag_block_transpose.solve(bweights, rhs);
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                {
+                    if (!exceptionPtr)
+                        exceptionPtr = std::current_exception();
+                }
             }
-            double abs_max = *std::max_element(
-                bweights.begin(), bweights.end(), [](double a, double b) { return std::fabs(a) < std::fabs(b); });
-            bweights /= std::fabs(abs_max);
-            weights[i.index()] = bweights;
         }
-        // return weights;
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
     }
 
     template <class Matrix, class Vector>
@@ -95,36 +142,61 @@ namespace Amg
         constexpr int numEq = VectorBlockType::size();
         using Evaluation = typename std::decay_t<decltype(model.localLinearizer(threadId).localResidual().residual(0))>
             ::block_type;
-        VectorBlockType rhs(0.0);
-        rhs[pressureVarIndex] = 1.0;
-        int index = 0;
-        auto elemIt = gridView.template begin</*codim=*/0>();
-        const auto& elemEndIt = gridView.template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            elemCtx.updatePrimaryStencil(*elemIt);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-            Dune::FieldVector<Evaluation, numEq> storage;
-            model.localLinearizer(threadId).localResidual().computeStorage(storage,elemCtx,/*spaceIdx=*/0, /*timeIdx=*/0);
-            auto extrusionFactor = elemCtx.intensiveQuantities(0, /*timeIdx=*/0).extrusionFactor();
-            auto scvVolume = elemCtx.stencil(/*timeIdx=*/0).subControlVolume(0).volume() * extrusionFactor;
-            auto storage_scale = scvVolume / elemCtx.simulator().timeStepSize();
-            MatrixBlockType block;
-            double pressure_scale = 50e5;
-            for (int ii = 0; ii < numEq; ++ii) {
-                for (int jj = 0; jj < numEq; ++jj) {
-                    block[ii][jj] = storage[ii].derivative(jj)/storage_scale;
-                    if (jj == pressureVarIndex) {
-                        block[ii][jj] *= pressure_scale;
+        Opm::ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+        std::exception_ptr exceptionPtr;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            // every thread needs its own element context and local linearizer
+#ifdef _OPENMP
+            const std::size_t localThreadId = omp_get_thread_num();
+            ElementContext localElemCtx(elemCtx.simulator());
+#else
+            const std::size_t localThreadId = threadId;
+            ElementContext& localElemCtx = elemCtx;
+#endif
+            const auto& localResidual = model.localLinearizer(localThreadId).localResidual();
+            try {
+                auto elemIt = threadedElemIt.beginParallel();
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    localElemCtx.updatePrimaryStencil(*elemIt);
+                    localElemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    Dune::FieldVector<Evaluation, numEq> storage;
+                    localResidual.computeStorage(storage, localElemCtx, /*spaceIdx=*/0, /*timeIdx=*/0);
+                    auto extrusionFactor = localElemCtx.intensiveQuantities(0, /*timeIdx=*/0).extrusionFactor();
+                    auto scvVolume = localElemCtx.stencil(/*timeIdx=*/0).subControlVolume(0).volume() * extrusionFactor;
+                    auto storage_scale = scvVolume / localElemCtx.simulator().timeStepSize();
+                    MatrixBlockType block;
+                    double pressure_scale = 50e5;
+                    for (int ii = 0; ii < numEq; ++ii) {
+                        for (int jj = 0; jj < numEq; ++jj) {
+                            block[ii][jj] = storage[ii].derivative(jj)/storage_scale;
+                            if (jj == pressureVarIndex) {
+                                block[ii][jj] *= pressure_scale;
+                            }
+                        }
                     }
+                    VectorBlockType bweights;
+                    Details::solvePressureRow(block, pressureVarIndex, /*transpose=*/false, bweights);
+                    bweights /= 1000.0; // given normal densities this scales weights to about 1.
+                    weights[localElemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0)] = bweights;
+                }
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                {
+                    if (!exceptionPtr)
+                        exceptionPtr = std::current_exception();
                 }
             }
-            VectorBlockType bweights;
-            MatrixBlockType block_transpose = Details::transposeDenseMatrix(block);
-            block_transpose.solve(bweights, rhs);
-            bweights /= 1000.0; // given normal densities this scales weights to about 1.
-            weights[index] = bweights;
-            ++index;
         }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
     }
 } // namespace Amg
 
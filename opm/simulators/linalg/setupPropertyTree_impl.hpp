@@ -81,6 +81,7 @@ setupPropertyTree(const FlowLinearSolverParameters& p)
             }
             prm.put("preconditioner.finesmoother.type", "ParOverILU0");
             prm.put("preconditioner.finesmoother.relaxation", 1.0);
+            prm.put("preconditioner.finesmoother.precision", p.preconditioner_precision_);
             prm.put("preconditioner.pressure_var_index",1);
             prm.put("preconditioner.verbosity",0);
             prm.put("preconditioner.coarsesolver.maxiter",1);
@@ -101,6 +102,7 @@ setupPropertyTree(const FlowLinearSolverParameters& p)
             prm.put("preconditioner.coarsesolver.preconditioner.smoother","ILU0");
             prm.put("preconditioner.coarsesolver.preconditioner.verbosity",0);
             prm.put("preconditioner.coarsesolver.preconditioner.maxlevel",15);
+            prm.put("preconditioner.coarsesolver.preconditioner.precision", p.preconditioner_precision_);
             prm.put("preconditioner.coarsesolver.preconditioner.skip_isolated",0);
         } else {
             if(conf != "ilu0"){
@@ -114,6 +116,7 @@ setupPropertyTree(const FlowLinearSolverParameters& p)
             prm.put("preconditioner.type", "ParOverILU0");
             prm.put("preconditioner.relaxation", p.ilu_relaxation_);
             prm.put("preconditioner.ilulevel", p.ilu_fillin_level_);
+            prm.put("preconditioner.precision", p.preconditioner_precision_);
         }
     }
     return prm;
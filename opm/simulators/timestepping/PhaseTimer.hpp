@@ -0,0 +1,98 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PHASETIMER_HEADER_INCLUDED
+#define OPM_PHASETIMER_HEADER_INCLUDED
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <string>
+
+namespace Opm
+{
+
+    /// Accumulated wall clock time, CPU time and number of calls of a phase.
+    struct PhaseTiming
+    {
+        double wall_time = 0.0;
+        double cpu_time = 0.0;
+        unsigned long calls = 0;
+
+        PhaseTiming& operator+=(const PhaseTiming& other)
+        {
+            wall_time += other.wall_time;
+            cpu_time += other.cpu_time;
+            calls += other.calls;
+            return *this;
+        }
+    };
+
+    /// Timings of the phases of a simulation. The phases are named hierarchically
+    /// with '/' as separator, e.g. "linear/setup/cpr".
+    using PhaseTimings = std::map<std::string, PhaseTiming>;
+
+    inline void addPhaseTimings(PhaseTimings& timings, const PhaseTimings& other)
+    {
+        for (const auto& [name, timing] : other)
+            timings[name] += timing;
+    }
+
+    /// Adds the time between construction and stop() (or destruction) to a phase.
+    /// The CPU time is the one of the process, i.e. summed over all threads.
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(PhaseTimings& timings, const std::string& phase)
+            : timing_(timings[phase])
+            , wallStart_(std::chrono::steady_clock::now())
+            , cpuStart_(std::clock())
+        {
+        }
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+        ~PhaseTimer()
+        {
+            stop();
+        }
+
+        void stop()
+        {
+            if (stopped_)
+                return;
+
+            const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallStart_;
+            timing_.wall_time += wall.count();
+            timing_.cpu_time += static_cast<double>(std::clock() - cpuStart_) / CLOCKS_PER_SEC;
+            ++timing_.calls;
+            stopped_ = true;
+        }
+
+    private:
+        PhaseTiming& timing_;
+        std::chrono::steady_clock::time_point wallStart_;
+        std::clock_t cpuStart_;
+        bool stopped_ = false;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PHASETIMER_HEADER_INCLUDED
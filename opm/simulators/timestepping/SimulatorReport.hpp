@@ -19,6 +19,7 @@
 
 #ifndef OPM_SIMULATORREPORT_HEADER_INCLUDED
 #define OPM_SIMULATORREPORT_HEADER_INCLUDED
+#include <opm/simulators/timestepping/PhaseTimer.hpp>
 #include <cassert>
 #include <iosfwd>
 #include <vector>
@@ -50,6 +51,9 @@ namespace Opm
         double global_time;
         double timestep_length;
 
+        /// Fine grained timings of the phases of the simulation.
+        PhaseTimings phase_timings;
+
         /// Default constructor initializing all times to 0.0.
         SimulatorReportSingle();
         /// Increment this report's times by those in sr.
@@ -26,135 +26,85 @@
 
 #include <mpi.h>
 
+#include <array>
+#include <cstring>
+
 namespace
 {
 
     using Opm::ConvergenceReport;
 
-    void packReservoirFailure(const ConvergenceReport::ReservoirFailure& f,
-                              std::vector<char>& buf,
-                              int& offset)
-    {
-        int type = static_cast<int>(f.type());
-        int severity = static_cast<int>(f.severity());
-        int phase = f.phase();
-        MPI_Pack(&type, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        MPI_Pack(&severity, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        MPI_Pack(&phase, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-    }
+    // The report of a process is sent as a fixed-size header followed by a
+    // message holding the failures as plain ints and the concatenated well names.
+    enum HeaderEntry { NumReservoirFailures, NumWellFailures, MessageSize, HeaderSize };
+    using Header = std::array<int, HeaderSize>;
 
-    void packWellFailure(const ConvergenceReport::WellFailure& f,
-                         std::vector<char>& buf,
-                         int& offset)
-    {
-        int type = static_cast<int>(f.type());
-        int severity = static_cast<int>(f.severity());
-        int phase = f.phase();
-        MPI_Pack(&type, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        MPI_Pack(&severity, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        MPI_Pack(&phase, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        int name_length = f.wellName().size() + 1; // Adding 1 for the null terminator.
-        MPI_Pack(&name_length, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        MPI_Pack(const_cast<char*>(f.wellName().c_str()), name_length, MPI_CHAR, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-    }
+    const int intsPerReservoirFailure = 3;
+    const int intsPerWellFailure = 4;
 
-    void packConvergenceReport(const ConvergenceReport& local_report,
-                               std::vector<char>& buf,
-                               int& offset)
+    Header messageHeader(const ConvergenceReport& local_report)
     {
-        // Pack the data.
-        // Status will not be packed, it is possible to deduce from the other data.
-        // Reservoir failures.
-        const auto rf = local_report.reservoirFailures();
-        int num_rf = rf.size();
-        MPI_Pack(&num_rf, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        for (const auto f : rf) {
-            packReservoirFailure(f, buf, offset);
-        }
-        // Well failures.
-        const auto wf = local_report.wellFailures();
-        int num_wf = wf.size();
-        MPI_Pack(&num_wf, 1, MPI_INT, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-        for (const auto& f : wf) {
-            packWellFailure(f, buf, offset);
-        }
-    }
-
-    int messageSize(const ConvergenceReport& local_report)
-    {
-        int int_pack_size = 0;
-        MPI_Pack_size(1, MPI_INT, MPI_COMM_WORLD, &int_pack_size);
-        const int num_rf = local_report.reservoirFailures().size();
-        const int num_wf = local_report.wellFailures().size();
+        Header header;
+        header[NumReservoirFailures] = local_report.reservoirFailures().size();
+        header[NumWellFailures] = local_report.wellFailures().size();
         int wellnames_length = 0;
         for (const auto& f : local_report.wellFailures()) {
-            wellnames_length += (f.wellName().size() + 1);
+            wellnames_length += f.wellName().size();
         }
-        return (2 + 3*num_rf + 4*num_wf) * int_pack_size + wellnames_length;
-    }
-
-    ConvergenceReport::ReservoirFailure unpackReservoirFailure(const std::vector<char>& recv_buffer, int& offset)
-    {
-        int type = -1;
-        int severity = -1;
-        int phase = -1;
-        auto* data = const_cast<char*>(recv_buffer.data());
-        MPI_Unpack(data, recv_buffer.size(), &offset, &type, 1, MPI_INT, MPI_COMM_WORLD);
-        MPI_Unpack(data, recv_buffer.size(), &offset, &severity, 1, MPI_INT, MPI_COMM_WORLD);
-        MPI_Unpack(data, recv_buffer.size(), &offset, &phase, 1, MPI_INT, MPI_COMM_WORLD);
-        return ConvergenceReport::ReservoirFailure(static_cast<ConvergenceReport::ReservoirFailure::Type>(type),
-                                                   static_cast<ConvergenceReport::Severity>(severity),
-                                                   phase);
-    }
-
-    ConvergenceReport::WellFailure unpackWellFailure(const std::vector<char>& recv_buffer, int& offset)
-    {
-        int type = -1;
-        int severity = -1;
-        int phase = -1;
-        auto* data = const_cast<char*>(recv_buffer.data());
-        MPI_Unpack(data, recv_buffer.size(), &offset, &type, 1, MPI_INT, MPI_COMM_WORLD);
-        MPI_Unpack(data, recv_buffer.size(), &offset, &severity, 1, MPI_INT, MPI_COMM_WORLD);
-        MPI_Unpack(data, recv_buffer.size(), &offset, &phase, 1, MPI_INT, MPI_COMM_WORLD);
-        int name_length = -1;
-        MPI_Unpack(data, recv_buffer.size(), &offset, &name_length, 1, MPI_INT, MPI_COMM_WORLD);
-        std::vector<char> namechars(name_length);
-        MPI_Unpack(data, recv_buffer.size(), &offset, namechars.data(), name_length, MPI_CHAR, MPI_COMM_WORLD);
-        std::string name(namechars.data());
-        return ConvergenceReport::WellFailure(static_cast<ConvergenceReport::WellFailure::Type>(type),
-                                              static_cast<ConvergenceReport::Severity>(severity),
-                                              phase,
-                                              name);
+        header[MessageSize] = (intsPerReservoirFailure * header[NumReservoirFailures]
+                               + intsPerWellFailure * header[NumWellFailures]) * sizeof(int)
+                            + wellnames_length;
+        return header;
     }
 
-    ConvergenceReport unpackSingleConvergenceReport(const std::vector<char>& recv_buffer, int& offset)
+    std::vector<char> packConvergenceReport(const ConvergenceReport& local_report,
+                                            const Header& header)
     {
-        ConvergenceReport cr;
-        int num_rf = -1;
-        auto* data = const_cast<char*>(recv_buffer.data());
-        MPI_Unpack(data, recv_buffer.size(), &offset, &num_rf, 1, MPI_INT, MPI_COMM_WORLD);
-        for (int rf = 0; rf < num_rf; ++rf) {
-            ConvergenceReport::ReservoirFailure f = unpackReservoirFailure(recv_buffer, offset);
-            cr.setReservoirFailed(f);
+        // Status will not be sent, it is possible to deduce from the other data.
+        std::vector<int> ints;
+        ints.reserve(intsPerReservoirFailure * header[NumReservoirFailures]
+                     + intsPerWellFailure * header[NumWellFailures]);
+        for (const auto& f : local_report.reservoirFailures()) {
+            ints.insert(ints.end(), { static_cast<int>(f.type()), static_cast<int>(f.severity()), f.phase() });
         }
-        int num_wf = -1;
-        MPI_Unpack(data, recv_buffer.size(), &offset, &num_wf, 1, MPI_INT, MPI_COMM_WORLD);
-        for (int wf = 0; wf < num_wf; ++wf) {
-            ConvergenceReport::WellFailure f = unpackWellFailure(recv_buffer, offset);
-            cr.setWellFailed(f);
+        for (const auto& f : local_report.wellFailures()) {
+            ints.insert(ints.end(), { static_cast<int>(f.type()), static_cast<int>(f.severity()), f.phase(),
+                                      static_cast<int>(f.wellName().size()) });
         }
-        return cr;
+
+        std::vector<char> buffer(header[MessageSize]);
+        const std::size_t int_bytes = ints.size() * sizeof(int);
+        std::memcpy(buffer.data(), ints.data(), int_bytes);
+        std::size_t offset = int_bytes;
+        for (const auto& f : local_report.wellFailures()) {
+            std::memcpy(buffer.data() + offset, f.wellName().data(), f.wellName().size());
+            offset += f.wellName().size();
+        }
+        assert(offset == buffer.size());
+        return buffer;
     }
 
-    ConvergenceReport unpackConvergenceReports(const std::vector<char>& recv_buffer,
-                                               const std::vector<int>& displ)
+    ConvergenceReport unpackSingleConvergenceReport(const char* message, const Header& header)
     {
         ConvergenceReport cr;
-        const int num_processes = displ.size() - 1;
-        for (int process = 0; process < num_processes; ++process) {
-            int offset = displ[process];
-            cr += unpackSingleConvergenceReport(recv_buffer, offset);
-            assert(offset == displ[process + 1]);
+        const int num_ints = intsPerReservoirFailure * header[NumReservoirFailures]
+                           + intsPerWellFailure * header[NumWellFailures];
+        std::vector<int> ints(num_ints);
+        std::memcpy(ints.data(), message, num_ints * sizeof(int));
+        const char* names = message + num_ints * sizeof(int);
+
+        auto pos = ints.begin();
+        for (int rf = 0; rf < header[NumReservoirFailures]; ++rf, pos += intsPerReservoirFailure) {
+            cr.setReservoirFailed({static_cast<ConvergenceReport::ReservoirFailure::Type>(pos[0]),
+                                   static_cast<ConvergenceReport::Severity>(pos[1]),
+                                   pos[2]});
+        }
+        for (int wf = 0; wf < header[NumWellFailures]; ++wf, pos += intsPerWellFailure) {
+            cr.setWellFailed({static_cast<ConvergenceReport::WellFailure::Type>(pos[0]),
+                              static_cast<ConvergenceReport::Severity>(pos[1]),
+                              pos[2],
+                              std::string(names, pos[3])});
+            names += pos[3];
         }
         return cr;
     }
@@ -169,30 +119,36 @@ namespace Opm
     /// (per-process) reports.
     ConvergenceReport gatherConvergenceReport(const ConvergenceReport& local_report)
     {
-        // Pack local report.
-        int message_size = messageSize(local_report);
-        std::vector<char> buffer(message_size);
-        int offset = 0;
-        packConvergenceReport(local_report, buffer, offset);
-        assert(offset == message_size);
-
-        // Get message sizes and create offset/displacement array for gathering.
+        // Gather the fixed-size headers. In the common case that no
+        // process has a failure, this is the only communication needed.
         int num_processes = -1;
         MPI_Comm_size(MPI_COMM_WORLD, &num_processes);
+        const Header header = messageHeader(local_report);
+        std::vector<Header> headers(num_processes);
+        MPI_Allgather(header.data(), HeaderSize, MPI_INT, headers.data(), HeaderSize, MPI_INT, MPI_COMM_WORLD);
+
         std::vector<int> message_sizes(num_processes);
-        MPI_Allgather(&message_size, 1, MPI_INT, message_sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        for (int process = 0; process < num_processes; ++process) {
+            message_sizes[process] = headers[process][MessageSize];
+        }
         std::vector<int> displ(num_processes + 1, 0);
         std::partial_sum(message_sizes.begin(), message_sizes.end(), displ.begin() + 1);
+        if (displ.back() == 0) {
+            return ConvergenceReport{};
+        }
 
-        // Gather.
+        // Gather the failures.
+        const std::vector<char> buffer = packConvergenceReport(local_report, header);
         std::vector<char> recv_buffer(displ.back());
-        MPI_Allgatherv(buffer.data(), buffer.size(), MPI_PACKED,
-                       const_cast<char*>(recv_buffer.data()), message_sizes.data(),
-                       displ.data(), MPI_PACKED,
+        MPI_Allgatherv(buffer.data(), buffer.size(), MPI_BYTE,
+                       recv_buffer.data(), message_sizes.data(),
+                       displ.data(), MPI_BYTE,
                        MPI_COMM_WORLD);
 
-        // Unpack.
-        ConvergenceReport global_report = unpackConvergenceReports(recv_buffer, displ);
+        ConvergenceReport global_report;
+        for (int process = 0; process < num_processes; ++process) {
+            global_report += unpackSingleConvergenceReport(recv_buffer.data() + displ[process], headers[process]);
+        }
         return global_report;
     }
 
@@ -67,6 +67,9 @@ namespace Opm
         /// Clear the message container without logging them.
         void clearMessages();
 
+        /// Append all messages of another logger to the message container.
+        void append(const DeferredLogger& other);
+
     private:
         std::vector<Message> messages_;
         friend Opm::DeferredLogger gatherDeferredLogger(const Opm::DeferredLogger& local_deferredlogger);
@@ -18,6 +18,9 @@
 */
 
 #include <config.h>
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/utility/FileSystem.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/DynamicState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
@@ -35,15 +38,221 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace {
+
+// identifies the layout of the startup snapshot files
+const std::string snapshotMagic = "OPMSNAP1";
+
+// 64 bit FNV-1a hash of the contents of a file
+std::size_t hashFile(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Input file " + fileName + " can not be read");
+
+    std::uint64_t hash = 14695981039346656037ULL;
+    std::vector<char> block(1 << 20);
+    while (file) {
+        file.read(block.data(), block.size());
+        for (std::streamsize i = 0; i < file.gcount(); ++i) {
+            hash ^= static_cast<unsigned char>(block[i]);
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+struct SnapshotHeader
+{
+    std::vector<std::string> files;
+    std::vector<std::size_t> hashes;
+
+    template<class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(files);
+        serializer(hashes);
+    }
+};
+
+struct SnapshotData
+{
+    Opm::Deck& deck;
+    Opm::Schedule& schedule;
+    Opm::SummaryConfig& summaryConfig;
+
+    template<class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        deck.serializeOp(serializer);
+        schedule.serializeOp(serializer);
+        summaryConfig.serializeOp(serializer);
+    }
+};
+
+void writeBlock(std::ofstream& out, Opm::EclMpiSerializer& ser)
+{
+    const std::uint64_t size = ser.position();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(ser.buffer().data(), size);
+}
+
+bool readBlock(std::ifstream& in, Opm::EclMpiSerializer& ser)
+{
+    std::uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)))
+        return false;
+
+    ser.buffer().resize(size);
+    return static_cast<bool>(in.read(ser.buffer().data(), size));
+}
+
+// a name for a temporary file next to fileName which is unique across hosts and processes
+std::string uniqueTemporaryName(const std::string& fileName)
+{
+    char host[256] = {};
+    if (gethostname(host, sizeof(host) - 1) != 0)
+        host[0] = '\0';
+
+    std::random_device rd;
+    std::ostringstream name;
+    name << fileName << ".tmp." << host << "." << getpid() << "."
+         << std::hex << std::setw(8) << std::setfill('0') << rd();
+    return name.str();
+}
+
+} // anonymous namespace
+
 namespace Opm {
 
 void eclStateBroadcast(EclipseState& eclState, Schedule& schedule,
                        SummaryConfig& summaryConfig)
 {
-    Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
-    ser.broadcast(eclState);
-    ser.broadcast(schedule);
-    ser.broadcast(summaryConfig);
+    Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication(),
+                              /*compress=*/true);
+    ser.broadcast(eclState, schedule, summaryConfig);
+}
+
+std::string startupSnapshotFileName(const std::string& cacheDir,
+                                    const std::string& deckFilename,
+                                    bool initFromRestart)
+{
+    std::ostringstream name;
+    name << filesystem::path(deckFilename).stem().string() << "-"
+         << std::hex << std::setw(16) << std::setfill('0') << hashFile(deckFilename)
+         << (initFromRestart ? "-RST" : "") << ".OPMSNAP";
+    return (filesystem::path(cacheDir) / name.str()).string();
+}
+
+bool readStartupSnapshot(const std::string& fileName, Deck& deck,
+                         Schedule& schedule, SummaryConfig& summaryConfig)
+{
+    if (!filesystem::exists(fileName))
+        return false;
+
+    try {
+        std::ifstream in(fileName, std::ios::binary);
+        std::string magic(snapshotMagic.size(), ' ');
+        in.read(&magic[0], magic.size());
+
+        Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
+        if (!in || magic != snapshotMagic || !readBlock(in, ser)) {
+            OpmLog::warning("Ignoring the invalid startup snapshot " + fileName);
+            return false;
+        }
+
+        SnapshotHeader header;
+        ser.unpack(header);
+        for (std::size_t i = 0; i < header.files.size(); ++i) {
+            if (!filesystem::exists(header.files[i]) || hashFile(header.files[i]) != header.hashes[i]) {
+                OpmLog::info("Ignoring the startup snapshot " + fileName + ", " + header.files[i] + " has changed");
+                return false;
+            }
+        }
+
+        if (!readBlock(in, ser)) {
+            OpmLog::warning("Ignoring the truncated startup snapshot " + fileName);
+            return false;
+        }
+
+        SnapshotData data{deck, schedule, summaryConfig};
+        ser.unpack(data);
+    }
+    catch (const std::exception& e) {
+        OpmLog::warning("Reading the startup snapshot " + fileName + " failed: " + e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void writeStartupSnapshot(const std::string& fileName, Deck& deck,
+                          Schedule& schedule, SummaryConfig& summaryConfig,
+                          const std::vector<std::string>& extraInputFiles)
+{
+    std::set<std::string> files(extraInputFiles.begin(), extraInputFiles.end());
+    for (std::size_t idx = 0; idx < deck.size(); ++idx) {
+        const auto& file = deck.getKeyword(idx).location().filename;
+        if (!file.empty())
+            files.insert(file);
+    }
+
+    try {
+        SnapshotHeader header;
+        for (const auto& file : files) {
+            header.files.push_back(file);
+            header.hashes.push_back(hashFile(file));
+        }
+
+        const filesystem::path path(fileName);
+        if (path.has_parent_path())
+            filesystem::create_directories(path.parent_path());
+
+        // write to a temporary file in the same directory first, which is renamed
+        // when complete. the name is unique, so concurrent runs, also on different
+        // hosts sharing the directory, never see a partial snapshot.
+        const std::string tmpName = uniqueTemporaryName(fileName);
+        try {
+            std::ofstream out(tmpName, std::ios::binary);
+            out.write(snapshotMagic.data(), snapshotMagic.size());
+
+            Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication(),
+                                      /*compress=*/true);
+            ser.pack(header);
+            writeBlock(out, ser);
+
+            SnapshotData data{deck, schedule, summaryConfig};
+            ser.pack(data);
+            writeBlock(out, ser);
+
+            out.close();
+            if (!out)
+                throw std::runtime_error("Could not write " + tmpName);
+            filesystem::rename(tmpName, path);
+        }
+        catch (...) {
+            std::error_code ec;
+            filesystem::remove(tmpName, ec);
+            throw;
+        }
+
+        OpmLog::info("Wrote the startup snapshot " + fileName);
+    }
+    catch (const std::exception& e) {
+        OpmLog::warning("Writing the startup snapshot " + fileName + " failed: " + e.what());
+    }
 }
 
 }
@@ -19,8 +19,12 @@
 #ifndef PARALLEL_SERIALIZATION_HPP
 #define PARALLEL_SERIALIZATION_HPP
 
+#include <string>
+#include <vector>
+
 namespace Opm {
 
+class Deck;
 class EclipseState;
 class Schedule;
 class SummaryConfig;
@@ -33,6 +37,36 @@ class SummaryConfig;
 void eclStateBroadcast(EclipseState& eclState, Schedule& schedule,
                        SummaryConfig& summaryConfig);
 
+/*! \brief Returns the name of the startup snapshot of a deck.
+ *! \details The name contains a hash of the contents of the deck file.
+ *! \param cacheDir Directory holding the startup snapshots
+ *! \param deckFilename Name of the deck file
+ *! \param initFromRestart True if the schedule is initialized from a restart file
+*/
+std::string startupSnapshotFileName(const std::string& cacheDir,
+                                    const std::string& deckFilename,
+                                    bool initFromRestart);
+
+/*! \brief Reads a deck, schedule and summary config from a startup snapshot.
+ *! \details The snapshot is only used if all the input files it was created
+ *!          from are unchanged.
+ *! \param fileName Name of the snapshot file
+ *! \return True if the objects were read from the snapshot
+*/
+bool readStartupSnapshot(const std::string& fileName, Deck& deck,
+                         Schedule& schedule, SummaryConfig& summaryConfig);
+
+/*! \brief Writes a deck, schedule and summary config to a startup snapshot.
+ *! \details The hashes of the files included by the deck and of the extra
+ *!          input files are stored to validate the snapshot when it is read.
+ *!          Failures are logged, they do not abort the run.
+ *! \param fileName Name of the snapshot file
+ *! \param extraInputFiles Input files not referenced by the deck, e.g. a restart file
+*/
+void writeStartupSnapshot(const std::string& fileName, Deck& deck,
+                          Schedule& schedule, SummaryConfig& summaryConfig,
+                          const std::vector<std::string>& extraInputFiles);
+
 } // end namespace Opm
 
 #endif // PARALLEL_SERIALIZATION_HPP
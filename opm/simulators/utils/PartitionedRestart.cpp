@@ -0,0 +1,289 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/PartitionedRestart.hpp>
+
+#include <opm/common/utility/FileSystem.hpp>
+#include <opm/io/eclipse/EclFile.hpp>
+#include <opm/io/eclipse/EclIOdata.hpp>
+#include <opm/io/eclipse/EclOutput.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+    // version of the layout of the partition files
+    const int partitionVersion = 1;
+
+    enum PartitionHeader {
+        Version = 0,
+        Rank,
+        NumRanks,
+        ReportStep,
+        NumGlobalCells,
+        NumLocalCells,
+        DoublePrecision,
+        HeaderSize
+    };
+
+    bool isRestartArray(const Opm::data::CellData& cellData)
+    {
+        return cellData.target == Opm::data::TargetType::RESTART_SOLUTION
+            || cellData.target == Opm::data::TargetType::RESTART_AUXILIARY;
+    }
+
+    std::string trimmed(const std::string& name)
+    {
+        const auto end = name.find_last_not_of(' ');
+        return end == std::string::npos ? std::string() : name.substr(0, end + 1);
+    }
+
+    void writeArrays(const Opm::data::Solution& solution,
+                     Opm::data::TargetType target,
+                     bool doublePrecision,
+                     Opm::EclIO::EclOutput& output)
+    {
+        for (const auto& [name, cellData] : solution) {
+            if (cellData.target != target)
+                continue;
+
+            if (doublePrecision)
+                output.write(name, cellData.data);
+            else
+                output.write(name, std::vector<float>(cellData.data.begin(), cellData.data.end()));
+        }
+    }
+
+    void copyArray(Opm::EclIO::EclFile& input,
+                   int arrIndex,
+                   const std::string& name,
+                   Opm::EclIO::eclArrType type,
+                   Opm::EclIO::EclOutput& output)
+    {
+        switch (type) {
+        case Opm::EclIO::INTE:
+            output.write(name, input.get<int>(arrIndex));
+            break;
+        case Opm::EclIO::REAL:
+            output.write(name, input.get<float>(arrIndex));
+            break;
+        case Opm::EclIO::DOUB:
+            output.write(name, input.get<double>(arrIndex));
+            break;
+        case Opm::EclIO::LOGI:
+            output.write(name, input.get<bool>(arrIndex));
+            break;
+        case Opm::EclIO::CHAR:
+            output.write(name, input.get<std::string>(arrIndex));
+            break;
+        case Opm::EclIO::MESS:
+            output.message(name);
+            break;
+        default:
+            throw std::runtime_error("Array " + name + " has a type which can not be copied");
+        }
+    }
+} // anonymous namespace
+
+namespace Opm
+{
+
+    std::string restartPartitionFileName(const std::string& outputDir,
+                                         const std::string& baseName,
+                                         int rank,
+                                         int reportStep)
+    {
+        std::ostringstream name;
+        name << baseName << "_P" << std::setw(4) << std::setfill('0') << rank
+             << ".X" << std::setw(4) << std::setfill('0') << reportStep;
+        return (filesystem::path(outputDir) / name.str()).string();
+    }
+
+
+
+    void writeRestartPartition(const std::string& fileName,
+                               int rank,
+                               int numRanks,
+                               int reportStep,
+                               int numGlobalCells,
+                               const std::vector<int>& globalIndex,
+                               const data::Solution& localCellData,
+                               const UnitSystem& units,
+                               bool doublePrecision)
+    {
+        std::vector<int> header(HeaderSize);
+        header[Version] = partitionVersion;
+        header[Rank] = rank;
+        header[NumRanks] = numRanks;
+        header[ReportStep] = reportStep;
+        header[NumGlobalCells] = numGlobalCells;
+        header[NumLocalCells] = globalIndex.size();
+        header[DoublePrecision] = doublePrecision;
+
+        std::vector<std::string> names;
+        std::vector<int> targets;
+        for (const auto& [name, cellData] : localCellData) {
+            if (!isRestartArray(cellData))
+                continue;
+
+            if (name.size() > 8)
+                throw std::logic_error("Restart array name " + name + " is longer than eight characters");
+            if (cellData.data.size() != globalIndex.size())
+                throw std::logic_error("Restart array " + name + " does not match the number of local cells");
+
+            names.push_back(name);
+            targets.push_back(static_cast<int>(cellData.target));
+        }
+
+        EclIO::EclOutput output(fileName, /*formatted=*/false);
+        output.write("PARTHEAD", header);
+        output.write("GLOBIDX", globalIndex);
+        output.write("SOLNAMES", names);
+        output.write("SOLTARG", targets);
+
+        std::vector<double> values;
+        for (const auto& name : names) {
+            const auto& cellData = localCellData.at(name);
+            values = cellData.data;
+            units.from_si(cellData.dim, values);
+            output.write(name, values);
+        }
+    }
+
+
+
+    RestartPartitionData readRestartPartitions(const std::string& outputDir,
+                                               const std::string& baseName,
+                                               int reportStep)
+    {
+        RestartPartitionData result;
+        result.reportStep = reportStep;
+
+        // the number of partitions is taken from the first one
+        int numRanks = 1;
+        for (int rank = 0; rank < numRanks; ++rank) {
+            const auto fileName = restartPartitionFileName(outputDir, baseName, rank, reportStep);
+            if (!filesystem::exists(fileName))
+                throw std::runtime_error("Restart partition " + fileName + " does not exist");
+
+            EclIO::EclFile file(fileName);
+            const auto header = file.get<int>("PARTHEAD");
+            if (header.size() < HeaderSize || header[Version] != partitionVersion)
+                throw std::runtime_error("Restart partition " + fileName + " has an unsupported layout");
+            if (header[Rank] != rank || header[ReportStep] != reportStep)
+                throw std::runtime_error("Restart partition " + fileName + " does not match its file name");
+
+            if (rank == 0) {
+                numRanks = header[NumRanks];
+                result.numGlobalCells = header[NumGlobalCells];
+                result.doublePrecision = header[DoublePrecision] != 0;
+            }
+            else if (header[NumRanks] != numRanks || header[NumGlobalCells] != result.numGlobalCells) {
+                throw std::runtime_error("Restart partition " + fileName + " is not from the same run as the first partition");
+            }
+
+            const auto globalIndex = file.get<int>("GLOBIDX");
+            const auto names = file.get<std::string>("SOLNAMES");
+            const auto targets = file.get<int>("SOLTARG");
+            if (globalIndex.size() != static_cast<std::size_t>(header[NumLocalCells]) || names.size() != targets.size())
+                throw std::runtime_error("Restart partition " + fileName + " is inconsistent");
+
+            for (const int idx : globalIndex) {
+                if (idx < 0 || idx >= result.numGlobalCells)
+                    throw std::runtime_error("Restart partition " + fileName + " has a cell outside of the global grid");
+            }
+
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                const auto name = trimmed(names[i]);
+                const auto& values = file.get<double>(name);
+                if (values.size() != globalIndex.size())
+                    throw std::runtime_error("Array " + name + " of restart partition " + fileName + " has the wrong size");
+
+                if (!result.solution.has(name)) {
+                    result.solution.insert(name, UnitSystem::measure::identity,
+                                           std::vector<double>(result.numGlobalCells, 0.0),
+                                           static_cast<data::TargetType>(targets[i]));
+                }
+
+                auto& data = result.solution.data(name);
+                for (std::size_t cell = 0; cell < globalIndex.size(); ++cell)
+                    data[globalIndex[cell]] = values[cell];
+            }
+        }
+
+        return result;
+    }
+
+
+
+    void mergeRestartPartitions(const std::string& restartFile,
+                                const std::string& outputFile)
+    {
+        const filesystem::path path(restartFile);
+        const std::string extension = path.extension().string();
+        const bool formatted = extension.size() > 1 && extension[1] == 'F';
+        const bool unified = extension == ".UNRST" || extension == ".FUNRST";
+
+        // the report step of a non-unified restart file is part of its extension,
+        // a unified file marks every report step with SEQNUM
+        int reportStep = -1;
+        if (!unified) {
+            if (extension.size() != 6 || extension.find_first_not_of("0123456789", 2) != std::string::npos)
+                throw std::runtime_error(restartFile + " is not the name of a restart file");
+            reportStep = std::stoi(extension.substr(2));
+        }
+
+        if (filesystem::exists(outputFile) && filesystem::equivalent(path, outputFile))
+            throw std::runtime_error("The merged restart file can not replace " + restartFile);
+
+        const std::string outputDir = path.has_parent_path() ? path.parent_path().string() : std::string(".");
+        const std::string baseName = path.stem().string();
+
+        EclIO::EclFile input(restartFile);
+        input.loadData();
+        EclIO::EclOutput output(outputFile, formatted);
+
+        RestartPartitionData partitions;
+        const auto arrays = input.getList();
+        for (std::size_t arrIndex = 0; arrIndex < arrays.size(); ++arrIndex) {
+            const auto& name = std::get<0>(arrays[arrIndex]);
+            const auto type = std::get<1>(arrays[arrIndex]);
+            if (name == "SEQNUM")
+                reportStep = input.get<int>(arrIndex).front();
+            else if (name == "STARTSOL")
+                partitions = readRestartPartitions(outputDir, baseName, reportStep);
+            else if (name == "ENDSOL")
+                writeArrays(partitions.solution, data::TargetType::RESTART_SOLUTION,
+                            partitions.doublePrecision, output);
+
+            copyArray(input, arrIndex, name, type, output);
+
+            // the auxiliary arrays are not part of the solution section
+            if (name == "ENDSOL")
+                writeArrays(partitions.solution, data::TargetType::RESTART_AUXILIARY,
+                            partitions.doublePrecision, output);
+        }
+    }
+
+} // namespace Opm
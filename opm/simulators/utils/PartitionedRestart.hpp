@@ -0,0 +1,82 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PARTITIONEDRESTART_HEADER_INCLUDED
+#define OPM_PARTITIONEDRESTART_HEADER_INCLUDED
+
+#include <opm/output/data/Solution.hpp>
+
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    class UnitSystem;
+
+    /// The cell data of a report step assembled from the restart partitions
+    /// of all processes. The values are stored in output units.
+    struct RestartPartitionData
+    {
+        int reportStep = -1;
+        int numGlobalCells = 0;
+        bool doublePrecision = false;
+        data::Solution solution;
+    };
+
+    /// Name of the file which holds the restart partition written by one process,
+    /// e.g. CASE_P0003.X0012 for rank 3 and report step 12.
+    std::string restartPartitionFileName(const std::string& outputDir,
+                                         const std::string& baseName,
+                                         int rank,
+                                         int reportStep);
+
+    /// Write the restart cell data of the cells of one process to a binary ECL
+    /// file. Besides the solution arrays, the file contains the header PARTHEAD,
+    /// the global (active) index of every local cell in GLOBIDX and the names and
+    /// targets of the arrays in SOLNAMES and SOLTARG.
+    /// \param[in] globalIndex    the global index of every local cell
+    /// \param[in] localCellData  the cell data of the process in SI units, only the
+    ///                           restart solution and auxiliary arrays are written
+    void writeRestartPartition(const std::string& fileName,
+                               int rank,
+                               int numRanks,
+                               int reportStep,
+                               int numGlobalCells,
+                               const std::vector<int>& globalIndex,
+                               const data::Solution& localCellData,
+                               const UnitSystem& units,
+                               bool doublePrecision);
+
+    /// Read the restart partitions of all processes for a report step.
+    /// If a cell is part of several partitions, the value of the highest rank wins.
+    RestartPartitionData readRestartPartitions(const std::string& outputDir,
+                                               const std::string& baseName,
+                                               int reportStep);
+
+    /// Insert the cell data of the restart partitions into a restart file written
+    /// by the I/O rank without cell data. Both unified and non-unified, formatted
+    /// and unformatted restart files are supported, the partitions are expected
+    /// next to the restart file.
+    void mergeRestartPartitions(const std::string& restartFile,
+                                const std::string& outputFile);
+
+} // namespace Opm
+
+#endif // OPM_PARTITIONEDRESTART_HEADER_INCLUDED
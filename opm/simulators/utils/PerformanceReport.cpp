@@ -0,0 +1,194 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/PerformanceReport.hpp>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+#include <set>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+namespace
+{
+
+    void printStatistic(std::ostream& os, const char* name,
+                        double min, double max, double sum, int numProcesses)
+    {
+        os << '"' << name << "\": {\"min\": " << min
+           << ", \"max\": " << max
+           << ", \"avg\": " << sum / numProcesses << '}';
+    }
+
+    void printPhases(std::ostream& os, const char* name,
+                     const Opm::PhaseStatisticsMap& phases, int numProcesses)
+    {
+        os << "  \"" << name << "\": {";
+        const char* separator = "\n";
+        for (const auto& [phase, stat] : phases) {
+            os << separator << "    \"" << phase << "\": {\n      ";
+            printStatistic(os, "calls", stat.min.calls, stat.max.calls, stat.sum.calls, numProcesses);
+            os << ",\n      ";
+            printStatistic(os, "wall_time", stat.min.wall_time, stat.max.wall_time, stat.sum.wall_time, numProcesses);
+            os << ",\n      ";
+            printStatistic(os, "cpu_time", stat.min.cpu_time, stat.max.cpu_time, stat.sum.cpu_time, numProcesses);
+            os << "\n    }";
+            separator = ",\n";
+        }
+        os << (phases.empty() ? "}" : "\n  }");
+    }
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+    PhaseStatisticsMap gatherPhaseTimings(const PhaseTimings& localTimings)
+    {
+        PhaseStatisticsMap result;
+#if HAVE_MPI
+        int rank = 0;
+        int numProcesses = 1;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
+
+        // every process needs the union of the phase names to take part in the reduction
+        std::vector<char> names;
+        for (const auto& entry : localTimings)
+            names.insert(names.end(), entry.first.c_str(), entry.first.c_str() + entry.first.size() + 1);
+
+        int size = names.size();
+        std::vector<int> sizes(numProcesses);
+        MPI_Allgather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        std::vector<int> displ(numProcesses + 1, 0);
+        std::partial_sum(sizes.begin(), sizes.end(), displ.begin() + 1);
+        std::vector<char> allNames(displ.back());
+        MPI_Allgatherv(names.data(), size, MPI_CHAR, allNames.data(), sizes.data(), displ.data(),
+                       MPI_CHAR, MPI_COMM_WORLD);
+
+        std::set<std::string> phases;
+        for (auto pos = allNames.begin(); pos != allNames.end(); ) {
+            const auto end = std::find(pos, allNames.end(), '\0');
+            phases.emplace(pos, end);
+            pos = end + 1;
+        }
+
+        // wall time, CPU time and calls of each phase, in the order of the names
+        std::vector<double> local;
+        local.reserve(3*phases.size());
+        for (const auto& phase : phases) {
+            const auto it = localTimings.find(phase);
+            const PhaseTiming timing = it == localTimings.end() ? PhaseTiming{} : it->second;
+            local.push_back(timing.wall_time);
+            local.push_back(timing.cpu_time);
+            local.push_back(timing.calls);
+        }
+
+        std::vector<double> min(local.size()), max(local.size()), sum(local.size());
+        MPI_Reduce(local.data(), min.data(), local.size(), MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+        MPI_Reduce(local.data(), max.data(), local.size(), MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(local.data(), sum.data(), local.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank != 0)
+            return result;
+
+        auto timing = [](const std::vector<double>& values, std::size_t idx)
+        {
+            PhaseTiming timing;
+            timing.wall_time = values[3*idx];
+            timing.cpu_time = values[3*idx + 1];
+            timing.calls = static_cast<unsigned long>(values[3*idx + 2]);
+            return timing;
+        };
+
+        std::size_t idx = 0;
+        for (const auto& phase : phases) {
+            result[phase] = PhaseStatistics{timing(min, idx), timing(max, idx), timing(sum, idx)};
+            ++idx;
+        }
+#else
+        for (const auto& [phase, timing] : localTimings)
+            result[phase] = PhaseStatistics{timing, timing, timing};
+#endif
+        return result;
+    }
+
+
+
+    void printPerformanceReport(std::ostream& os,
+                                const SimulatorReport& report,
+                                const PhaseStatisticsMap& success,
+                                const PhaseStatisticsMap& failure,
+                                int numProcesses,
+                                int numThreads)
+    {
+        const auto& sr = report.success;
+        os << std::setprecision(9)
+           << "{\n"
+           << "  \"processes\": " << numProcesses << ",\n"
+           << "  \"threads_per_process\": " << numThreads << ",\n"
+           << "  \"total_time\": " << sr.total_time << ",\n"
+           << "  \"solver_time\": " << sr.solver_time << ",\n"
+           << "  \"output_write_time\": " << sr.output_write_time << ",\n"
+           << "  \"well_iterations\": " << sr.total_well_iterations << ",\n"
+           << "  \"newton_iterations\": " << sr.total_newton_iterations << ",\n"
+           << "  \"linearizations\": " << sr.total_linearizations << ",\n"
+           << "  \"linear_iterations\": " << sr.total_linear_iterations << ",\n"
+           << "  \"failed_newton_iterations\": " << report.failure.total_newton_iterations << ",\n";
+        printPhases(os, "phases", success, numProcesses);
+        os << ",\n";
+        printPhases(os, "failed_phases", failure, numProcesses);
+        os << "\n}\n";
+    }
+
+
+
+    void writePerformanceReport(const std::string& fileName,
+                                const SimulatorReport& report,
+                                int numThreads)
+    {
+        int rank = 0;
+        int numProcesses = 1;
+#if HAVE_MPI
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
+#endif
+
+        const auto success = gatherPhaseTimings(report.success.phase_timings);
+        const auto failure = gatherPhaseTimings(report.failure.phase_timings);
+        if (rank != 0)
+            return;
+
+        std::ofstream os(fileName);
+        if (!os) {
+            OpmLog::warning("Could not write the performance report to " + fileName);
+            return;
+        }
+        printPerformanceReport(os, report, success, failure, numProcesses, numThreads);
+    }
+
+} // namespace Opm
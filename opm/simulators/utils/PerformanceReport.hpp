@@ -0,0 +1,66 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PERFORMANCEREPORT_HEADER_INCLUDED
+#define OPM_PERFORMANCEREPORT_HEADER_INCLUDED
+
+#include <opm/simulators/timestepping/PhaseTimer.hpp>
+#include <opm/simulators/timestepping/SimulatorReport.hpp>
+
+#include <iosfwd>
+#include <map>
+#include <string>
+
+namespace Opm
+{
+
+    /// Minimum, maximum and sum of the timings of a phase over all processes.
+    /// Processes which did not run the phase contribute zero.
+    struct PhaseStatistics
+    {
+        PhaseTiming min;
+        PhaseTiming max;
+        PhaseTiming sum;
+    };
+
+    using PhaseStatisticsMap = std::map<std::string, PhaseStatistics>;
+
+    /// Reduce the phase timings of all processes to rank 0. The other
+    /// processes get an empty result. Must be called by all processes.
+    PhaseStatisticsMap gatherPhaseTimings(const PhaseTimings& localTimings);
+
+    /// Print the phase statistics and the counters of the report as JSON.
+    /// \param[in] success     statistics of the successful time steps
+    /// \param[in] failure     statistics of the failed time steps
+    void printPerformanceReport(std::ostream& os,
+                                const SimulatorReport& report,
+                                const PhaseStatisticsMap& success,
+                                const PhaseStatisticsMap& failure,
+                                int numProcesses,
+                                int numThreads);
+
+    /// Gather the phase timings of all processes and write them to a JSON
+    /// file on rank 0. Must be called by all processes.
+    void writePerformanceReport(const std::string& fileName,
+                                const SimulatorReport& report,
+                                int numThreads);
+
+} // namespace Opm
+
+#endif // OPM_PERFORMANCEREPORT_HEADER_INCLUDED
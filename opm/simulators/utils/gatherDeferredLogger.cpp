@@ -24,78 +24,94 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <map>
 #include <numeric>
 #include <mpi.h>
 
 namespace
 {
 
-    void packMessages(const std::vector<Opm::DeferredLogger::Message>& local_messages, std::vector<char>& buf, int& offset)
+    // Tag of the point-to-point messages carrying the log messages.
+    const int loggerMessageTag = 0x4c4f47;
+
+    template<class T>
+    void write(std::vector<char>& buf, const T& value)
     {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        buf.insert(buf.end(), bytes, bytes + sizeof(T));
+    }
 
-        int messagesize = local_messages.size();
-        MPI_Pack(&messagesize, 1, MPI_UNSIGNED, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
+    void writeString(std::vector<char>& buf, const std::string& str)
+    {
+        write(buf, static_cast<std::uint32_t>(str.size()));
+        buf.insert(buf.end(), str.begin(), str.end());
+    }
 
-        for (const auto lm : local_messages) {
-            MPI_Pack(static_cast<void*>(const_cast<std::int64_t*>(&lm.flag)), 1, MPI_INT64_T, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            int tagsize = lm.tag.size();
-            MPI_Pack(&tagsize, 1, MPI_UNSIGNED, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            if (tagsize>0) {
-                MPI_Pack(const_cast<char*>(lm.tag.c_str()), lm.tag.size(), MPI_CHAR, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            }
-            int textsize = lm.text.size();
-            MPI_Pack(&textsize, 1, MPI_UNSIGNED, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            if (textsize>0) {
-                MPI_Pack(const_cast<char*>(lm.text.c_str()), lm.text.size(), MPI_CHAR, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            }
-        }
+    template<class T>
+    T read(const char*& pos)
+    {
+        T value;
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
     }
 
-    Opm::DeferredLogger::Message unpackSingleMessage(const std::vector<char>& recv_buffer, int& offset)
+    std::string readString(const char*& pos)
     {
-        int64_t flag;
-        auto* data = const_cast<char*>(recv_buffer.data());
-        MPI_Unpack(data, recv_buffer.size(), &offset, &flag, 1, MPI_INT64_T, MPI_COMM_WORLD);
-
-        // unpack tag
-        unsigned int tagsize;
-        MPI_Unpack(data, recv_buffer.size(), &offset, &tagsize, 1, MPI_UNSIGNED, MPI_COMM_WORLD);
-        std::string tag;
-        if (tagsize>0) {
-            std::vector<char> tagchars(tagsize);
-            MPI_Unpack(data, recv_buffer.size(), &offset, tagchars.data(), tagsize, MPI_CHAR, MPI_COMM_WORLD);
-            tag = std::string(tagchars.data(), tagsize);
+        const auto size = read<std::uint32_t>(pos);
+        std::string str(pos, size);
+        pos += size;
+        return str;
+    }
+
+    // The messages of a process are stored as a table of the distinct tags
+    // followed by the messages, which refer to their tag by its index.
+    std::vector<char> packMessages(const std::vector<Opm::DeferredLogger::Message>& local_messages)
+    {
+        std::vector<char> buf;
+        if (local_messages.empty()) {
+            return buf;
+        }
+
+        std::map<std::string, std::uint32_t> tag_index;
+        std::vector<const std::string*> tags;
+        for (const auto& lm : local_messages) {
+            if (tag_index.emplace(lm.tag, tags.size()).second) {
+                tags.push_back(&lm.tag);
+            }
+        }
+
+        write(buf, static_cast<std::uint32_t>(tags.size()));
+        for (const auto* tag : tags) {
+            writeString(buf, *tag);
         }
-        // unpack text
-        unsigned int textsize;
-        MPI_Unpack(data, recv_buffer.size(), &offset, &textsize, 1, MPI_UNSIGNED, MPI_COMM_WORLD);
-        std::string text;
-        if (textsize>0) {
-            std::vector<char> textchars(textsize);
-            MPI_Unpack(data, recv_buffer.size(), &offset, textchars.data(), textsize, MPI_CHAR, MPI_COMM_WORLD);
-            text = std::string (textchars.data(), textsize);
+        write(buf, static_cast<std::uint32_t>(local_messages.size()));
+        for (const auto& lm : local_messages) {
+            write(buf, lm.flag);
+            write(buf, tag_index[lm.tag]);
+            writeString(buf, lm.text);
         }
-        return Opm::DeferredLogger::Message({flag, tag, text});
+        return buf;
     }
 
-    std::vector<Opm::DeferredLogger::Message> unpackMessages(const std::vector<char>& recv_buffer, const std::vector<int>& displ)
+    void unpackMessages(const char* pos, const char* end, std::vector<Opm::DeferredLogger::Message>& messages)
     {
-        std::vector<Opm::DeferredLogger::Message> messages;
-        const int num_processes = displ.size() - 1;
-        auto* data = const_cast<char*>(recv_buffer.data());
-        for (int process = 0; process < num_processes; ++process) {
-            int offset = displ[process];
-            // unpack number of messages
-            unsigned int messagesize;
-            MPI_Unpack(data, recv_buffer.size(), &offset, &messagesize, 1, MPI_UNSIGNED, MPI_COMM_WORLD);
-            for (unsigned int i=0; i<messagesize; i++) {
-                messages.push_back(unpackSingleMessage(recv_buffer, offset));
-            }
-            assert(offset == displ[process + 1]);
+        std::vector<std::string> tags(read<std::uint32_t>(pos));
+        for (auto& tag : tags) {
+            tag = readString(pos);
+        }
+        const auto num_messages = read<std::uint32_t>(pos);
+        for (std::uint32_t i = 0; i < num_messages; ++i) {
+            const auto flag = read<std::int64_t>(pos);
+            const auto& tag = tags[read<std::uint32_t>(pos)];
+            messages.push_back({flag, tag, readString(pos)});
         }
-        return messages;
+        assert(pos == end);
+        static_cast<void>(end);
     }
 
 } // anonymous namespace
@@ -104,57 +120,52 @@ namespace
 namespace Opm
 {
 
-    /// combine (per-process) messages
+    /// combine (per-process) messages on rank 0
     Opm::DeferredLogger gatherDeferredLogger(const Opm::DeferredLogger& local_deferredlogger)
     {
+        int rank = -1;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        int num_processes = -1;
+        MPI_Comm_size(MPI_COMM_WORLD, &num_processes);
 
-        int num_messages = local_deferredlogger.messages_.size();
-
-        int int64_mpi_pack_size;
-        MPI_Pack_size(1, MPI_INT64_T, MPI_COMM_WORLD, &int64_mpi_pack_size);
-        int unsigned_int_mpi_pack_size;
-        MPI_Pack_size(1, MPI_UNSIGNED, MPI_COMM_WORLD, &unsigned_int_mpi_pack_size);
-
-        // store number of messages;
-        int message_size = unsigned_int_mpi_pack_size;
-        // store 1 int64 per message for flag
-        message_size += num_messages*int64_mpi_pack_size;
-        // store 2 unsigned ints per message for length of tag and length of text
-        message_size += num_messages*2*unsigned_int_mpi_pack_size;
-
-        for (const auto lm : local_deferredlogger.messages_) {
-            int string_mpi_pack_size;
-            MPI_Pack_size(lm.tag.size(), MPI_CHAR, MPI_COMM_WORLD, &string_mpi_pack_size);
-            message_size += string_mpi_pack_size;
-            MPI_Pack_size(lm.text.size(), MPI_CHAR, MPI_COMM_WORLD, &string_mpi_pack_size);
-            message_size += string_mpi_pack_size;
-        }
+        const std::vector<char> buffer = packMessages(local_deferredlogger.messages_);
 
-        // Pack local messages.
-        std::vector<char> buffer(message_size);
+        // Only the message sizes are collected from every process,
+        // the messages themselves are only sent by processes which have any.
+        int message_size = buffer.size();
+        std::vector<int> message_sizes(rank == 0 ? num_processes : 0);
+        MPI_Gather(&message_size, 1, MPI_INT, message_sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
 
-        int offset = 0;
-        packMessages(local_deferredlogger.messages_, buffer, offset);
-        assert(offset == message_size);
+        Opm::DeferredLogger global_deferredlogger;
+        if (rank != 0) {
+            if (message_size > 0) {
+                MPI_Send(buffer.data(), message_size, MPI_BYTE, 0, loggerMessageTag, MPI_COMM_WORLD);
+            }
+            return global_deferredlogger;
+        }
 
-        // Get message sizes and create offset/displacement array for gathering.
-        int num_processes = -1;
-        MPI_Comm_size(MPI_COMM_WORLD, &num_processes);
-        std::vector<int> message_sizes(num_processes);
-        MPI_Allgather(&message_size, 1, MPI_INT, message_sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
         std::vector<int> displ(num_processes + 1, 0);
         std::partial_sum(message_sizes.begin(), message_sizes.end(), displ.begin() + 1);
-
-        // Gather.
         std::vector<char> recv_buffer(displ.back());
-        MPI_Allgatherv(buffer.data(), buffer.size(), MPI_PACKED,
-                       const_cast<char*>(recv_buffer.data()), message_sizes.data(),
-                       displ.data(), MPI_PACKED,
-                       MPI_COMM_WORLD);
+        std::copy(buffer.begin(), buffer.end(), recv_buffer.begin());
+
+        std::vector<MPI_Request> requests;
+        for (int process = 1; process < num_processes; ++process) {
+            if (message_sizes[process] > 0) {
+                requests.emplace_back();
+                MPI_Irecv(recv_buffer.data() + displ[process], message_sizes[process], MPI_BYTE,
+                          process, loggerMessageTag, MPI_COMM_WORLD, &requests.back());
+            }
+        }
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
 
-        // Unpack.
-        Opm::DeferredLogger global_deferredlogger;
-        global_deferredlogger.messages_ = unpackMessages(recv_buffer, displ);
+        for (int process = 0; process < num_processes; ++process) {
+            if (message_sizes[process] > 0) {
+                unpackMessages(recv_buffer.data() + displ[process],
+                               recv_buffer.data() + displ[process + 1],
+                               global_deferredlogger.messages_);
+            }
+        }
         return global_deferredlogger;
     }
 
@@ -26,7 +26,10 @@
 namespace Opm
 {
 
-    /// Create a global log combining local logs
+    /// Create a global log combining local logs.
+    /// The messages are only combined on rank 0, which is the process
+    /// logging them, the other processes get an empty logger. Processes
+    /// without messages do not send anything besides their message size.
     Opm::DeferredLogger gatherDeferredLogger(const Opm::DeferredLogger& local_deferredlogger);
 
 } // namespace Opm
@@ -163,7 +163,7 @@ void setupMessageLimiter(const Opm::MessageLimits msgLimits,  const std::string&
 void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& deck, std::unique_ptr<Opm::EclipseState>& eclipseState,
               std::unique_ptr<Opm::Schedule>& schedule, std::unique_ptr<Opm::SummaryConfig>& summaryConfig,
               std::unique_ptr<ErrorGuard> errorGuard, std::shared_ptr<Opm::Python>& python, std::unique_ptr<ParseContext> parseContext,
-              bool initFromRestart, bool checkDeck)
+              bool initFromRestart, bool checkDeck, const std::string& startupCacheDir)
 {
     if (!errorGuard)
     {
@@ -174,6 +174,9 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
     int parseSuccess = 0;
 #endif
     std::string failureMessage;
+    std::string snapshotFile;
+    std::vector<std::string> snapshotInputFiles;
+    bool fromSnapshot = false;
 
     if (rank==0) {
         try
@@ -183,6 +186,25 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
                 OPM_THROW(std::logic_error, "We need a parse context if deck, schedule, or summaryConfig are not initialized");
             }
 
+#if HAVE_MPI
+            if (!startupCacheDir.empty() && !deck && !schedule && !summaryConfig)
+            {
+                snapshotFile = startupSnapshotFileName(startupCacheDir, deckFilename, initFromRestart);
+                deck = std::make_unique<Opm::Deck>();
+                schedule = std::make_unique<Opm::Schedule>(python);
+                summaryConfig = std::make_unique<Opm::SummaryConfig>();
+                fromSnapshot = readStartupSnapshot(snapshotFile, *deck, *schedule, *summaryConfig);
+                if (fromSnapshot) {
+                    OpmLog::info("Read deck, schedule and summary config from the startup snapshot " + snapshotFile);
+                }
+                else {
+                    deck.reset();
+                    schedule.reset();
+                    summaryConfig.reset();
+                }
+            }
+#endif
+
             if (!deck)
             {
                 Opm::Parser parser;
@@ -206,12 +228,15 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
             */
             const auto& init_config = eclipseState->getInitConfig();
             if (init_config.restartRequested() && initFromRestart) {
-                int report_step = init_config.getRestartStep();
-                const auto& rst_filename = eclipseState->getIOConfig().getRestartFileName( init_config.getRestartRootName(), report_step, false );
-                Opm::EclIO::ERst rst_file(rst_filename);
-                const auto& rst_state = Opm::RestartIO::RstState::load(rst_file, report_step);
-                if (!schedule)
+                if (!schedule) {
+                    int report_step = init_config.getRestartStep();
+                    const auto& rst_filename = eclipseState->getIOConfig().getRestartFileName( init_config.getRestartRootName(), report_step, false );
+                    Opm::EclIO::ERst rst_file(rst_filename);
+                    const auto& rst_state = Opm::RestartIO::RstState::load(rst_file, report_step);
                     schedule = std::make_unique<Opm::Schedule>(*deck, *eclipseState, *parseContext, *errorGuard, python, &rst_state);
+                    // the schedule of a snapshot depends on the restart file as well
+                    snapshotInputFiles.push_back(rst_filename);
+                }
             }
             else {
                 if (!schedule)
@@ -264,5 +289,10 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
 
         throw std::runtime_error("Unrecoverable errors were encountered while loading input.");
     }
+
+#if HAVE_MPI
+    if (rank == 0 && !snapshotFile.empty() && !fromSnapshot)
+        writeStartupSnapshot(snapshotFile, *deck, *schedule, *summaryConfig, snapshotInputFiles);
+#endif
 }
 } // end namespace Opm
@@ -56,10 +56,13 @@ void setupMessageLimiter(const Opm::MessageLimits msgLimits,  const std::string&
 /// \brief Reads the deck and creates all necessary objects if needed
 ///
 /// If pointers already contains objects then they are used otherwise they are created and can be used outside later.
+/// If startupCacheDir is not empty, the deck, schedule and summary config are read from a startup
+/// snapshot in that directory if the input files are unchanged, otherwise the snapshot is written
+/// after the deck has been parsed. Snapshots are only supported in builds with MPI.
 void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& deck, std::unique_ptr<Opm::EclipseState>& eclipseState,
               std::unique_ptr<Opm::Schedule>& schedule, std::unique_ptr<Opm::SummaryConfig>& summaryConfig,
               std::unique_ptr<ErrorGuard> errorGuard, std::shared_ptr<Opm::Python>& python, std::unique_ptr<ParseContext> parseContext,
-              bool initFromRestart, bool checkDeck);
+              bool initFromRestart, bool checkDeck, const std::string& startupCacheDir);
 } // end namespace Opm
 
 #endif // OPM_READDECK_HEADER_INCLUDED
@@ -30,7 +30,12 @@
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <cassert>
+#include <exception>
 #include <unordered_map>
 #include <tuple>
 
@@ -43,6 +48,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Group/GConSale.hpp>
 
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
+#include <opm/simulators/timestepping/PhaseTimer.hpp>
 #include <opm/simulators/wells/PerforationData.hpp>
 #include <opm/simulators/wells/VFPInjProperties.hpp>
 #include <opm/simulators/wells/VFPProdProperties.hpp>
@@ -235,10 +241,8 @@ namespace Opm {
             // subtract B*inv(D)*C * x from A*x
             void apply(const BVector& x, BVector& Ax) const;
 
-#if HAVE_CUDA || HAVE_OPENCL
             // accumulate the contributions of all Wells in the WellContributions object
             void getWellContributions(WellContributions& x) const;
-#endif
 
             // apply well model with scaling of alpha
             void applyScaleAdd(const Scalar alpha, const BVector& x, BVector& Ax) const;
@@ -283,6 +287,11 @@ namespace Opm {
             // a vector of all the wells.
             std::vector<WellInterfacePtr > well_container_;
 
+            // the wells of well_container_ (by index) partitioned into sets of wells
+            // which do not perforate any common cell. the wells of a set may thus
+            // write their contributions to the reservoir equations concurrently.
+            std::vector<std::vector<int>> independent_well_sets_;
+
             // map from logically cartesian cell indices to compressed ones
             std::vector<int> cartesian_to_compressed_;
 
@@ -389,6 +398,17 @@ namespace Opm {
 
             void assembleWellEq(const std::vector<Scalar>& B_avg, const double dt, Opm::DeferredLogger& deferred_logger);
 
+            void computeIndependentWellSets();
+
+            // call functor(well, deferred_logger) for the wells of well_container_
+            // with the given indices. if there are enough of them, they are
+            // processed concurrently by all threads, each of which logs into its own
+            // deferred logger. these messages are appended to deferred_logger.
+            template <class Functor>
+            void forEachWell(const std::vector<int>& well_indices,
+                             Opm::DeferredLogger& deferred_logger,
+                             const Functor& functor) const;
+
             // some preparation work, mostly related to group control and RESV,
             // at the beginning of each time step (Not report step)
             void prepareTimeStep(Opm::DeferredLogger& deferred_logger);
@@ -24,6 +24,8 @@
 #include <opm/simulators/wells/SimFIBODetails.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 
+#include <algorithm>
+#include <numeric>
 #include <utility>
 
 namespace Opm {
@@ -127,22 +129,28 @@ namespace Opm {
         if (!localWellsActive())
             return;
 
+        // the wells of a set only write to disjoint rows
+        Opm::DeferredLogger dummy_logger;
         if (!param_.matrix_add_well_contributions_) {
             // if the well contributions are not supposed to be included explicitly in
             // the matrix, we only apply the vector part of the Schur complement here.
-            for (const auto& well: well_container_) {
-                // r = r - duneC_^T * invDuneD_ * resWell_
-                well->apply(res);
+            for (const auto& well_set : independent_well_sets_) {
+                forEachWell(well_set, dummy_logger, [&res](const WellInterfacePtr& well, Opm::DeferredLogger&) {
+                    // r = r - duneC_^T * invDuneD_ * resWell_
+                    well->apply(res);
+                });
             }
             return;
         }
 
-        for (const auto& well: well_container_) {
-            well->addWellContributions(jacobian);
+        for (const auto& well_set : independent_well_sets_) {
+            forEachWell(well_set, dummy_logger, [&jacobian, &res](const WellInterfacePtr& well, Opm::DeferredLogger&) {
+                well->addWellContributions(jacobian);
 
-            // applying the well residual to reservoir residuals
-            // r = r - duneC_^T * invDuneD_ * resWell_
-            well->apply(res);
+                // applying the well residual to reservoir residuals
+                // r = r - duneC_^T * invDuneD_ * resWell_
+                well->apply(res);
+            });
         }
     }
 
@@ -345,6 +353,7 @@ namespace Opm {
             for (auto& well : well_container_) {
                 well->updatePerforatedCell(is_cell_perforated_);
             }
+            computeIndependentWellSets();
 
             // calculate the efficiency factors for each well
             calculateEfficiencyFactors(reportStepIdx);
@@ -815,8 +824,13 @@ namespace Opm {
         }
 
         Opm::DeferredLogger local_deferredLogger;
+        // last_report_ is replaced by the report of solveWellEq()
+        PhaseTimings phaseTimings;
 
-        updatePerforationIntensiveQuantities();
+        {
+            PhaseTimer iqTimer(phaseTimings, "wells/intensive_quantities");
+            updatePerforationIntensiveQuantities();
+        }
 
         int exception_thrown = 0;
         try {
@@ -824,7 +838,10 @@ namespace Opm {
                 calculateExplicitQuantities(local_deferredLogger);
                 prepareTimeStep(local_deferredLogger);
             }
-            updateWellControls(local_deferredLogger, /* check group controls */ true);
+            {
+                PhaseTimer groupTimer(phaseTimings, "wells/group_control");
+                updateWellControls(local_deferredLogger, /* check group controls */ true);
+            }
 
             // Set the well primary variables based on the value of well solutions
             initPrimaryVariablesEvaluation();
@@ -834,6 +851,7 @@ namespace Opm {
 
             if (param_.solve_welleq_initially_ && iterationIdx == 0) {
                 // solve the well equations as a pre-processing step
+                PhaseTimer solveTimer(phaseTimings, "wells/solve");
                 last_report_ = solveWellEq(B_avg, dt, local_deferredLogger);
 
 
@@ -849,11 +867,13 @@ namespace Opm {
                 // reservoir state, will tihs be a better place to inialize the explict information?
             }
 
+            PhaseTimer assembleTimer(phaseTimings, "wells/assemble");
             assembleWellEq(B_avg, dt, local_deferredLogger);
 
         } catch (std::exception& e) {
             exception_thrown = 1;
         }
+        last_report_.phase_timings = std::move(phaseTimings);
         logAndCheckForExceptionsAndThrow(local_deferredLogger, exception_thrown, "assemble() failed.", terminal_output_);
 
         last_report_.converged = true;
@@ -864,8 +884,112 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     assembleWellEq(const std::vector<Scalar>& B_avg, const double dt, Opm::DeferredLogger& deferred_logger)
     {
-        for (auto& well : well_container_) {
-            well->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, deferred_logger);
+        // the well equations only couple to the reservoir state, except for the ones of
+        // wells under group control which depend on the state of the other wells of
+        // the group. the latter are thus assembled after all other wells, which can be
+        // assembled concurrently.
+        std::vector<int> individual_wells;
+        std::vector<int> group_controlled_wells;
+        for (int i = 0; i < static_cast<int>(well_container_.size()); ++i) {
+            const auto& well = well_container_[i];
+            const int w = well->indexOfWell();
+            const bool group_controlled = well->isInjector()
+                ? well_state_.currentInjectionControls()[w] == Well::InjectorCMode::GRUP
+                : well_state_.currentProductionControls()[w] == Well::ProducerCMode::GRUP;
+            if (group_controlled) {
+                group_controlled_wells.push_back(i);
+            } else {
+                individual_wells.push_back(i);
+            }
+        }
+
+        auto assemble = [this, &B_avg, dt](const WellInterfacePtr& well, Opm::DeferredLogger& logger) {
+            well->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, logger);
+        };
+        forEachWell(individual_wells, deferred_logger, assemble);
+        for (const int i : group_controlled_wells) {
+            assemble(well_container_[i], deferred_logger);
+        }
+    }
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    computeIndependentWellSets()
+    {
+        // greedy colouring of the wells, where wells which perforate a common cell are
+        // adjacent
+        independent_well_sets_.clear();
+        std::unordered_map<int, std::vector<int>> cell_sets;
+        std::vector<bool> set_used;
+        for (int i = 0; i < static_cast<int>(well_container_.size()); ++i) {
+            const auto& cells = well_container_[i]->cells();
+            set_used.assign(independent_well_sets_.size(), false);
+            for (const int cell : cells) {
+                const auto it = cell_sets.find(cell);
+                if (it != cell_sets.end()) {
+                    for (const int set : it->second) {
+                        set_used[set] = true;
+                    }
+                }
+            }
+
+            const int set = std::find(set_used.begin(), set_used.end(), false) - set_used.begin();
+            if (set == static_cast<int>(independent_well_sets_.size())) {
+                independent_well_sets_.emplace_back();
+            }
+            independent_well_sets_[set].push_back(i);
+
+            for (const int cell : cells) {
+                cell_sets[cell].push_back(set);
+            }
+        }
+    }
+
+    template<typename TypeTag>
+    template <class Functor>
+    void
+    BlackoilWellModel<TypeTag>::
+    forEachWell(const std::vector<int>& well_indices,
+                Opm::DeferredLogger& deferred_logger,
+                const Functor& functor) const
+    {
+        const int num_wells = well_indices.size();
+#ifdef _OPENMP
+        // below this, the overhead of a parallel region is not worth it
+        const int min_wells_for_threading = 16;
+        const int num_threads = omp_get_max_threads();
+        if (num_threads > 1 && num_wells >= min_wells_for_threading) {
+            std::vector<Opm::DeferredLogger> thread_loggers(num_threads);
+            std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < num_wells; ++i) {
+                try {
+                    functor(well_container_[well_indices[i]], thread_loggers[omp_get_thread_num()]);
+                }
+                catch (...) {
+#pragma omp critical
+                    {
+                        if (!exception) {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
+            }
+
+            for (const auto& logger : thread_loggers) {
+                deferred_logger.append(logger);
+            }
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+            return;
+        }
+#endif
+
+        for (int i = 0; i < num_wells; ++i) {
+            functor(well_container_[well_indices[i]], deferred_logger);
         }
     }
 
@@ -878,8 +1002,12 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(r);
+        // the wells of a set only write to disjoint rows of r
+        Opm::DeferredLogger dummy_logger;
+        for (const auto& well_set : independent_well_sets_) {
+            forEachWell(well_set, dummy_logger, [&r](const WellInterfacePtr& well, Opm::DeferredLogger&) {
+                well->apply(r);
+            });
         }
     }
 
@@ -895,12 +1023,15 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(x, Ax);
+        // the wells of a set only write to disjoint rows of Ax
+        Opm::DeferredLogger dummy_logger;
+        for (const auto& well_set : independent_well_sets_) {
+            forEachWell(well_set, dummy_logger, [&x, &Ax](const WellInterfacePtr& well, Opm::DeferredLogger&) {
+                well->apply(x, Ax);
+            });
         }
     }
 
-#if HAVE_CUDA || HAVE_OPENCL
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -937,7 +1068,6 @@ namespace Opm {
             }
         }
     }
-#endif
 
     // Ax = Ax - alpha * C D^-1 B x
     template<typename TypeTag>
@@ -974,9 +1104,13 @@ namespace Opm {
         int exception_thrown = 0;
         try {
             if (localWellsActive()) {
-                for (auto& well : well_container_) {
-                    well->recoverWellSolutionAndUpdateWellState(x, well_state_, local_deferredLogger);
-                }
+                // each well only updates its own part of the well state
+                std::vector<int> all_wells(well_container_.size());
+                std::iota(all_wells.begin(), all_wells.end(), 0);
+                forEachWell(all_wells, local_deferredLogger,
+                            [this, &x](const WellInterfacePtr& well, Opm::DeferredLogger& logger) {
+                                well->recoverWellSolutionAndUpdateWellState(x, well_state_, logger);
+                            });
             }
         } catch (std::exception& e) {
             exception_thrown = 1;
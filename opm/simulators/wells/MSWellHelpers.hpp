@@ -31,17 +31,24 @@
 #if HAVE_UMFPACK
 #include <dune/istl/umfpack.hh>
 #endif // HAVE_UMFPACK
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <vector>
 
 namespace Opm {
 
 namespace mswellhelpers
 {
 
-    /// Applies umfpack and checks for singularity
+    /// Applies umfpack and checks for singularity, y = D^-1 x
+    ///
+    /// This variant does not allocate any memory for the vectors. x is not
+    /// modified, but UMFPack insists on a mutable right hand side.
     template <typename MatrixType, typename VectorType>
-    VectorType
-    applyUMFPack(const MatrixType& D, std::shared_ptr<Dune::UMFPack<MatrixType> >& linsolver, VectorType x)
+    void
+    applyUMFPack(const MatrixType& D, std::shared_ptr<Dune::UMFPack<MatrixType> >& linsolver,
+                 VectorType& x, VectorType& y)
     {
 #if HAVE_UMFPACK
         if (!linsolver)
@@ -49,8 +56,6 @@ namespace mswellhelpers
             linsolver.reset(new Dune::UMFPack<MatrixType>(D, 0));
         }
 
-        // The copy of x seems mandatory for calling UMFPack!
-        VectorType y(x.size());
         y = 0.;
 
         // Object storing some statistics about the solving process
@@ -68,7 +73,6 @@ namespace mswellhelpers
                 }
             }
         }
-        return y;
 #else
         // this is not thread safe
         OPM_THROW(std::runtime_error, "Cannot use applyUMFPack() without UMFPACK. "
@@ -78,6 +82,168 @@ namespace mswellhelpers
 
 
 
+    /// Applies umfpack and checks for singularity
+    template <typename MatrixType, typename VectorType>
+    VectorType
+    applyUMFPack(const MatrixType& D, std::shared_ptr<Dune::UMFPack<MatrixType> >& linsolver, VectorType x)
+    {
+        // The copy of x seems mandatory for calling UMFPack!
+        VectorType y(x.size());
+        applyUMFPack(D, linsolver, x, y);
+        return y;
+    }
+
+
+
+    /// Direct solver for the segment equations of a multisegment well.
+    ///
+    /// The segments form a tree and so does the block sparsity pattern of the
+    /// matrix D of the segment equations. A block LU factorization which eliminates
+    /// the segments from the leaves towards the top segment thus causes no fill-in,
+    /// and the factors fit into a few blocks per segment. Once factorized, solving
+    /// does not allocate any memory.
+    ///
+    /// The elimination does not pivot between segments. factorize() returns false if
+    /// the pattern is not a tree or if a diagonal block turns out to be singular, in
+    /// which case a general sparse solver has to be used instead.
+    template <typename MatrixType, typename VectorType>
+    class SegmentTreeSolver
+    {
+    public:
+        using Block = typename MatrixType::block_type;
+
+        bool factorize(const MatrixType& D)
+        {
+            factorized_ = false;
+            if (!patternAnalysed_) {
+                isTree_ = analysePattern_(D);
+                patternAnalysed_ = true;
+            }
+            if (!isTree_)
+                return false;
+
+            const int n = D.N();
+            invDiag_.resize(n);
+            lower_.resize(n);
+            upper_.resize(n);
+            for (int seg = 0; seg < n; ++seg)
+                invDiag_[seg] = D[seg][seg];
+
+            try {
+                for (const int seg : order_) {
+                    invDiag_[seg].invert();
+
+                    const int outlet = outlet_[seg];
+                    if (outlet < 0)
+                        continue;
+
+                    // D_oo -= D_os * D_ss^-1 * D_so
+                    lower_[seg] = D[outlet][seg];
+                    lower_[seg].rightmultiply(invDiag_[seg]);
+                    upper_[seg] = D[seg][outlet];
+                    Block update = lower_[seg];
+                    update.rightmultiply(upper_[seg]);
+                    invDiag_[outlet] -= update;
+                }
+            }
+            catch (const Dune::FMatrixError&) {
+                return false;
+            }
+
+            for (const auto& block : invDiag_)
+                for (const auto& row : block)
+                    for (const auto& value : row)
+                        if (!std::isfinite(value))
+                            return false;
+
+            factorized_ = true;
+            return true;
+        }
+
+        bool isFactorized() const
+        { return factorized_; }
+
+        void reset()
+        { factorized_ = false; }
+
+        // x = D^-1 rhs
+        void solve(const VectorType& rhs, VectorType& x) const
+        {
+            assert(factorized_);
+            assert(rhs.size() == x.size());
+
+            // forward substitution from the leaves towards the top segment
+            x = rhs;
+            for (const int seg : order_) {
+                const int outlet = outlet_[seg];
+                if (outlet >= 0)
+                    lower_[seg].mmv(x[seg], x[outlet]);
+            }
+
+            // backward substitution from the top segment towards the leaves
+            for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+                const int seg = *it;
+                auto z = x[seg];
+                const int outlet = outlet_[seg];
+                if (outlet >= 0)
+                    upper_[seg].mmv(x[outlet], z);
+                invDiag_[seg].mv(z, x[seg]);
+            }
+        }
+
+    private:
+        // find the tree of the segments by a breadth-first search starting from the
+        // top segment. the elimination order is the reverse of the search order.
+        bool analysePattern_(const MatrixType& D)
+        {
+            const int n = D.N();
+            outlet_.assign(n, -1);
+            order_.clear();
+
+            // a tree has n - 1 edges, each of which appears twice in the pattern
+            if (n == 0 || D.nonzeroes() != static_cast<size_t>(3*n - 2))
+                return false;
+
+            std::vector<bool> visited(n, false);
+            order_.reserve(n);
+            order_.push_back(0);
+            visited[0] = true;
+            for (size_t k = 0; k < order_.size(); ++k) {
+                const int seg = order_[k];
+                for (auto col = D[seg].begin(); col != D[seg].end(); ++col) {
+                    const int neighbor = col.index();
+                    if (visited[neighbor])
+                        continue;
+
+                    visited[neighbor] = true;
+                    outlet_[neighbor] = seg;
+                    order_.push_back(neighbor);
+                }
+            }
+
+            if (order_.size() != static_cast<size_t>(n))
+                return false;
+
+            std::reverse(order_.begin(), order_.end());
+            return true;
+        }
+
+        bool patternAnalysed_ = false;
+        bool isTree_ = false;
+        bool factorized_ = false;
+
+        // segments in elimination order and the segment each of them is eliminated into
+        std::vector<int> order_;
+        std::vector<int> outlet_;
+
+        // inverses of the diagonal blocks of U, the off-diagonal blocks of L and U
+        std::vector<Block> invDiag_;
+        std::vector<Block> lower_;
+        std::vector<Block> upper_;
+    };
+
+
+
     // obtain y = D^-1 * x with a BICSSTAB iterative solver
     template <typename MatrixType, typename VectorType>
     VectorType
@@ -24,6 +24,7 @@
 
 
 #include <opm/simulators/wells/WellInterface.hpp>
+#include <opm/simulators/wells/MSWellHelpers.hpp>
 
 namespace Opm
 {
@@ -135,10 +136,8 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA || HAVE_OPENCL
         /// add the contribution (C, D, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
-#endif
 
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
@@ -240,6 +239,14 @@ namespace Opm
         ///
         /// This is a shared_ptr as MultisegmentWell is copied in computeWellPotentials...
         mutable std::shared_ptr<Dune::UMFPack<DiagMatWell> > duneDSolver_;
+        /// \brief block LU factorization of the diagonal matrix along the segment tree
+        ///
+        /// duneDSolver_ is only used if this factorization is not possible.
+        mutable mswellhelpers::SegmentTreeSolver<DiagMatWell, BVectorWell> duneDTreeSolver_;
+
+        // workspace of apply(), so that it does not need to allocate memory
+        mutable BVectorWell Bx_;
+        mutable BVectorWell invDBx_;
 
         // residuals of the well equations
         mutable BVectorWell resWell_;
@@ -296,6 +303,9 @@ namespace Opm
         // xw = inv(D)*(rw - C*x)
         void recoverSolutionWell(const BVector& x, BVectorWell& xw) const;
 
+        // x = duneD_^-1 * rhs
+        void solveSegmentSystem(BVectorWell& rhs, BVectorWell& x) const;
+
         // updating the well_state based on well solution dwells
         void updateWellState(const BVectorWell& dwells,
                              WellState& well_state,
@@ -222,6 +222,8 @@ namespace Opm
         }
 
         resWell_.resize( numberOfSegments() );
+        Bx_.resize( numberOfSegments() );
+        invDBx_.resize( numberOfSegments() );
 
         primary_variables_.resize(numberOfSegments());
         primary_variables_evaluation_.resize(numberOfSegments());
@@ -619,15 +621,13 @@ namespace Opm
     MultisegmentWell<TypeTag>::
     apply(const BVector& x, BVector& Ax) const
     {
-        BVectorWell Bx(duneB_.N());
-
-        duneB_.mv(x, Bx);
+        duneB_.mv(x, Bx_);
 
         // invDBx = duneD^-1 * Bx_
-        const BVectorWell invDBx = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, Bx);
+        solveSegmentSystem(Bx_, invDBx_);
 
         // Ax = Ax - duneC_^T * invDBx
-        duneC_.mmtv(invDBx,Ax);
+        duneC_.mmtv(invDBx_,Ax);
     }
 
 
@@ -640,14 +640,36 @@ namespace Opm
     apply(BVector& r) const
     {
         // invDrw_ = duneD^-1 * resWell_
-        const BVectorWell invDrw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+        solveSegmentSystem(resWell_, invDBx_);
         // r = r - duneC_^T * invDrw
-        duneC_.mmtv(invDrw, r);
+        duneC_.mmtv(invDBx_, r);
+    }
+
+
+
+
+
+    template <typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    solveSegmentSystem(BVectorWell& rhs, BVectorWell& x) const
+    {
+        // the factorization is computed at the first solve after the assembly. the
+        // sparse direct solver is only needed if the block factorization along the
+        // segment tree fails.
+        if (!duneDTreeSolver_.isFactorized() && !duneDSolver_) {
+            duneDTreeSolver_.factorize(duneD_);
+        }
+
+        if (duneDTreeSolver_.isFactorized()) {
+            duneDTreeSolver_.solve(rhs, x);
+        } else {
+            mswellhelpers::applyUMFPack(duneD_, duneDSolver_, rhs, x);
+        }
     }
 
 
 
-#if HAVE_CUDA || HAVE_OPENCL
     template<typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
@@ -706,7 +728,6 @@ namespace Opm
 
         wellContribs.addMultisegmentWellContribution(numEq, numWellEq, Nb, Mb, BnumBlocks, Bvals, Bcols, Brows, DnumBlocks, Dvals, Dcols, Drows, Cvals);
     }
-#endif
 
 
     template <typename TypeTag>
@@ -999,7 +1020,8 @@ namespace Opm
         // resWell = resWell - B * x
         duneB_.mmv(x, resWell);
         // xw = D^-1 * resWell
-        xw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell);
+        xw.resize(resWell.size());
+        solveSegmentSystem(resWell, xw);
     }
 
 
@@ -1013,7 +1035,8 @@ namespace Opm
     {
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
-        const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+        BVectorWell dx_well(numberOfSegments());
+        solveSegmentSystem(resWell_, dx_well);
 
         updateWellState(dx_well, well_state, deferred_logger);
     }
@@ -2396,7 +2419,8 @@ namespace Opm
 
             assembleWellEqWithoutIteration(ebosSimulator, dt, inj_controls, prod_controls, well_state, deferred_logger);
 
-            const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+            BVectorWell dx_well(numberOfSegments());
+            solveSegmentSystem(resWell_, dx_well);
 
             if (it > param_.strict_inner_iter_ms_wells_)
                 relax_convergence = true;
@@ -2511,6 +2535,7 @@ namespace Opm
         resWell_ = 0.0;
 
         duneDSolver_.reset();
+        duneDTreeSolver_.reset();
 
         well_state.wellVaporizedOilRates()[index_of_well_] = 0.;
         well_state.wellDissolvedGasRates()[index_of_well_] = 0.;
@@ -23,9 +23,7 @@
 #ifndef OPM_STANDARDWELL_HEADER_INCLUDED
 #define OPM_STANDARDWELL_HEADER_INCLUDED
 
-#if HAVE_CUDA || HAVE_OPENCL
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
-#endif
 
 #include <opm/simulators/wells/RateConverter.hpp>
 #include <opm/simulators/wells/WellInterface.hpp>
@@ -187,13 +185,11 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA || HAVE_OPENCL
         /// add the contribution (C, D^-1, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
 
         /// get the number of blocks of the C and B matrices, used to allocate memory in a WellContributions object
         void getNumBlocks(unsigned int& _nnzs) const;
-#endif
 
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
@@ -2326,7 +2326,6 @@ namespace Opm
         duneC_.mmtv(invDrw_, r);
     }
 
-#if HAVE_CUDA || HAVE_OPENCL
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2384,7 +2383,6 @@ namespace Opm
     {
         numBlocks = duneB_.nonzeroes();
     }
-#endif
 
 
     template<typename TypeTag>
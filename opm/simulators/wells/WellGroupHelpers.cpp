@@ -22,6 +22,8 @@
 #include <opm/simulators/wells/TargetCalculator.hpp>
 
 #include <algorithm>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -44,6 +46,231 @@ namespace {
 
         return {oilRate, gasRate, waterRate};
     }
+
+    using GroupTree = Opm::WellStateFullyImplicitBlackoil::GroupTree;
+
+    // Index of the group in the group tree of the well state, -1 if the
+    // tree has not been set up for the report step.
+    int treeGroupIndex(const Opm::WellStateFullyImplicitBlackoil& wellState,
+                       const std::string& groupName,
+                       const int reportStepIdx)
+    {
+        const auto& tree = wellState.groupTree();
+        if (!tree.validFor(reportStepIdx))
+            return -1;
+
+        const int groupIdx = wellState.groupIndex(groupName);
+        return groupIdx < tree.numGroups() ? groupIdx : -1;
+    }
+
+    // Sum the rates of the local producers or injectors of a group and its
+    // subgroups, wellRate(well_index) returns the rate of a local well.
+    template <class WellRate>
+    double sumWellRatesTree(const GroupTree& tree, const int groupIdx, const bool injector, const WellRate& wellRate)
+    {
+        double rate = 0.0;
+        for (int c = tree.child_offset[groupIdx]; c < tree.child_offset[groupIdx + 1]; ++c) {
+            const int child = tree.children[c];
+            rate += tree.efficiency[child] * sumWellRatesTree(tree, child, injector, wellRate);
+        }
+        for (int w = tree.well_offset[groupIdx]; w < tree.well_offset[groupIdx + 1]; ++w) {
+            const int well_index = tree.well_local_index[w];
+            if (well_index < 0) // the well is not found
+                continue;
+
+            // only count producers or injectors
+            if (static_cast<bool>(tree.well_is_injector[w]) != injector)
+                continue;
+
+            if (tree.well_is_shut[w])
+                continue;
+
+            if (injector)
+                rate += tree.well_efficiency[w] * wellRate(well_index);
+            else
+                rate -= tree.well_efficiency[w] * wellRate(well_index);
+        }
+        return rate;
+    }
+
+    int groupControlledWellsTree(const GroupTree& tree,
+                                 const Opm::WellStateFullyImplicitBlackoil& well_state,
+                                 const int groupIdx,
+                                 const int always_included_group,
+                                 const int always_included_well)
+    {
+        int num_wells = 0;
+        for (int c = tree.child_offset[groupIdx]; c < tree.child_offset[groupIdx + 1]; ++c) {
+            const int child = tree.children[c];
+            const auto ctrl = well_state.currentProductionGroupControl(child);
+            const bool included = (ctrl == Opm::Group::ProductionCMode::FLD) || (ctrl == Opm::Group::ProductionCMode::NONE)
+                || (child == always_included_group);
+            if (included) {
+                num_wells += groupControlledWellsTree(tree, well_state, child, always_included_group, always_included_well);
+            }
+        }
+        for (int w = tree.well_offset[groupIdx]; w < tree.well_offset[groupIdx + 1]; ++w) {
+            const int global_index = tree.well_global_index[w];
+            const bool included = well_state.isProductionGrup(global_index) || (global_index == always_included_well);
+            if (included) {
+                ++num_wells;
+            }
+        }
+        return num_wells;
+    }
+
+    // Same as the recursive updateGroupTargetReduction(), but as a single
+    // bottom-up pass over the group tree that also accumulates the rates and
+    // the number of group controlled wells of every subgroup on the way.
+    void updateGroupTargetReductionTree(const int rootIdx,
+                                        const bool isInjector,
+                                        const Opm::PhaseUsage& pu,
+                                        const Opm::GuideRate& guide_rate,
+                                        const Opm::WellStateFullyImplicitBlackoil& wellStateNupcol,
+                                        Opm::WellStateFullyImplicitBlackoil& wellState,
+                                        std::vector<double>& groupTargetReduction)
+    {
+        using namespace Opm;
+
+        const auto& tree = wellState.groupTree();
+        const auto& treeNupcol = wellStateNupcol.groupTree();
+        const int np = wellState.numPhases();
+        const int ng = tree.numGroups();
+
+        // groups of the subtree, every group after all of its subgroups
+        std::vector<int> order;
+        std::vector<int> stack(1, rootIdx);
+        while (!stack.empty()) {
+            const int groupIdx = stack.back();
+            stack.pop_back();
+            order.push_back(groupIdx);
+            for (int c = tree.child_offset[groupIdx]; c < tree.child_offset[groupIdx + 1]; ++c) {
+                stack.push_back(tree.children[c]);
+            }
+        }
+        std::reverse(order.begin(), order.end());
+
+        std::vector<std::pair<Phase, int>> injectionPhases;
+        if (pu.phase_used[BlackoilPhases::Aqua])
+            injectionPhases.emplace_back(Phase::WATER, pu.phase_pos[BlackoilPhases::Aqua]);
+        if (pu.phase_used[BlackoilPhases::Liquid])
+            injectionPhases.emplace_back(Phase::OIL, pu.phase_pos[BlackoilPhases::Liquid]);
+        if (pu.phase_used[BlackoilPhases::Vapour])
+            injectionPhases.emplace_back(Phase::GAS, pu.phase_pos[BlackoilPhases::Vapour]);
+
+        std::vector<double> reduction(ng * np, 0.0);
+        // the rates of the subtrees, as given by sumWellRates() for wellStateNupcol
+        std::vector<double> rates(ng * np, 0.0);
+        std::vector<int> numGroupControlledWells(ng, 0);
+        std::copy(groupTargetReduction.begin(), groupTargetReduction.end(), reduction.begin() + rootIdx * np);
+
+        const auto& wellRatesNupcol = wellStateNupcol.wellRates();
+        for (const int groupIdx : order) {
+            double* groupReduction = &reduction[groupIdx * np];
+            double* groupRates = &rates[groupIdx * np];
+
+            for (int c = tree.child_offset[groupIdx]; c < tree.child_offset[groupIdx + 1]; ++c) {
+                const int child = tree.children[c];
+                const double* subGroupReduction = &reduction[child * np];
+                const double* subGroupRates = &rates[child * np];
+
+                for (int phase = 0; phase < np; phase++) {
+                    groupRates[phase] += tree.efficiency[child] * subGroupRates[phase];
+                }
+
+                // accumulate group contribution from sub group
+                if (isInjector) {
+                    for (const auto& phaseAndPos : injectionPhases) {
+                        const int phasePos = phaseAndPos.second;
+                        const Group::InjectionCMode& currentGroupControl
+                            = wellState.currentInjectionGroupControl(phaseAndPos.first, child);
+                        if (currentGroupControl != Group::InjectionCMode::FLD
+                            && currentGroupControl != Group::InjectionCMode::NONE) {
+                            // Subgroup is under individual control.
+                            groupReduction[phasePos] += subGroupRates[phasePos];
+                        } else {
+                            groupReduction[phasePos] += subGroupReduction[phasePos];
+                        }
+                    }
+                } else {
+                    const Group::ProductionCMode& currentGroupControl = wellState.currentProductionGroupControl(child);
+                    const bool individual_control = (currentGroupControl != Group::ProductionCMode::FLD
+                                                     && currentGroupControl != Group::ProductionCMode::NONE);
+                    if (individual_control || numGroupControlledWells[child] == 0) {
+                        for (int phase = 0; phase < np; phase++) {
+                            groupReduction[phase] += subGroupRates[phase];
+                        }
+                    } else {
+                        // The subgroup may participate in group control.
+                        if (!guide_rate.has(wellState.groupName(child))) {
+                            // Accumulate from this subgroup only if no group guide rate is set for it.
+                            for (int phase = 0; phase < np; phase++) {
+                                groupReduction[phase] += subGroupReduction[phase];
+                            }
+                        }
+                    }
+
+                    // the number of group controlled wells is only needed for subgroups
+                    if (groupIdx != rootIdx) {
+                        const auto ctrl = wellStateNupcol.currentProductionGroupControl(child);
+                        if (ctrl == Group::ProductionCMode::FLD || ctrl == Group::ProductionCMode::NONE) {
+                            numGroupControlledWells[groupIdx] += numGroupControlledWells[child];
+                        }
+                    }
+                }
+            }
+
+            for (int w = tree.well_offset[groupIdx]; w < tree.well_offset[groupIdx + 1]; ++w) {
+                if (!isInjector && groupIdx != rootIdx && wellStateNupcol.isProductionGrup(tree.well_global_index[w])) {
+                    ++numGroupControlledWells[groupIdx];
+                }
+
+                if (static_cast<bool>(tree.well_is_injector[w]) != isInjector)
+                    continue;
+
+                if (tree.well_is_shut[w])
+                    continue;
+
+                const double efficiency = tree.well_efficiency[w];
+                const int nupcol_index = treeNupcol.well_local_index[w];
+                if (nupcol_index >= 0) {
+                    for (int phase = 0; phase < np; phase++) {
+                        const double rate = efficiency * wellRatesNupcol[nupcol_index * np + phase];
+                        groupRates[phase] += isInjector ? rate : -rate;
+                    }
+                }
+
+                const int well_index = tree.well_local_index[w];
+                if (well_index < 0) // the well is not found
+                    continue;
+
+                const auto wellrate_index = well_index * np;
+                // add contributino from wells not under group control
+                if (isInjector) {
+                    if (wellState.currentInjectionControls()[well_index] != Well::InjectorCMode::GRUP)
+                        for (int phase = 0; phase < np; phase++) {
+                            groupReduction[phase] += wellRatesNupcol[wellrate_index + phase] * efficiency;
+                        }
+                } else {
+                    if (wellState.currentProductionControls()[well_index] != Well::ProducerCMode::GRUP)
+                        for (int phase = 0; phase < np; phase++) {
+                            groupReduction[phase] -= wellRatesNupcol[wellrate_index + phase] * efficiency;
+                        }
+                }
+            }
+
+            for (int phase = 0; phase < np; phase++) {
+                groupReduction[phase] *= tree.efficiency[groupIdx];
+            }
+            const std::vector<double> target(groupReduction, groupReduction + np);
+            if (isInjector)
+                wellState.setCurrentInjectionGroupReductionRates(groupIdx, target);
+            else
+                wellState.setCurrentProductionGroupReductionRates(groupIdx, target);
+        }
+
+        std::copy(reduction.begin() + rootIdx * np, reduction.begin() + (rootIdx + 1) * np, groupTargetReduction.begin());
+    }
 } // namespace Anonymous
 
 namespace Opm
@@ -119,6 +346,13 @@ namespace WellGroupHelpers
                              const int phasePos,
                              const bool injector)
     {
+        const int groupIdx = treeGroupIndex(wellState, group.name(), reportStepIdx);
+        if (groupIdx >= 0) {
+            const int np = wellState.numPhases();
+            return sumWellRatesTree(wellState.groupTree(), groupIdx, injector, [&rates, np, phasePos](const int well_index) {
+                return rates[well_index * np + phasePos];
+            });
+        }
 
         double rate = 0.0;
         for (const std::string& groupName : group.groups()) {
@@ -179,6 +413,12 @@ namespace WellGroupHelpers
                            const int reportStepIdx,
                            const bool injector)
     {
+        const int groupIdx = treeGroupIndex(wellState, group.name(), reportStepIdx);
+        if (groupIdx >= 0) {
+            return sumWellRatesTree(wellState.groupTree(), groupIdx, injector, [&wellState](const int well_index) {
+                return wellState.solventWellRate(well_index);
+            });
+        }
 
         double rate = 0.0;
         for (const std::string& groupName : group.groups()) {
@@ -221,6 +461,13 @@ namespace WellGroupHelpers
                                     WellStateFullyImplicitBlackoil& wellState,
                                     std::vector<double>& groupTargetReduction)
     {
+        const int rootIdx = treeGroupIndex(wellState, group.name(), reportStepIdx);
+        if (rootIdx >= 0 && wellStateNupcol.groupTree().validFor(reportStepIdx)) {
+            updateGroupTargetReductionTree(
+                rootIdx, isInjector, pu, guide_rate, wellStateNupcol, wellState, groupTargetReduction);
+            return;
+        }
+
         const int np = wellState.numPhases();
         for (const std::string& subGroupName : group.groups()) {
             std::vector<double> subGroupTargetReduction(np, 0.0);
@@ -693,6 +940,16 @@ namespace WellGroupHelpers
                              const std::string& group_name,
                              const std::string& always_included_child)
     {
+        const int groupIdx = treeGroupIndex(well_state, group_name, report_step);
+        if (groupIdx >= 0) {
+            const int always_included_group
+                = always_included_child.empty() ? -1 : well_state.groupIndex(always_included_child);
+            const int always_included_well
+                = always_included_child.empty() ? -1 : well_state.globalWellIndex(always_included_child);
+            return groupControlledWellsTree(
+                well_state.groupTree(), well_state, groupIdx, always_included_group, always_included_well);
+        }
+
         const Group& group = schedule.getGroup(group_name, report_step);
         int num_wells = 0;
         for (const std::string& child_group : group.groups()) {
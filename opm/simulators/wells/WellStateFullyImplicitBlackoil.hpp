@@ -34,6 +34,7 @@
 #include <string>
 #include <utility>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <array>
 #include <iostream>
@@ -83,7 +84,10 @@ namespace Opm
 
             globalIsInjectionGrup_.assign(globalNumberOfWells,0);
             globalIsProductionGrup_.assign(globalNumberOfWells,0);
-            wellNameToGlobalIdx_.clear();
+
+            // the group and well numbering must be the same on all processes,
+            // so it is set up before returning for processes without wells
+            updateGroupIndices(schedule, report_step);
 
             const int nw = wells_ecl.size();
 
@@ -330,170 +334,246 @@ namespace Opm
         std::vector<Well::ProducerCMode>& currentProductionControls() { return current_production_controls_; }
         const std::vector<Well::ProducerCMode>& currentProductionControls() const { return current_production_controls_; }
 
+        /// Group hierarchy of one report step, with the groups numbered as in
+        /// Schedule::groupNames() and stored in compressed row format.  The
+        /// subgroups of group g are children[child_offset[g]] until
+        /// children[child_offset[g+1]], its wells are the entries
+        /// well_offset[g] until well_offset[g+1] of the well_* arrays.
+        struct GroupTree
+        {
+            int report_step = -1;
+
+            std::vector<int> parent; // -1 for the root (FIELD)
+            std::vector<double> efficiency;
+            std::vector<int> child_offset;
+            std::vector<int> children;
+
+            std::vector<int> well_offset;
+            std::vector<int> well_local_index; // -1 if the well is not on this process
+            std::vector<int> well_global_index;
+            std::vector<double> well_efficiency;
+            std::vector<char> well_is_injector;
+            std::vector<char> well_is_shut;
+
+            int numGroups() const { return parent.size(); }
+
+            bool validFor(const int step) const { return report_step == step; }
+        };
+
+        const GroupTree& groupTree() const { return group_tree_; }
+
+        /// Index of a group in the dense group state, -1 if unknown.
+        int groupIndex(const std::string& groupName) const {
+            return group_index_.find(groupName);
+        }
+
+        const std::string& groupName(const int groupIdx) const {
+            return group_index_.name(groupIdx);
+        }
+
+        /// Index of a well in the global well numbering of the schedule, -1 if unknown.
+        int globalWellIndex(const std::string& wellName) const {
+            return well_index_.find(wellName);
+        }
+
         bool hasProductionGroupControl(const std::string& groupName) const {
-            return current_production_group_controls_.count(groupName) > 0;
+            return current_production_group_controls_.has(group_index_.find(groupName));
         }
 
         bool hasInjectionGroupControl(const Opm::Phase& phase, const std::string& groupName) const {
-            return current_injection_group_controls_.count(std::make_pair(phase, groupName)) > 0;
+            const int phaseIdx = injectionPhaseIndex(phase);
+            return phaseIdx >= 0 && current_injection_group_controls_[phaseIdx].has(group_index_.find(groupName));
         }
 
         /// One current control per group.
         void setCurrentProductionGroupControl(const std::string& groupName, const Group::ProductionCMode& groupControl ) {
-            current_production_group_controls_[groupName] = groupControl;
+            current_production_group_controls_.set(insertGroup(groupName), groupControl);
         }
 
         const Group::ProductionCMode& currentProductionGroupControl(const std::string& groupName) const {
-            auto it = current_production_group_controls_.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == current_production_group_controls_.end())
+            if (!current_production_group_controls_.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any control for production group " << groupName);
 
-            return it->second;
+            return current_production_group_controls_.get(groupIdx);
+        }
+
+        const Group::ProductionCMode& currentProductionGroupControl(const int groupIdx) const {
+            if (!current_production_group_controls_.has(groupIdx))
+                OPM_THROW(std::logic_error, "Could not find any control for production group with index " << groupIdx);
+
+            return current_production_group_controls_.get(groupIdx);
         }
 
         /// One current control per group.
         void setCurrentInjectionGroupControl(const Opm::Phase& phase, const std::string& groupName, const Group::InjectionCMode& groupControl ) {
-            current_injection_group_controls_[std::make_pair(phase, groupName)] = groupControl;
+            const int phaseIdx = injectionPhaseIndex(phase);
+            if (phaseIdx < 0)
+                OPM_THROW(std::logic_error, "Injection group control is not supported for phase " << phase);
+
+            current_injection_group_controls_[phaseIdx].set(insertGroup(groupName), groupControl);
         }
 
         const Group::InjectionCMode& currentInjectionGroupControl(const Opm::Phase& phase, const std::string& groupName) const {
-            auto it = current_injection_group_controls_.find(std::make_pair(phase, groupName));
+            const int groupIdx = group_index_.find(groupName);
+            const int phaseIdx = injectionPhaseIndex(phase);
 
-            if (it == current_injection_group_controls_.end())
+            if (phaseIdx < 0 || !current_injection_group_controls_[phaseIdx].has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any control for " << phase << " injection group " << groupName);
 
-            return it->second;
+            return current_injection_group_controls_[phaseIdx].get(groupIdx);
         }
-        
+
+        const Group::InjectionCMode& currentInjectionGroupControl(const Opm::Phase& phase, const int groupIdx) const {
+            const int phaseIdx = injectionPhaseIndex(phase);
+
+            if (phaseIdx < 0 || !current_injection_group_controls_[phaseIdx].has(groupIdx))
+                OPM_THROW(std::logic_error, "Could not find any control for " << phase << " injection group with index " << groupIdx);
+
+            return current_injection_group_controls_[phaseIdx].get(groupIdx);
+        }
+
         void setCurrentWellRates(const std::string& wellName, const std::vector<double>& rates ) {
-            well_rates[wellName] = rates;
+            int wellIdx = well_index_.find(wellName);
+            if (wellIdx < 0) {
+                wellIdx = well_index_.insert(wellName);
+                well_rates.resize(well_index_.size());
+            }
+            well_rates.set(wellIdx, rates);
         }
 
         const std::vector<double>& currentWellRates(const std::string& wellName) const {
-            auto it = well_rates.find(wellName);
+            const int wellIdx = well_index_.find(wellName);
 
-            if (it == well_rates.end())
+            if (!well_rates.has(wellIdx))
                 OPM_THROW(std::logic_error, "Could not find any rates for well  " << wellName);
 
-            return it->second;
+            return well_rates.get(wellIdx);
         }
 
         bool hasWellRates(const std::string& wellName) const {
-            return this->well_rates.find(wellName) != this->well_rates.end();
+            return this->well_rates.has(well_index_.find(wellName));
         }
 
         void setCurrentProductionGroupRates(const std::string& groupName, const std::vector<double>& rates ) {
-            production_group_rates[groupName] = rates;
+            production_group_rates.set(insertGroup(groupName), rates);
         }
 
         const std::vector<double>& currentProductionGroupRates(const std::string& groupName) const {
-            auto it = production_group_rates.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == production_group_rates.end())
+            if (!production_group_rates.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any rates for productino group  " << groupName);
 
-            return it->second;
+            return production_group_rates.get(groupIdx);
         }
 
         bool hasProductionGroupRates(const std::string& groupName) const {
-            return this->production_group_rates.find(groupName) != this->production_group_rates.end();
+            return this->production_group_rates.has(group_index_.find(groupName));
         }
-        
+
         void setCurrentProductionGroupReductionRates(const std::string& groupName, const std::vector<double>& target ) {
-            production_group_reduction_rates[groupName] = target;
+            production_group_reduction_rates.set(insertGroup(groupName), target);
+        }
+
+        void setCurrentProductionGroupReductionRates(const int groupIdx, const std::vector<double>& target ) {
+            production_group_reduction_rates.set(groupIdx, target);
         }
 
         const std::vector<double>& currentProductionGroupReductionRates(const std::string& groupName) const {
-            auto it = production_group_reduction_rates.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == production_group_reduction_rates.end())
+            if (!production_group_reduction_rates.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any reduction rates for production group  " << groupName);
 
-            return it->second;
+            return production_group_reduction_rates.get(groupIdx);
         }
 
         void setCurrentInjectionGroupReductionRates(const std::string& groupName, const std::vector<double>& target ) {
-            injection_group_reduction_rates[groupName] = target;
+            injection_group_reduction_rates.set(insertGroup(groupName), target);
+        }
+
+        void setCurrentInjectionGroupReductionRates(const int groupIdx, const std::vector<double>& target ) {
+            injection_group_reduction_rates.set(groupIdx, target);
         }
 
         const std::vector<double>& currentInjectionGroupReductionRates(const std::string& groupName) const {
-            auto it = injection_group_reduction_rates.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == injection_group_reduction_rates.end())
+            if (!injection_group_reduction_rates.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any reduction rates for injection group " << groupName);
 
-            return it->second;
+            return injection_group_reduction_rates.get(groupIdx);
         }
 
         void setCurrentInjectionGroupReservoirRates(const std::string& groupName, const std::vector<double>& target ) {
-            injection_group_reservoir_rates[groupName] = target;
+            injection_group_reservoir_rates.set(insertGroup(groupName), target);
         }
 
         const std::vector<double>& currentInjectionGroupReservoirRates(const std::string& groupName) const {
-            auto it = injection_group_reservoir_rates.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == injection_group_reservoir_rates.end())
+            if (!injection_group_reservoir_rates.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any reservoir rates for injection group " << groupName);
 
-            return it->second;
+            return injection_group_reservoir_rates.get(groupIdx);
         }
 
         void setCurrentInjectionVREPRates(const std::string& groupName, const double& target ) {
-            injection_group_vrep_rates[groupName] = target;
+            injection_group_vrep_rates.set(insertGroup(groupName), target);
         }
 
         const double& currentInjectionVREPRates(const std::string& groupName) const {
-            auto it = injection_group_vrep_rates.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == injection_group_vrep_rates.end())
+            if (!injection_group_vrep_rates.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any VREP rates for group " << groupName);
 
-            return it->second;
+            return injection_group_vrep_rates.get(groupIdx);
         }
 
         void setCurrentInjectionREINRates(const std::string& groupName, const std::vector<double>& target ) {
-            injection_group_rein_rates[groupName] = target;
+            injection_group_rein_rates.set(insertGroup(groupName), target);
         }
 
         const std::vector<double>& currentInjectionREINRates(const std::string& groupName) const {
-            auto it = injection_group_rein_rates.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == injection_group_rein_rates.end())
+            if (!injection_group_rein_rates.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any REIN rates for group " << groupName);
 
-            return it->second;
+            return injection_group_rein_rates.get(groupIdx);
         }
 
         void setCurrentGroupGratTargetFromSales(const std::string& groupName, const double& target ) {
-            group_grat_target_from_sales[groupName] = target;
+            group_grat_target_from_sales.set(insertGroup(groupName), target);
         }
 
         bool hasGroupGratTargetFromSales(const std::string& groupName) const {
-            auto it = group_grat_target_from_sales.find(groupName);
-            return it != group_grat_target_from_sales.end();
+            return group_grat_target_from_sales.has(group_index_.find(groupName));
         }
 
         const double& currentGroupGratTargetFromSales(const std::string& groupName) const {
-            auto it = group_grat_target_from_sales.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == group_grat_target_from_sales.end())
+            if (!group_grat_target_from_sales.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any grat target from sales for group " << groupName);
 
-            return it->second;
+            return group_grat_target_from_sales.get(groupIdx);
         }
 
         void setCurrentGroupInjectionPotentials(const std::string& groupName, const std::vector<double>& pot ) {
-            injection_group_potentials[groupName] = pot;
+            injection_group_potentials.set(insertGroup(groupName), pot);
         }
 
         const std::vector<double>& currentGroupInjectionPotentials(const std::string& groupName) const {
-            auto it = injection_group_potentials.find(groupName);
+            const int groupIdx = group_index_.find(groupName);
 
-            if (it == injection_group_potentials.end())
+            if (!injection_group_potentials.has(groupIdx))
                 OPM_THROW(std::logic_error, "Could not find any potentials for group " << groupName);
 
-            return it->second;
+            return injection_group_potentials.get(groupIdx);
         }
 
 
@@ -1008,41 +1088,43 @@ namespace Opm
 
         template<class Comm>
         void communicateGroupRates(const Comm& comm) {
-            // sum over all nodes
-            for (auto& x : injection_group_rein_rates) {
-                comm.sum(x.second.data(), x.second.size());
-            }
-            for (auto& x : injection_group_vrep_rates) {
-                x.second = comm.sum(x.second);
-            }
-            for (auto& x : production_group_reduction_rates) {
-                comm.sum(x.second.data(), x.second.size());
-            }
-            for (auto& x : injection_group_reduction_rates) {
-                comm.sum(x.second.data(), x.second.size());
-            }
-            for (auto& x : injection_group_reservoir_rates) {
-                comm.sum(x.second.data(), x.second.size());
-            }
-            for (auto& x : production_group_rates) {
-                comm.sum(x.second.data(), x.second.size());
-            }
-            for (auto& x : well_rates) {
-                comm.sum(x.second.data(), x.second.size());
-            }
+            // sum over all nodes, the rates are packed into a single buffer so
+            // that only one collective call is needed
+            std::vector<double> buffer;
+            injection_group_rein_rates.pack(buffer);
+            injection_group_vrep_rates.pack(buffer);
+            production_group_reduction_rates.pack(buffer);
+            injection_group_reduction_rates.pack(buffer);
+            injection_group_reservoir_rates.pack(buffer);
+            production_group_rates.pack(buffer);
+            well_rates.pack(buffer);
+
+            comm.sum(buffer.data(), buffer.size());
+
+            std::size_t pos = 0;
+            injection_group_rein_rates.unpack(buffer, pos);
+            injection_group_vrep_rates.unpack(buffer, pos);
+            production_group_reduction_rates.unpack(buffer, pos);
+            injection_group_reduction_rates.unpack(buffer, pos);
+            injection_group_reservoir_rates.unpack(buffer, pos);
+            production_group_rates.unpack(buffer, pos);
+            well_rates.unpack(buffer, pos);
+            assert(pos == buffer.size());
         }
 
         template<class Comm>
         void updateGlobalIsGrup(const Schedule& schedule, const int reportStepIdx, const Comm& comm)
         {
+            // the state may have been set up for another report step, e.g. at restart
+            if (!group_tree_.validFor(reportStepIdx)) {
+                updateGroupIndices(schedule, reportStepIdx);
+            }
+
             std::fill(globalIsInjectionGrup_.begin(), globalIsInjectionGrup_.end(), 0);
             std::fill(globalIsProductionGrup_.begin(), globalIsProductionGrup_.end(), 0);
             int global_well_index = 0;
             const auto& end = wellMap().end();
             for (const auto& well : schedule.getWells(reportStepIdx)) {
-                // Build global name->index map.
-                wellNameToGlobalIdx_[well.name()] = global_well_index;
-
                 // For wells on this process...
                 const auto& it = wellMap().find( well.name());
                 if (it != end) {
@@ -1071,25 +1153,243 @@ namespace Opm
 
         bool isInjectionGrup(const std::string& name) const {
 
-            auto it = wellNameToGlobalIdx_.find(name);
+            const int global_well_index = well_index_.find(name);
 
-            if (it == wellNameToGlobalIdx_.end())
+            if (global_well_index < 0 || global_well_index >= static_cast<int>(globalIsInjectionGrup_.size()))
                 OPM_THROW(std::logic_error, "Could not find global injection group for well " << name);
 
-            return globalIsInjectionGrup_[it->second] != 0;
+            return globalIsInjectionGrup_[global_well_index] != 0;
         }
 
         bool isProductionGrup(const std::string& name) const {
 
-            auto it = wellNameToGlobalIdx_.find(name);
+            const int global_well_index = well_index_.find(name);
 
-            if (it == wellNameToGlobalIdx_.end())
+            if (global_well_index < 0 || global_well_index >= static_cast<int>(globalIsProductionGrup_.size()))
                 OPM_THROW(std::logic_error, "Could not find global production group for well " << name);
 
-            return globalIsProductionGrup_[it->second] != 0;
+            return globalIsProductionGrup_[global_well_index] != 0;
+        }
+
+        bool isProductionGrup(const int global_well_index) const {
+            return globalIsProductionGrup_[global_well_index] != 0;
         }
 
     private:
+        /// Values stored per group or per well index, together with a flag
+        /// telling whether the value has been set.
+        template <class T>
+        struct IndexedValues
+        {
+            std::vector<T> values;
+            std::vector<char> is_set;
+
+            bool has(const int idx) const {
+                return idx >= 0 && idx < static_cast<int>(is_set.size()) && is_set[idx];
+            }
+
+            const T& get(const int idx) const {
+                return values[idx];
+            }
+
+            void set(const int idx, const T& value) {
+                values[idx] = value;
+                is_set[idx] = 1;
+            }
+
+            void resize(const std::size_t n) {
+                values.resize(n);
+                is_set.resize(n, 0);
+            }
+
+            /// Move the values to a new numbering, old entry i gets index oldToNew[i].
+            void remap(const std::vector<int>& oldToNew, const std::size_t n) {
+                std::vector<T> new_values(n);
+                std::vector<char> new_is_set(n, 0);
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    new_values[oldToNew[i]] = std::move(values[i]);
+                    new_is_set[oldToNew[i]] = is_set[i];
+                }
+                values.swap(new_values);
+                is_set.swap(new_is_set);
+            }
+
+            /// Append the values that are set to buffer.
+            void pack(std::vector<double>& buffer) const {
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    if (is_set[i]) {
+                        packValue(values[i], buffer);
+                    }
+                }
+            }
+
+            void unpack(const std::vector<double>& buffer, std::size_t& pos) {
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    if (is_set[i]) {
+                        unpackValue(buffer, pos, values[i]);
+                    }
+                }
+            }
+        };
+
+        static void packValue(const double value, std::vector<double>& buffer) {
+            buffer.push_back(value);
+        }
+
+        static void packValue(const std::vector<double>& value, std::vector<double>& buffer) {
+            buffer.insert(buffer.end(), value.begin(), value.end());
+        }
+
+        static void unpackValue(const std::vector<double>& buffer, std::size_t& pos, double& value) {
+            value = buffer[pos++];
+        }
+
+        static void unpackValue(const std::vector<double>& buffer, std::size_t& pos, std::vector<double>& value) {
+            std::copy(buffer.begin() + pos, buffer.begin() + pos + value.size(), value.begin());
+            pos += value.size();
+        }
+
+        /// Dense numbering of a set of names.
+        class NameIndex
+        {
+        public:
+            int find(const std::string& name) const {
+                auto it = index_.find(name);
+                return it == index_.end() ? -1 : it->second;
+            }
+
+            int insert(const std::string& name) {
+                auto res = index_.emplace(name, static_cast<int>(names_.size()));
+                if (res.second) {
+                    names_.push_back(name);
+                }
+                return res.first->second;
+            }
+
+            const std::string& name(const int idx) const {
+                return names_[idx];
+            }
+
+            int size() const {
+                return names_.size();
+            }
+
+            /// Number the given names first, in order, followed by the previously
+            /// known names that are not among them.
+            /// \return the new index of each previously known name
+            std::vector<int> rebuild(const std::vector<std::string>& names) {
+                std::vector<std::string> old_names;
+                old_names.swap(names_);
+                index_.clear();
+                for (const auto& name : names) {
+                    insert(name);
+                }
+                std::vector<int> oldToNew(old_names.size());
+                for (std::size_t i = 0; i < old_names.size(); ++i) {
+                    oldToNew[i] = insert(old_names[i]);
+                }
+                return oldToNew;
+            }
+
+        private:
+            std::vector<std::string> names_;
+            std::unordered_map<std::string, int> index_;
+        };
+
+        static int injectionPhaseIndex(const Opm::Phase& phase) {
+            switch (phase) {
+            case Opm::Phase::WATER:
+                return 0;
+            case Opm::Phase::OIL:
+                return 1;
+            case Opm::Phase::GAS:
+                return 2;
+            default:
+                return -1;
+            }
+        }
+
+        template <class Function>
+        void forEachGroupValues(Function f) {
+            f(current_production_group_controls_);
+            for (auto& controls : current_injection_group_controls_) {
+                f(controls);
+            }
+            f(production_group_rates);
+            f(production_group_reduction_rates);
+            f(injection_group_reduction_rates);
+            f(injection_group_reservoir_rates);
+            f(injection_group_potentials);
+            f(injection_group_vrep_rates);
+            f(injection_group_rein_rates);
+            f(group_grat_target_from_sales);
+        }
+
+        int insertGroup(const std::string& groupName) {
+            int groupIdx = group_index_.find(groupName);
+            if (groupIdx < 0) {
+                groupIdx = group_index_.insert(groupName);
+                const std::size_t ng = group_index_.size();
+                forEachGroupValues([ng](auto& values) { values.resize(ng); });
+            }
+            return groupIdx;
+        }
+
+        /// Number the wells and groups of the report step and move the values
+        /// set for earlier report steps to the new numbering.
+        void updateGroupIndices(const Schedule& schedule, const int report_step)
+        {
+            std::vector<std::string> well_names;
+            for (const auto& well : schedule.getWells(report_step)) {
+                well_names.push_back(well.name());
+            }
+            const auto wellOldToNew = well_index_.rebuild(well_names);
+            well_rates.remap(wellOldToNew, well_index_.size());
+
+            const auto groupOldToNew = group_index_.rebuild(schedule.groupNames(report_step));
+            const std::size_t ng = group_index_.size();
+            forEachGroupValues([&groupOldToNew, ng](auto& values) { values.remap(groupOldToNew, ng); });
+
+            buildGroupTree(schedule, report_step);
+        }
+
+        void buildGroupTree(const Schedule& schedule, const int report_step)
+        {
+            const auto names = schedule.groupNames(report_step);
+            const int ng = names.size();
+
+            GroupTree& tree = group_tree_;
+            tree = GroupTree{};
+            tree.parent.assign(ng, -1);
+            tree.efficiency.resize(ng);
+            tree.child_offset.push_back(0);
+            tree.well_offset.push_back(0);
+
+            const auto& end = wellMap().end();
+            for (int g = 0; g < ng; ++g) {
+                const Group& group = schedule.getGroup(names[g], report_step);
+                tree.efficiency[g] = group.getGroupEfficiencyFactor();
+                for (const std::string& childName : group.groups()) {
+                    const int child = group_index_.find(childName);
+                    tree.children.push_back(child);
+                    tree.parent[child] = g;
+                }
+                tree.child_offset.push_back(tree.children.size());
+
+                for (const std::string& wellName : group.wells()) {
+                    const auto& wellEcl = schedule.getWell(wellName, report_step);
+                    const auto& it = wellMap().find(wellName);
+                    tree.well_local_index.push_back(it != end ? it->second[0] : -1);
+                    tree.well_global_index.push_back(well_index_.find(wellName));
+                    tree.well_efficiency.push_back(wellEcl.getEfficiencyFactor());
+                    tree.well_is_injector.push_back(wellEcl.isInjector());
+                    tree.well_is_shut.push_back(wellEcl.getStatus() == Well::Status::SHUT);
+                }
+                tree.well_offset.push_back(tree.well_local_index.size());
+            }
+            tree.report_step = report_step;
+        }
+
         std::vector<double> perfphaserates_;
 
         // vector with size number of wells +1.
@@ -1102,20 +1402,26 @@ namespace Opm
         // size of global number of wells
         std::vector<int> globalIsInjectionGrup_;
         std::vector<int> globalIsProductionGrup_;
-        std::map<std::string, int> wellNameToGlobalIdx_;
-
-        std::map<std::string, Group::ProductionCMode> current_production_group_controls_;
-        std::map<std::pair<Opm::Phase, std::string>, Group::InjectionCMode> current_injection_group_controls_;
-
-        std::map<std::string, std::vector<double>> well_rates;
-        std::map<std::string, std::vector<double>> production_group_rates;
-        std::map<std::string, std::vector<double>> production_group_reduction_rates;
-        std::map<std::string, std::vector<double>> injection_group_reduction_rates;
-        std::map<std::string, std::vector<double>> injection_group_reservoir_rates;
-        std::map<std::string, std::vector<double>> injection_group_potentials;
-        std::map<std::string, double> injection_group_vrep_rates;
-        std::map<std::string, std::vector<double>> injection_group_rein_rates;
-        std::map<std::string, double> group_grat_target_from_sales;
+
+        // the first wells and groups are numbered as in the schedule of the current
+        // report step, followed by those that only existed in earlier report steps
+        NameIndex well_index_;
+        NameIndex group_index_;
+        GroupTree group_tree_;
+
+        IndexedValues<Group::ProductionCMode> current_production_group_controls_;
+        // one per injection phase, see injectionPhaseIndex()
+        std::array<IndexedValues<Group::InjectionCMode>, 3> current_injection_group_controls_;
+
+        IndexedValues<std::vector<double>> well_rates;
+        IndexedValues<std::vector<double>> production_group_rates;
+        IndexedValues<std::vector<double>> production_group_reduction_rates;
+        IndexedValues<std::vector<double>> injection_group_reduction_rates;
+        IndexedValues<std::vector<double>> injection_group_reservoir_rates;
+        IndexedValues<std::vector<double>> injection_group_potentials;
+        IndexedValues<double> injection_group_vrep_rates;
+        IndexedValues<std::vector<double>> injection_group_rein_rates;
+        IndexedValues<double> group_grat_target_from_sales;
 
         std::vector<double> perfRateSolvent_;
 
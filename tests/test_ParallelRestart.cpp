@@ -24,6 +24,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <fstream>
 #include <tuple>
 #include <utility>
 
@@ -116,6 +118,11 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableSchema.hpp>
 #include <opm/output/eclipse/RestartValue.hpp>
 #include <opm/simulators/utils/ParallelRestart.hpp>
+#include <opm/parser/eclipse/Parser/ErrorGuard.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Python/Python.hpp>
+#include <opm/simulators/utils/ParallelSerialization.hpp>
 #include <ebos/eclmpiserializer.hh>
 
 
@@ -395,6 +402,18 @@ BOOST_AUTO_TEST_CASE(CellData)
 }
 
 
+BOOST_AUTO_TEST_CASE(BlockData)
+{
+    std::map<std::pair<std::string, int>, double> val1 {
+        {{"BPR", 1}, 1.0},
+        {{"BPR", 42}, 2.0},
+        {{"BOSAT", 42}, 0.5},
+    };
+    auto val2 = PackUnpack(val1);
+    DO_CHECKS(BlockData)
+}
+
+
 BOOST_AUTO_TEST_CASE(RestartKey)
 {
     Opm::RestartKey val1("key", Opm::UnitSystem::measure::length, true);
@@ -420,6 +439,119 @@ BOOST_AUTO_TEST_CASE(RestartValue)
     DO_CHECKS(RestartValue)
 }
 
+
+struct RunLengthArrays
+{
+    std::vector<int> regions;
+    std::vector<double> values;
+    std::vector<double> noise;
+
+    bool operator==(const RunLengthArrays& rhs) const
+    {
+        return regions == rhs.regions && values == rhs.values && noise == rhs.noise;
+    }
+
+    template<class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(regions);
+        serializer.template vector<double,false>(values);
+        serializer(noise);
+    }
+};
+
+
+BOOST_AUTO_TEST_CASE(CompressedArrays)
+{
+    RunLengthArrays val1;
+    val1.regions.assign(3000, 1);
+    std::fill(val1.regions.begin() + 1000, val1.regions.end(), 2);
+    val1.values.assign(2000, 0.25);
+    for (int i = 0; i < 1000; ++i)
+        val1.noise.push_back(0.5 * i);
+
+    auto comm = Dune::MPIHelper::getCollectiveCommunication();
+    Opm::EclMpiSerializer plain(comm);
+    plain.pack(val1);
+
+    Opm::EclMpiSerializer ser(comm, /*compress=*/true);
+    ser.pack(val1);
+    const size_t pos1 = ser.position();
+    BOOST_CHECK_LT(pos1, plain.position() / 2);
+
+    RunLengthArrays val2;
+    ser.unpack(val2);
+    BOOST_CHECK_EQUAL(pos1, ser.position());
+    BOOST_CHECK_MESSAGE(val1 == val2, "Deserialized run-length encoded arrays differ");
+}
+
+
+BOOST_AUTO_TEST_CASE(StartupSnapshot)
+{
+    const std::string deckFile = "STARTUP_SNAPSHOT.DATA";
+    const std::string deckString = R"(
+RUNSPEC
+DIMENS
+ 2 2 1 /
+OIL
+WATER
+START
+ 1 JAN 2000 /
+GRID
+DX
+ 4*100 /
+DY
+ 4*100 /
+DZ
+ 4*10 /
+TOPS
+ 4*2000 /
+PORO
+ 4*0.3 /
+PERMX
+ 4*100 /
+SUMMARY
+FOPR
+SCHEDULE
+TSTEP
+ 1 /
+)";
+    {
+        std::ofstream out(deckFile);
+        out << deckString;
+    }
+
+    auto python = std::make_shared<Opm::Python>();
+    Opm::ParseContext parseContext;
+    Opm::ErrorGuard errorGuard;
+    Opm::Deck deck = Opm::Parser{}.parseFile(deckFile, parseContext, errorGuard);
+    Opm::EclipseState eclState(deck);
+    Opm::Schedule schedule(deck, eclState, parseContext, errorGuard, python);
+    Opm::SummaryConfig summaryConfig(deck, schedule, eclState.getTableManager(), parseContext, errorGuard);
+
+    const auto snapshotFile = Opm::startupSnapshotFileName(".", deckFile, false);
+    BOOST_CHECK(snapshotFile != Opm::startupSnapshotFileName(".", deckFile, true));
+    Opm::writeStartupSnapshot(snapshotFile, deck, schedule, summaryConfig, {});
+
+    Opm::Deck deck2;
+    Opm::Schedule schedule2(python);
+    Opm::SummaryConfig summaryConfig2;
+    BOOST_REQUIRE(Opm::readStartupSnapshot(snapshotFile, deck2, schedule2, summaryConfig2));
+    BOOST_CHECK_MESSAGE(deck == deck2, "Deck from startup snapshot differs");
+    BOOST_CHECK_MESSAGE(schedule == schedule2, "Schedule from startup snapshot differs");
+    BOOST_CHECK_MESSAGE(summaryConfig == summaryConfig2, "SummaryConfig from startup snapshot differs");
+
+    // a changed input file invalidates the snapshot
+    {
+        std::ofstream out(deckFile, std::ios::app);
+        out << "TSTEP\n 1 /\n";
+    }
+    Opm::Deck deck3;
+    Opm::Schedule schedule3(python);
+    Opm::SummaryConfig summaryConfig3;
+    BOOST_CHECK(!Opm::readStartupSnapshot(snapshotFile, deck3, schedule3, summaryConfig3));
+}
+
 #define TEST_FOR_TYPE(TYPE) \
 BOOST_AUTO_TEST_CASE(TYPE) \
 { \
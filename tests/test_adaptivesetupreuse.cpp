@@ -0,0 +1,69 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE AdaptiveSetupReuseTest
+
+#include <opm/simulators/linalg/AdaptiveSetupReuse.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(RebuildWhenExtraIterationsCostMoreThanSetup)
+{
+    Opm::AdaptiveSetupReuse reuse;
+    BOOST_CHECK(reuse.rebuildNext());
+
+    // a rebuild takes 1.0 s, an update 0.2 s, an iteration 0.1 s
+    reuse.setupDone(/*rebuilt=*/true, 1.0);
+    reuse.solveDone(10, 1.0, true);
+    BOOST_CHECK(!reuse.rebuildNext());
+
+    reuse.setupDone(/*rebuilt=*/false, 0.2);
+    reuse.solveDone(14, 1.4, true);
+    BOOST_CHECK_CLOSE(reuse.extraApplyCost(), 0.4, 1.0e-10);
+    BOOST_CHECK(!reuse.rebuildNext());
+
+    // fewer iterations than after the rebuild do not reduce the cost
+    reuse.setupDone(/*rebuilt=*/false, 0.2);
+    reuse.solveDone(8, 0.8, true);
+    BOOST_CHECK_CLOSE(reuse.extraApplyCost(), 0.4, 1.0e-10);
+    BOOST_CHECK(!reuse.rebuildNext());
+
+    reuse.setupDone(/*rebuilt=*/false, 0.2);
+    reuse.solveDone(15, 1.5, true);
+    BOOST_CHECK_CLOSE(reuse.extraApplyCost(), 0.9, 1.0e-10);
+    BOOST_CHECK(reuse.rebuildNext());
+
+    // the rebuild resets the reference
+    reuse.setupDone(/*rebuilt=*/true, 1.0);
+    BOOST_CHECK_SMALL(reuse.extraApplyCost(), 1.0e-12);
+    reuse.solveDone(15, 1.5, true);
+    BOOST_CHECK(!reuse.rebuildNext());
+}
+
+BOOST_AUTO_TEST_CASE(RebuildAfterFailedSolve)
+{
+    Opm::AdaptiveSetupReuse reuse;
+    reuse.setupDone(/*rebuilt=*/true, 1.0);
+    reuse.solveDone(10, 1.0, true);
+    reuse.setupDone(/*rebuilt=*/false, 0.2);
+    reuse.solveDone(10, 1.0, false);
+    BOOST_CHECK(reuse.rebuildNext());
+}
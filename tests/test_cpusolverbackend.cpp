@@ -0,0 +1,184 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE CpuSolverBackendTest
+
+#include <cmath>
+#include <vector>
+
+#include <opm/simulators/linalg/bda/cpuSolverBackend.hpp>
+#include <opm/simulators/linalg/bda/WellContributions.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+
+// blocked 5-point stencil on an n x n grid, non-symmetric blocks, diagonally dominant
+struct BlockedLaplace
+{
+    static const int bs = 3;
+
+    BlockedLaplace(int n)
+        : Nb(n * n)
+    {
+        rows.push_back(0);
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                const int row = j * n + i;
+                const int neighbours[5] = {row - n, row - 1, row, row + 1, row + n};
+                const bool exists[5] = {j > 0, i > 0, true, i < n - 1, j < n - 1};
+                for (int k = 0; k < 5; ++k) {
+                    if (!exists[k]) {
+                        continue;
+                    }
+                    cols.push_back(neighbours[k]);
+                    for (int r = 0; r < bs; ++r) {
+                        for (int c = 0; c < bs; ++c) {
+                            if (neighbours[k] == row) {
+                                vals.push_back(r == c ? 8.0 + r : 0.3 * (r - c));
+                            } else {
+                                vals.push_back(r == c ? -1.0 - 0.1 * k : 0.05 * (r + 1) * (c + 2) * (k % 2 ? 1.0 : -1.0));
+                            }
+                        }
+                    }
+                }
+                rows.push_back(cols.size());
+            }
+        }
+    }
+
+    // res = b - A * x
+    std::vector<double> residual(const std::vector<double>& b, const std::vector<double>& x) const
+    {
+        std::vector<double> res(b);
+        for (int row = 0; row < Nb; ++row) {
+            for (int k = rows[row]; k < rows[row + 1]; ++k) {
+                for (int r = 0; r < bs; ++r) {
+                    for (int c = 0; c < bs; ++c) {
+                        res[row * bs + r] -= vals[k * bs * bs + r * bs + c] * x[cols[k] * bs + c];
+                    }
+                }
+            }
+        }
+        return res;
+    }
+
+    int Nb;
+    std::vector<int> rows;
+    std::vector<int> cols;
+    std::vector<double> vals;
+};
+
+double two_norm(const std::vector<double>& v)
+{
+    double sum = 0.0;
+    for (double val : v) {
+        sum += val * val;
+    }
+    return std::sqrt(sum);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(SolveBlockedSystem)
+{
+    BlockedLaplace A(20);
+    const int bs = BlockedLaplace::bs;
+    const int N = A.Nb * bs;
+
+    std::vector<double> b(N);
+    for (int i = 0; i < N; ++i) {
+        b[i] = 1.0 + std::sin(0.37 * i);
+    }
+
+    bda::cpuSolverBackend<bs> solver(0, 200, 1e-8);
+    Opm::WellContributions wellContribs("cpu");
+
+    // the second solve reuses the analysis of the first one
+    for (int solve = 0; solve < 2; ++solve) {
+        bda::BdaResult result;
+        const auto status = solver.solve_system(N, A.vals.size(), bs, A.vals.data(), A.rows.data(), A.cols.data(), b.data(), wellContribs, result);
+        BOOST_CHECK(status == bda::SolverStatus::BDA_SOLVER_SUCCESS);
+        BOOST_CHECK(result.converged);
+
+        std::vector<double> x(N);
+        solver.get_result(x.data());
+        BOOST_CHECK_LT(two_norm(A.residual(b, x)), 1e-7 * two_norm(b));
+
+        for (auto& val : A.vals) {
+            val *= 2.0;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ApplyStandardWellOnHost)
+{
+    const unsigned int dim = 3;
+    const unsigned int dim_wells = 4;
+    Opm::WellContributions wellContribs("cpu");
+    wellContribs.setBlockSize(dim, dim_wells);
+    wellContribs.addNumBlocks(2);
+    wellContribs.alloc();
+
+    std::vector<int> colIndices = {1, 3};
+    std::vector<double> C(2 * dim * dim_wells), B(2 * dim * dim_wells), D(dim_wells * dim_wells, 0.0);
+    for (unsigned int i = 0; i < C.size(); ++i) {
+        C[i] = 0.1 * i;
+        B[i] = 1.0 - 0.05 * i;
+    }
+    for (unsigned int i = 0; i < dim_wells; ++i) {
+        D[i * dim_wells + i] = 0.5 + i;
+    }
+    wellContribs.addMatrix(Opm::WellContributions::MatrixType::C, colIndices.data(), C.data(), 2);
+    wellContribs.addMatrix(Opm::WellContributions::MatrixType::D, colIndices.data(), D.data(), 1);
+    wellContribs.addMatrix(Opm::WellContributions::MatrixType::B, colIndices.data(), B.data(), 2);
+
+    std::vector<double> x(4 * dim), y(4 * dim, 1.0);
+    for (unsigned int i = 0; i < x.size(); ++i) {
+        x[i] = 0.2 * i - 1.0;
+    }
+    wellContribs.applyHost(x.data(), y.data());
+
+    // y -= C^T * D * B * x, computed densely
+    std::vector<double> z1(dim_wells, 0.0), z2(dim_wells, 0.0), expected(4 * dim, 1.0);
+    for (unsigned int blk = 0; blk < 2; ++blk) {
+        for (unsigned int r = 0; r < dim_wells; ++r) {
+            for (unsigned int c = 0; c < dim; ++c) {
+                z1[r] += B[blk * dim * dim_wells + r * dim + c] * x[colIndices[blk] * dim + c];
+            }
+        }
+    }
+    for (unsigned int r = 0; r < dim_wells; ++r) {
+        z2[r] = D[r * dim_wells + r] * z1[r];
+    }
+    for (unsigned int blk = 0; blk < 2; ++blk) {
+        for (unsigned int c = 0; c < dim; ++c) {
+            for (unsigned int r = 0; r < dim_wells; ++r) {
+                expected[colIndices[blk] * dim + c] -= C[blk * dim * dim_wells + r * dim + c] * z2[r];
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < y.size(); ++i) {
+        BOOST_CHECK_CLOSE(y[i], expected[i], 1e-10);
+    }
+}
@@ -30,6 +30,7 @@
 
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
 #include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+#include <opm/simulators/linalg/SystemSnapshot.hpp>
 
 #include <dune/common/fmatrix.hh>
 #include <dune/istl/bcrsmatrix.hh>
@@ -37,8 +38,13 @@
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string>
 
 
 template <int bz>
@@ -133,6 +139,165 @@ BOOST_AUTO_TEST_CASE(TestFlexibleSolver)
     }
 }
 
+BOOST_AUTO_TEST_CASE(PipelinedSolvers)
+{
+    namespace pt = boost::property_tree;
+    const int bz = 3;
+    pt::ptree prm;
+    prm.put("tol", 1e-10);
+    prm.put("maxiter", 200);
+    prm.put("verbosity", 0);
+    prm.put("preconditioner.type", "ILU0");
+    prm.put("solver", "bicgstab");
+    const auto reference = testSolver<bz>(prm, "matr33.txt", "rhs3.txt");
+    const double scale = reference.infinity_norm();
+
+    for (const std::string solver : {"pipelined_bicgstab", "lowsync_gmres"}) {
+        prm.put("solver", solver);
+        for (const int restart : {2, 15}) {
+            prm.put("restart", restart);
+            const auto sol = testSolver<bz>(prm, "matr33.txt", "rhs3.txt");
+            BOOST_REQUIRE_EQUAL(sol.size(), reference.size());
+            for (size_t i = 0; i < sol.size(); ++i) {
+                for (int row = 0; row < bz; ++row) {
+                    BOOST_CHECK_SMALL(sol[i][row] - reference[i][row], 1e-6 * scale);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PipelinedBiCGSTABTrueResidual)
+{
+    namespace pt = boost::property_tree;
+    const int bz = 3;
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+    Matrix matrix;
+    Vector rhs;
+    Opm::Helper::readSystem("matr33.txt", "rhs3.txt", matrix, rhs);
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(matrix);
+
+    for (const double tol : {1e-8, 1e-12}) {
+        pt::ptree prm;
+        prm.put("tol", tol);
+        prm.put("maxiter", 200);
+        prm.put("verbosity", 0);
+        prm.put("solver", "pipelined_bicgstab");
+        prm.put("preconditioner.type", "ILU0");
+        Dune::FlexibleSolver<Matrix, Vector> solver(op, prm);
+
+        Vector x(rhs.size());
+        x = 0.0;
+        Vector b = rhs;
+        Dune::InverseOperatorResult res;
+        solver.apply(x, b, res);
+        if (tol > 1e-10) {
+            BOOST_REQUIRE(res.converged);
+        }
+
+        // convergence must hold for the true residual, not only for the recurred one
+        if (res.converged) {
+            Vector r = rhs;
+            matrix.mmv(x, r);
+            BOOST_CHECK_LE(r.two_norm(), tol * rhs.two_norm());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(QuasiImpesWeights)
+{
+    const int bz = 3;
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+    Matrix matrix;
+    Vector rhs;
+    Opm::Helper::readSystem("matr33.txt", "rhs3.txt", matrix, rhs);
+
+    const int pressureIndex = 1;
+    Dune::FieldVector<double, bz> unit(0.0);
+    unit[pressureIndex] = 1.0;
+    for (const bool transpose : {false, true}) {
+        const auto weights = Opm::Amg::getQuasiImpesWeights<Matrix, Vector>(matrix, pressureIndex, transpose);
+        BOOST_REQUIRE_EQUAL(weights.size(), matrix.N());
+        for (std::size_t row = 0; row < matrix.N(); ++row) {
+            // reference: dense solve with the (transposed) diagonal block
+            auto diag = matrix[row][row];
+            if (!transpose)
+                diag = Opm::Details::transposeDenseMatrix(diag);
+            Dune::FieldVector<double, bz> expected;
+            diag.solve(expected, unit);
+            double absMax = 0.0;
+            for (const double w : expected)
+                absMax = std::max(absMax, std::fabs(w));
+            expected /= absMax;
+            // the weights are scaled to a maximum magnitude of one
+            for (int k = 0; k < bz; ++k)
+                BOOST_CHECK_SMALL(weights[row][k] - expected[k], 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BinarySnapshot)
+{
+    const int bz = 3;
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+    BOOST_CHECK_EQUAL(Opm::Helper::snapshotBlockSize("matr33.txt"), bz);
+
+    Matrix matrix;
+    Vector rhs;
+    Opm::Helper::readSystem("matr33.txt", "rhs3.txt", matrix, rhs);
+    Opm::Helper::writeBinarySystem("snapshot_matrix_istl.bcsr", matrix, rhs);
+    BOOST_CHECK_EQUAL(Opm::Helper::snapshotBlockSize("snapshot_matrix_istl.bcsr"), bz);
+
+    Matrix matrix2;
+    Vector rhs2;
+    Opm::Helper::readSystem("snapshot_matrix_istl.bcsr", "", matrix2, rhs2);
+    BOOST_REQUIRE_EQUAL(matrix2.N(), matrix.N());
+    BOOST_REQUIRE_EQUAL(matrix2.nonzeroes(), matrix.nonzeroes());
+    for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            BOOST_REQUIRE(matrix2.exists(row.index(), col.index()));
+            BOOST_CHECK(matrix2[row.index()][col.index()] == *col);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(rhs2.size(), rhs.size());
+    for (std::size_t i = 0; i < rhs.size(); ++i)
+        BOOST_CHECK(rhs2[i] == rhs[i]);
+
+    Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>> scalarMatrix;
+    Dune::BlockVector<Dune::FieldVector<double, 1>> scalarRhs;
+    BOOST_CHECK_THROW(Opm::Helper::readBinarySystem("snapshot_matrix_istl.bcsr", scalarMatrix, scalarRhs),
+                      std::runtime_error);
+
+    // corrupt snapshots must be rejected instead of creating an invalid matrix
+    std::string bytes;
+    {
+        std::ifstream in("snapshot_matrix_istl.bcsr", std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    const auto writeCorrupt = [](const std::string& contents) {
+        std::ofstream out("snapshot_corrupt_istl.bcsr", std::ios::binary);
+        out.write(contents.data(), contents.size());
+    };
+    writeCorrupt(bytes.substr(0, bytes.size() - sizeof(double)));
+    BOOST_CHECK_THROW(Opm::Helper::readBinarySystem("snapshot_corrupt_istl.bcsr", matrix2, rhs2),
+                      std::runtime_error);
+
+    const std::size_t firstColumn = sizeof(Opm::Helper::detail::binarySnapshotMagic) + sizeof(std::int32_t)
+        + 2 * sizeof(std::uint64_t) + (matrix.N() + 1) * sizeof(std::uint64_t);
+    std::string badColumn = bytes;
+    const std::uint32_t outOfRange = matrix.N();
+    badColumn.replace(firstColumn, sizeof(outOfRange), reinterpret_cast<const char*>(&outOfRange), sizeof(outOfRange));
+    writeCorrupt(badColumn);
+    BOOST_CHECK_THROW(Opm::Helper::readBinarySystem("snapshot_corrupt_istl.bcsr", matrix2, rhs2),
+                      std::runtime_error);
+}
+
 #else
 
 // Do nothing if we do not have at least Dune 2.6.
@@ -105,6 +105,37 @@ BOOST_AUTO_TEST_CASE(EvenHaveFailure)
     }
 }
 
+BOOST_AUTO_TEST_CASE(NoFailure)
+{
+    using CR = Opm::ConvergenceReport;
+    CR cr;
+    CR global_cr = gatherConvergenceReport(cr);
+    BOOST_CHECK(global_cr.converged());
+    BOOST_CHECK(global_cr.reservoirFailures().empty());
+    BOOST_CHECK(global_cr.wellFailures().empty());
+}
+
+BOOST_AUTO_TEST_CASE(MixedFailures)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    using CR = Opm::ConvergenceReport;
+    CR cr;
+    cr.setReservoirFailed({CR::ReservoirFailure::Type::Cnv, CR::Severity::Normal, cc.rank()});
+    if (cc.rank() == cc.size() - 1) {
+        cr.setWellFailed({CR::WellFailure::Type::MassBalance, CR::Severity::NotANumber, 1, "LAST"});
+        cr.setWellFailed({CR::WellFailure::Type::Pressure, CR::Severity::TooLarge, -1, ""});
+    }
+    CR global_cr = gatherConvergenceReport(cr);
+    BOOST_REQUIRE(global_cr.reservoirFailures().size() == std::size_t(cc.size()));
+    for (int rank = 0; rank < cc.size(); ++rank) {
+        BOOST_CHECK(global_cr.reservoirFailures()[rank].phase() == rank);
+    }
+    BOOST_REQUIRE(global_cr.wellFailures().size() == 2);
+    BOOST_CHECK(global_cr.wellFailures()[0].wellName() == "LAST");
+    BOOST_CHECK(global_cr.wellFailures()[1].wellName().empty());
+    BOOST_CHECK(global_cr.severityOfWorstFailure() == CR::Severity::NotANumber);
+}
+
 int main(int argc, char** argv)
 {
     Dune::MPIHelper::instance(argc, argv);
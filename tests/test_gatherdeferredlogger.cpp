@@ -166,6 +166,42 @@ BOOST_AUTO_TEST_CASE(AllHaveOneMessage)
     }
 }
 
+BOOST_AUTO_TEST_CASE(TaggedMessages)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+
+    std::ostringstream log_stream;
+    initLogger(log_stream);
+
+    // rank 0 has no messages, the others share the tags
+    Opm::DeferredLogger local_deferredlogger;
+    if (cc.rank() > 0) {
+        local_deferredlogger.warning("tagme", "warning 1 from rank " + std::to_string(cc.rank()));
+        local_deferredlogger.note("note from rank " + std::to_string(cc.rank()));
+        local_deferredlogger.warning("tagme", "warning 2 from rank " + std::to_string(cc.rank()));
+    }
+
+    Opm::DeferredLogger global_deferredlogger = gatherDeferredLogger(local_deferredlogger);
+    global_deferredlogger.logMessages();
+
+    auto counter = OpmLog::getBackend<CounterLog>("COUNTER");
+    if (cc.rank() == 0) {
+        BOOST_CHECK_EQUAL( 2*(cc.size() - 1) , counter->numMessages(Log::MessageType::Warning) );
+        BOOST_CHECK_EQUAL( cc.size() - 1 , counter->numMessages(Log::MessageType::Note) );
+
+        std::string expected;
+        if (cc.size() > 1) {
+            expected = Log::prefixMessage(Log::MessageType::Warning, "warning 1 from rank 1") + "\n"
+                + Log::prefixMessage(Log::MessageType::Note, "note from rank 1") + "\n"
+                + Log::prefixMessage(Log::MessageType::Warning, "warning 2 from rank 1") + "\n";
+        }
+        BOOST_CHECK_EQUAL(log_stream.str().substr(0, expected.size()), expected);
+    } else {
+        // the messages are only combined on rank 0
+        BOOST_CHECK_EQUAL( 0 , counter->numMessages(Log::MessageType::Warning) );
+    }
+}
+
 int main(int argc, char** argv)
 {
     Dune::MPIHelper::instance(argc, argv);
@@ -196,3 +196,153 @@ BOOST_AUTO_TEST_CASE(MILULaplace4)
 {
     test<4>();
 }
+
+template<int bsize>
+void testLevelScheduled()
+{
+    std::size_t N = 32;
+    Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize> > A;
+    setupLaplacian(A, N);
+
+    // for the natural ordering of a 2D grid the rows of each anti-diagonal
+    // form one level
+    const auto schedule = Opm::detail::lowerLevelSchedule(A, A.N());
+    BOOST_CHECK_EQUAL(schedule.numLevels(), 2*N - 1);
+    BOOST_CHECK_EQUAL(schedule.rows_.size(), A.N());
+
+    auto ILU1 = A;
+    auto ILU2 = A;
+    Opm::detail::ghost_last_bilu0_decomposition(ILU1, A.N());
+    Opm::detail::level_scheduled_bilu0_decomposition(ILU2, schedule);
+
+    for ( auto irow = ILU1.begin(), iend = ILU1.end(); irow != iend; ++irow)
+    {
+        for ( auto col = irow->begin(), cend = irow->end(); col != cend; ++col)
+        {
+            const auto& other = ILU2[irow.index()][col.index()];
+            for ( int i = 0; i < bsize; ++i )
+            {
+                for ( int j = 0; j < bsize; ++j )
+                {
+                    BOOST_CHECK_CLOSE((*col)[i][j], other[i][j], 1e-12);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LevelScheduledILULaplace1)
+{
+    testLevelScheduled<1>();
+}
+
+BOOST_AUTO_TEST_CASE(LevelScheduledILULaplace3)
+{
+    testLevelScheduled<3>();
+}
+
+template<int bsize>
+void testUpdateChangedPattern(bool redBlack)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize>>;
+    using ILU = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Dune::Amg::SequentialInformation>;
+    const int N = 8;
+
+    Matrix A;
+    setupLaplacian(A, N);
+    ILU prec(A, 0, 1.0, Opm::MILU_VARIANT::ILU, redBlack);
+
+    // same number of nonzeros, but the right neighbour of the first cell
+    // is replaced by the one after it.
+    Matrix B(A.N(), A.M(), A.nonzeroes(), Matrix::row_wise);
+    for (auto row = B.createbegin(); row != B.createend(); ++row) {
+        for (auto col = A[row.index()].begin(); col != A[row.index()].end(); ++col) {
+            row.insert(row.index() == 0 && col.index() == 1 ? 2 : col.index());
+        }
+    }
+    B = 0.0;
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            B[row.index()][row.index() == 0 && col.index() == 1 ? 2 : col.index()] = *col;
+        }
+    }
+    BOOST_REQUIRE_EQUAL(B.nonzeroes(), A.nonzeroes());
+
+    Vector d(A.N()), v1(A.N()), v2(A.N());
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        d[i] = 1.0 + i;
+    }
+
+    // the matrix object stays the same, only its pattern and values change
+    A = B;
+    prec.update();
+    ILU reference(B, 0, 1.0, Opm::MILU_VARIANT::ILU, redBlack);
+
+    v1 = 0;
+    v2 = 0;
+    prec.apply(v1, d);
+    reference.apply(v2, d);
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        for (int k = 0; k < bsize; ++k) {
+            BOOST_CHECK_CLOSE(v1[i][k], v2[i][k], 1e-12);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ILUUpdateChangedPattern)
+{
+    for (const bool redBlack : {false, true}) {
+        testUpdateChangedPattern<1>(redBlack);
+        testUpdateChangedPattern<3>(redBlack);
+    }
+}
+
+template<int bsize>
+void testUpdateChangedValues(bool redBlack)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize>>;
+    using ILU = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Dune::Amg::SequentialInformation>;
+    const int N = 8;
+
+    Matrix A;
+    setupLaplacian(A, N);
+    ILU prec(A, 0, 1.0, Opm::MILU_VARIANT::ILU, redBlack);
+
+    // same pattern, different values, which are copied into the stored
+    // (reordered) matrix of the decomposition
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            *col *= col.index() == row.index() ? 2.0 : 0.5 + 0.01 * row.index();
+        }
+    }
+
+    Vector d(A.N()), v1(A.N()), v2(A.N());
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        d[i] = 1.0 + i;
+    }
+
+    for (int update = 0; update < 2; ++update) {
+        prec.update();
+        ILU reference(A, 0, 1.0, Opm::MILU_VARIANT::ILU, redBlack);
+
+        v1 = 0;
+        v2 = 0;
+        prec.apply(v1, d);
+        reference.apply(v2, d);
+        for (std::size_t i = 0; i < d.size(); ++i) {
+            for (int k = 0; k < bsize; ++k) {
+                BOOST_CHECK_CLOSE(v1[i][k], v2[i][k], 1e-12);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ILUUpdateChangedValues)
+{
+    for (const bool redBlack : {false, true}) {
+        testUpdateChangedValues<1>(redBlack);
+        testUpdateChangedValues<3>(redBlack);
+    }
+}
@@ -0,0 +1,113 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE MSWellHelpersTest
+
+#include <opm/simulators/wells/MSWellHelpers.hpp>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using Block = Dune::FieldMatrix<double, 4, 4>;
+    using Matrix = Dune::BCRSMatrix<Block>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, 4>>;
+
+    // build a segment matrix with the given outlet of each segment. the diagonal
+    // blocks are made dominant so that the block elimination is well defined.
+    Matrix segmentMatrix(const std::vector<std::pair<int, int>>& couplings, const int n)
+    {
+        std::vector<std::vector<int>> columns(n);
+        for (int seg = 0; seg < n; ++seg)
+            columns[seg].push_back(seg);
+        for (const auto& c : couplings) {
+            columns[c.first].push_back(c.second);
+            columns[c.second].push_back(c.first);
+        }
+
+        Matrix D(n, n, Matrix::row_wise);
+        for (auto row = D.createbegin(); row != D.createend(); ++row)
+            for (const int col : columns[row.index()])
+                row.insert(col);
+
+        for (int seg = 0; seg < n; ++seg) {
+            for (auto col = D[seg].begin(); col != D[seg].end(); ++col) {
+                for (int i = 0; i < 4; ++i) {
+                    for (int j = 0; j < 4; ++j) {
+                        (*col)[i][j] = 0.1*((seg + 2*i + 3*j + col.index()) % 5) - 0.2;
+                    }
+                    if (col.index() == static_cast<std::size_t>(seg))
+                        (*col)[i][i] += 10.0 + seg;
+                }
+            }
+        }
+
+        return D;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(SegmentTreeSolve)
+{
+    // a main branch 0-1-2-3 and a lateral 1-4-5 which is numbered after it
+    const int n = 6;
+    const Matrix D = segmentMatrix({{1, 0}, {2, 1}, {3, 2}, {4, 1}, {5, 4}}, n);
+
+    Opm::mswellhelpers::SegmentTreeSolver<Matrix, Vector> solver;
+    BOOST_CHECK(!solver.isFactorized());
+    BOOST_REQUIRE(solver.factorize(D));
+    BOOST_CHECK(solver.isFactorized());
+
+    Vector rhs(n);
+    for (int seg = 0; seg < n; ++seg)
+        for (int i = 0; i < 4; ++i)
+            rhs[seg][i] = 1.0 + seg - 0.5*i;
+
+    Vector x(n);
+    solver.solve(rhs, x);
+
+    Vector Dx(n);
+    D.mv(x, Dx);
+    for (int seg = 0; seg < n; ++seg)
+        for (int i = 0; i < 4; ++i)
+            BOOST_CHECK_CLOSE(Dx[seg][i], rhs[seg][i], 1.e-10);
+
+    solver.reset();
+    BOOST_CHECK(!solver.isFactorized());
+}
+
+BOOST_AUTO_TEST_CASE(SegmentTreeRejectsLoops)
+{
+    // the couplings contain the loop 0-1-2-0
+    const Matrix D = segmentMatrix({{1, 0}, {2, 1}, {2, 0}}, 3);
+
+    Opm::mswellhelpers::SegmentTreeSolver<Matrix, Vector> solver;
+    BOOST_CHECK(!solver.factorize(D));
+    BOOST_CHECK(!solver.isFactorized());
+}
@@ -0,0 +1,119 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PartitionedRestartTest
+
+#include <opm/simulators/utils/PartitionedRestart.hpp>
+
+#include <opm/io/eclipse/EclFile.hpp>
+#include <opm/io/eclipse/EclOutput.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// two partitions of a grid with five cells which overlap in cell 2
+void writePartitions(const std::string& baseName, int reportStep)
+{
+    const auto units = Opm::UnitSystem::newMETRIC();
+    const std::vector<std::vector<int>> globalIndex = {{0, 1, 2}, {4, 3, 2}};
+
+    for (int rank = 0; rank < 2; ++rank) {
+        Opm::data::Solution sol;
+        std::vector<double> pressure, swat, summary;
+        for (const int idx : globalIndex[rank]) {
+            pressure.push_back((100.0 + idx + 10.0 * rank) * 1.0e5);
+            swat.push_back(0.1 * idx);
+            summary.push_back(-1.0);
+        }
+        sol.insert("PRESSURE", Opm::UnitSystem::measure::pressure, pressure, Opm::data::TargetType::RESTART_SOLUTION);
+        sol.insert("SWAT", Opm::UnitSystem::measure::identity, swat, Opm::data::TargetType::RESTART_SOLUTION);
+        sol.insert("KRW", Opm::UnitSystem::measure::identity, swat, Opm::data::TargetType::RESTART_AUXILIARY);
+        sol.insert("FIPOIL", Opm::UnitSystem::measure::volume, summary, Opm::data::TargetType::SUMMARY);
+
+        Opm::writeRestartPartition(Opm::restartPartitionFileName(".", baseName, rank, reportStep),
+                                   rank, 2, reportStep, 5, globalIndex[rank], sol, units,
+                                   /*doublePrecision=*/true);
+    }
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(FileName)
+{
+    BOOST_CHECK_EQUAL(Opm::restartPartitionFileName("out", "CASE", 3, 12), "out/CASE_P0003.X0012");
+}
+
+BOOST_AUTO_TEST_CASE(ReadPartitions)
+{
+    writePartitions("PARTRST_READ", 4);
+
+    const auto data = Opm::readRestartPartitions(".", "PARTRST_READ", 4);
+    BOOST_CHECK_EQUAL(data.numGlobalCells, 5);
+    BOOST_CHECK(data.doublePrecision);
+    BOOST_CHECK(data.solution.has("PRESSURE"));
+    BOOST_CHECK(data.solution.has("KRW"));
+    BOOST_CHECK(!data.solution.has("FIPOIL"));
+
+    // the values are in output units, the overlapping cell is taken from rank 1
+    const std::vector<double> expected = {100.0, 101.0, 112.0, 113.0, 114.0};
+    const auto& pressure = data.solution.data("PRESSURE");
+    BOOST_REQUIRE_EQUAL(pressure.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        BOOST_CHECK_CLOSE(pressure[i], expected[i], 1.0e-10);
+
+    BOOST_CHECK_THROW(Opm::readRestartPartitions(".", "PARTRST_READ", 5), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(MergeNonUnified)
+{
+    writePartitions("PARTRST", 7);
+    {
+        Opm::EclIO::EclOutput output("PARTRST.X0007", /*formatted=*/false);
+        output.write("INTEHEAD", std::vector<int>{1, 2, 3});
+        output.message("STARTSOL");
+        output.message("ENDSOL");
+        output.write("ZWEL", std::vector<std::string>{"PROD"});
+    }
+
+    Opm::mergeRestartPartitions("PARTRST.X0007", "PARTRST_MERGED.X0007");
+
+    Opm::EclIO::EclFile merged("PARTRST_MERGED.X0007");
+    const auto arrays = merged.getList();
+    std::vector<std::string> names;
+    for (const auto& array : arrays)
+        names.push_back(std::get<0>(array));
+
+    const std::vector<std::string> expected = {"INTEHEAD", "STARTSOL", "PRESSURE", "SWAT", "ENDSOL", "KRW", "ZWEL"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), expected.begin(), expected.end());
+
+    const auto& swat = merged.get<double>("SWAT");
+    BOOST_REQUIRE_EQUAL(swat.size(), 5u);
+    for (std::size_t i = 0; i < swat.size(); ++i)
+        BOOST_CHECK_SMALL(swat[i] - 0.1 * i, 1.0e-12);
+
+    BOOST_CHECK_THROW(Opm::mergeRestartPartitions("PARTRST.X0007", "PARTRST.X0007"), std::runtime_error);
+}
@@ -0,0 +1,82 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PerformanceReportTest
+
+#include <opm/simulators/utils/PerformanceReport.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(PhaseTimer)
+{
+    Opm::PhaseTimings timings;
+    {
+        Opm::PhaseTimer timer(timings, "linear/solve");
+    }
+    {
+        Opm::PhaseTimer timer(timings, "linear/solve");
+        timer.stop();
+        timer.stop();
+    }
+
+    BOOST_REQUIRE_EQUAL(timings.size(), 1u);
+    BOOST_CHECK_EQUAL(timings["linear/solve"].calls, 2u);
+    BOOST_CHECK(timings["linear/solve"].wall_time >= 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(MergeReports)
+{
+    Opm::SimulatorReportSingle first;
+    first.phase_timings["assembly/wells"] = {1.0, 0.5, 2};
+    Opm::SimulatorReportSingle second;
+    second.phase_timings["assembly/wells"] = {2.0, 1.5, 3};
+    second.phase_timings["convergence"] = {0.25, 0.25, 1};
+
+    first += second;
+    BOOST_REQUIRE_EQUAL(first.phase_timings.size(), 2u);
+    BOOST_CHECK_EQUAL(first.phase_timings["assembly/wells"].wall_time, 3.0);
+    BOOST_CHECK_EQUAL(first.phase_timings["assembly/wells"].cpu_time, 2.0);
+    BOOST_CHECK_EQUAL(first.phase_timings["assembly/wells"].calls, 5u);
+    BOOST_CHECK_EQUAL(first.phase_timings["convergence"].calls, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(PrintJson)
+{
+    Opm::SimulatorReport report;
+    report.success.total_newton_iterations = 7;
+
+    Opm::PhaseStatisticsMap success;
+    success["linear/setup/cpr"] = {{1.0, 1.0, 2}, {3.0, 2.0, 4}, {4.0, 3.0, 6}};
+
+    std::ostringstream os;
+    Opm::printPerformanceReport(os, report, success, {}, 2, 1);
+    const std::string json = os.str();
+
+    BOOST_CHECK(json.find("\"processes\": 2") != std::string::npos);
+    BOOST_CHECK(json.find("\"newton_iterations\": 7") != std::string::npos);
+    BOOST_CHECK(json.find("\"linear/setup/cpr\"") != std::string::npos);
+    BOOST_CHECK(json.find("\"calls\": {\"min\": 2, \"max\": 4, \"avg\": 3}") != std::string::npos);
+    BOOST_CHECK(json.find("\"wall_time\": {\"min\": 1, \"max\": 3, \"avg\": 2}") != std::string::npos);
+    BOOST_CHECK(json.find("\"failed_phases\": {}") != std::string::npos);
+}
@@ -232,6 +232,43 @@ BOOST_AUTO_TEST_CASE(TestAddingPreconditioner)
     test3(prm);
 }
 
+
+BOOST_AUTO_TEST_CASE(TestFloatPreconditioner)
+{
+    const int bz = 3;
+    for (const std::string type : {"ILU0", "ParOverILU0", "amg"}) {
+        pt::ptree prm;
+        prm.put("tol", 1e-10);
+        prm.put("maxiter", 200);
+        prm.put("verbosity", 0);
+        prm.put("preconditioner.type", type);
+        prm.put("preconditioner.smoother", "ILU0");
+        const auto reference = testPrec<bz>(prm, "matr33.txt", "rhs3.txt");
+
+        // the outer Krylov solver is still double, so the solution must not change.
+        prm.put("preconditioner.precision", "float");
+        const auto sol = testPrec<bz>(prm, "matr33.txt", "rhs3.txt");
+        BOOST_REQUIRE_EQUAL(sol.size(), reference.size());
+        const double scale = reference.infinity_norm();
+        for (size_t i = 0; i < sol.size(); ++i) {
+            for (int row = 0; row < bz; ++row) {
+                BOOST_CHECK_SMALL(sol[i][row] - reference[i][row], 1e-6 * scale);
+            }
+        }
+    }
+
+    pt::ptree prm;
+    prm.put("tol", 1e-10);
+    prm.put("maxiter", 200);
+    prm.put("verbosity", 0);
+    prm.put("preconditioner.type", "GS");
+    prm.put("preconditioner.precision", "float");
+    BOOST_CHECK_THROW(testPrec<bz>(prm, "matr33.txt", "rhs3.txt"), std::invalid_argument);
+    prm.put("preconditioner.type", "ILU0");
+    prm.put("preconditioner.precision", "half");
+    BOOST_CHECK_THROW(testPrec<bz>(prm, "matr33.txt", "rhs3.txt"), std::invalid_argument);
+}
+
 #else
 
 // Do nothing if we do not have at least Dune 2.6.
@@ -366,4 +366,78 @@ BOOST_AUTO_TEST_CASE(STOP_well)
         BOOST_CHECK(p > 0);
 }
 
+// ---------------------------------------------------------------------
+
+namespace {
+    struct DoublingComm
+    {
+        template <class T>
+        void sum(T* values, const std::size_t n) const
+        {
+            for (std::size_t i = 0; i < n; ++i) {
+                values[i] *= 2;
+            }
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(GroupTree)
+{
+    const Setup setup{ "msw.data" };
+    const auto tstep = std::size_t{0};
+
+    auto wstate = buildWellState(setup, tstep);
+
+    const auto& tree = wstate.groupTree();
+    BOOST_CHECK(tree.validFor(tstep));
+    BOOST_CHECK_EQUAL(tree.numGroups(), static_cast<int>(setup.sched.groupNames(tstep).size()));
+
+    const auto field = wstate.groupIndex("FIELD");
+    const auto prod = wstate.groupIndex("P");
+    const auto inje = wstate.groupIndex("I");
+    BOOST_REQUIRE(field >= 0 && prod >= 0 && inje >= 0);
+    BOOST_CHECK_EQUAL(tree.parent[field], -1);
+    BOOST_CHECK_EQUAL(tree.parent[prod], field);
+    BOOST_CHECK_EQUAL(tree.parent[inje], field);
+    BOOST_CHECK_EQUAL(tree.well_offset[field + 1] - tree.well_offset[field], 0);
+
+    // the single well of group P
+    BOOST_REQUIRE_EQUAL(tree.well_offset[prod + 1] - tree.well_offset[prod], 1);
+    const auto w = tree.well_offset[prod];
+    BOOST_CHECK_EQUAL(tree.well_local_index[w], wstate.wellMap().at("PROD01")[0]);
+    BOOST_CHECK_EQUAL(tree.well_global_index[w], wstate.globalWellIndex("PROD01"));
+    BOOST_CHECK(!tree.well_is_injector[w]);
+
+    // string and index access refer to the same values
+    wstate.setCurrentProductionGroupControl("P", Opm::Group::ProductionCMode::ORAT);
+    BOOST_CHECK(wstate.currentProductionGroupControl(prod) == Opm::Group::ProductionCMode::ORAT);
+    BOOST_CHECK(!wstate.hasProductionGroupControl("I"));
+    BOOST_CHECK_THROW(wstate.currentProductionGroupControl(inje), std::logic_error);
+
+    wstate.setCurrentProductionGroupReductionRates(prod, {1.0, 2.0, 3.0});
+    BOOST_CHECK_EQUAL(wstate.currentProductionGroupReductionRates("P")[1], 2.0);
+
+    // groups that are unknown to the schedule are appended
+    wstate.setCurrentInjectionVREPRates("NEWGRP", 5.0);
+    BOOST_CHECK_EQUAL(wstate.groupIndex("NEWGRP"), tree.numGroups());
+
+    // all set group and well rates are reduced together
+    wstate.setCurrentWellRates("PROD01", {1.0, 1.5});
+    wstate.communicateGroupRates(DoublingComm{});
+    BOOST_CHECK_EQUAL(wstate.currentProductionGroupReductionRates("P")[2], 6.0);
+    BOOST_CHECK_EQUAL(wstate.currentInjectionVREPRates("NEWGRP"), 10.0);
+    BOOST_CHECK_EQUAL(wstate.currentWellRates("PROD01")[1], 3.0);
+
+    // values are kept by name when the state is set up again
+    const auto prev = wstate;
+    const auto cpress =
+        std::vector<double>(setup.grid.c_grid()->number_of_cells,
+                            100.0*Opm::unit::barsa);
+    wstate.init(cpress, setup.sched, setup.sched.getWells(tstep), tstep, &prev,
+                setup.pu, setup.well_perf_data, setup.st, setup.sched.getWells(tstep).size());
+    BOOST_CHECK(wstate.currentProductionGroupControl("P") == Opm::Group::ProductionCMode::ORAT);
+    BOOST_CHECK_EQUAL(wstate.currentInjectionVREPRates("NEWGRP"), 10.0);
+    BOOST_CHECK_EQUAL(wstate.currentWellRates("PROD01")[0], 2.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()